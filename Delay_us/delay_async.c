@@ -0,0 +1,239 @@
+/**
+ * @file delay_async.c
+ * @brief 基于硬件定时器比较通道的非阻塞延时/超时服务
+ * @note  所有定时请求保存在按截止时间排序的最小堆中，比较寄存器始终指向堆顶，
+ *        因此无论挂了多少个定时器，每次到期只产生一次中断。
+ */
+
+#include "delay_async.h"
+
+#if DELAY_ASYNC_TIM_BITS >= 32
+#define TIM_MASK  0xFFFFFFFFu
+#else
+#define TIM_MASK  ((1u << DELAY_ASYNC_TIM_BITS) - 1u)
+#endif
+#define TIM_HALF  ((TIM_MASK >> 1) + 1u)
+
+typedef struct {
+    uint32_t deadline;      // 截止时刻 (扩展后的 32 位 us)
+    delay_async_cb_t cb;
+    void *arg;
+} delay_async_entry_t;
+
+static delay_async_entry_t heap[DELAY_ASYNC_MAX_TIMERS];
+static uint8_t heap_size = 0;
+
+/* 16 位定时器的软件扩展 */
+static uint32_t now_ext = 0;
+static uint32_t last_cnt = 0;
+
+/* 利用无符号回绕比较先后：a 早于 b */
+static inline int time_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+/**
+ * @brief  读取扩展到 32 位的当前时间 (调用者需持有临界区)
+ * @note   非空队列时比较点最多间隔半个计数周期，保证不会漏掉回绕
+ */
+static uint32_t now_locked(void)
+{
+    uint32_t cnt = __HAL_TIM_GET_COUNTER(DELAY_ASYNC_TIM_HANDLE);
+#if DELAY_ASYNC_TIM_BITS >= 32
+    return cnt;
+#else
+    now_ext += (cnt - last_cnt) & TIM_MASK;
+    last_cnt = cnt;
+    return now_ext;
+#endif
+}
+
+static void heap_swap(uint8_t a, uint8_t b)
+{
+    delay_async_entry_t t = heap[a];
+    heap[a] = heap[b];
+    heap[b] = t;
+}
+
+static void heap_push(const delay_async_entry_t *e)
+{
+    uint8_t i = heap_size++;
+    heap[i] = *e;
+
+    while (i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if (!time_before(heap[i].deadline, heap[parent].deadline)) break;
+        heap_swap(i, parent);
+        i = parent;
+    }
+}
+
+static void heap_pop(void)
+{
+    uint8_t i = 0;
+    heap[0] = heap[--heap_size];
+
+    for (;;) {
+        uint8_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < heap_size && time_before(heap[l].deadline, heap[m].deadline)) m = l;
+        if (r < heap_size && time_before(heap[r].deadline, heap[m].deadline)) m = r;
+        if (m == i) break;
+        heap_swap(i, m);
+        i = m;
+    }
+}
+
+/**
+ * @brief  把比较寄存器指向堆顶 (调用者需持有临界区)
+ * @note   截止时间超过半个计数周期时先比较到中间点，中断里会重新评估。
+ *         写完 CCR 后如果计数器已经越过目标，软件触发一次比较事件，避免错过整整一圈。
+ */
+static void arm_compare_locked(uint32_t now)
+{
+    if (heap_size == 0) {
+        __HAL_TIM_DISABLE_IT(DELAY_ASYNC_TIM_HANDLE, DELAY_ASYNC_TIM_IT);
+        return;
+    }
+
+    uint32_t delta = heap[0].deadline - now;
+    if ((int32_t)delta <= 0) {
+        delta = 0;
+    } else if (delta >= TIM_HALF) {
+        delta = TIM_HALF - 1;
+    }
+
+    uint32_t target = (now + delta) & TIM_MASK;
+    __HAL_TIM_SET_COMPARE(DELAY_ASYNC_TIM_HANDLE, DELAY_ASYNC_TIM_CHANNEL, target);
+    __HAL_TIM_CLEAR_FLAG(DELAY_ASYNC_TIM_HANDLE, DELAY_ASYNC_TIM_FLAG);
+    __HAL_TIM_ENABLE_IT(DELAY_ASYNC_TIM_HANDLE, DELAY_ASYNC_TIM_IT);
+
+    /* 目标已过 (或就是当前计数)，比较器不会再命中，手动补一个事件 */
+    uint32_t cnt = __HAL_TIM_GET_COUNTER(DELAY_ASYNC_TIM_HANDLE);
+    if (((target - cnt) & TIM_MASK) == 0 || ((target - cnt) & TIM_MASK) >= TIM_HALF) {
+        HAL_TIM_GenerateEvent(DELAY_ASYNC_TIM_HANDLE, DELAY_ASYNC_TIM_EVENT);
+    }
+}
+
+void delay_async_init(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    heap_size = 0;
+    last_cnt = __HAL_TIM_GET_COUNTER(DELAY_ASYNC_TIM_HANDLE);
+    now_ext = last_cnt;
+
+    __set_PRIMASK(primask);
+
+    /* 启动计数和比较通道，中断在有请求时才打开 */
+    HAL_TIM_OC_Start_IT(DELAY_ASYNC_TIM_HANDLE, DELAY_ASYNC_TIM_CHANNEL);
+    __HAL_TIM_DISABLE_IT(DELAY_ASYNC_TIM_HANDLE, DELAY_ASYNC_TIM_IT);
+}
+
+uint32_t delay_async_now_us(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t now = now_locked();
+    __set_PRIMASK(primask);
+    return now;
+}
+
+int delay_async_us(uint32_t us, delay_async_cb_t cb, void *arg)
+{
+    int ret = -1;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (heap_size < DELAY_ASYNC_MAX_TIMERS) {
+        uint32_t now = now_locked();
+        delay_async_entry_t e;
+
+        /* 32 位时间戳用有符号差比较，单次延时不能超过 2^31 us */
+        if (us > 0x7FFFFFFFu) us = 0x7FFFFFFFu;
+        e.deadline = now + us;
+        e.cb = cb;
+        e.arg = arg;
+        heap_push(&e);
+
+        arm_compare_locked(now);
+        ret = 0;
+    }
+
+    __set_PRIMASK(primask);
+    return ret;
+}
+
+void delay_async_irq_handler(void)
+{
+    for (;;) {
+        delay_async_entry_t due;
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+
+        uint32_t now = now_locked();
+        if (heap_size == 0 || time_before(now, heap[0].deadline)) {
+            arm_compare_locked(now);
+            __set_PRIMASK(primask);
+            return;
+        }
+
+        due = heap[0];
+        heap_pop();
+        __set_PRIMASK(primask);
+
+        /* 回调在临界区外执行，回调内可以继续注册新的定时 */
+        if (due.cb) {
+            due.cb(due.arg);
+        }
+    }
+}
+
+#if defined(USE_FREERTOS)
+
+#if configTASK_NOTIFICATION_ARRAY_ENTRIES <= DELAY_ASYNC_NOTIFY_INDEX
+#error "delay_block_us 需要独立的任务通知下标：请把 configTASK_NOTIFICATION_ARRAY_ENTRIES 设为大于 DELAY_ASYNC_NOTIFY_INDEX"
+#endif
+
+typedef struct {
+    TaskHandle_t task;
+    volatile uint8_t done;
+} delay_block_t;
+
+static void delay_block_wakeup(void *arg)
+{
+    delay_block_t *b = (delay_block_t *)arg;
+    TaskHandle_t task = b->task;
+    BaseType_t woken = pdFALSE;
+
+    b->done = 1;    // 之后等待方随时可能返回，b 在它的栈上，不能再访问
+    vTaskNotifyGiveIndexedFromISR(task, DELAY_ASYNC_NOTIFY_INDEX, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void delay_block_us(uint32_t us)
+{
+    delay_block_t b;
+
+    /* 调度器没跑或者延时太短：挂起的代价比忙等还大 */
+    if (us < DELAY_ASYNC_SPIN_US || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+        delay_us(us);
+        return;
+    }
+
+    b.task = xTaskGetCurrentTaskHandle();
+    b.done = 0;
+    if (delay_async_us(us, delay_block_wakeup, &b) != 0) {
+        /* 队列满了，退化为原来的智能延时 */
+        delay_smart_us(us);
+        return;
+    }
+
+    /* 以到期标志为准：同一下标上残留的通知 (例如上一次等待被提前唤醒后才到的那个) 只会多转一圈 */
+    while (!b.done) {
+        ulTaskNotifyTakeIndexed(DELAY_ASYNC_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+    }
+}
+
+#endif /* USE_FREERTOS */
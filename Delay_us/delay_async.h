@@ -0,0 +1,84 @@
+#ifndef __DELAY_ASYNC_H__
+#define __DELAY_ASYNC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "delay_us.h"  /* 复用 main.h 与 USE_FREERTOS 配置 */
+
+/* ================= 用户配置区 ================= */
+/* * 需要一个自由运行的硬件定时器：
+ * - 预分频使计数频率为 1MHz (1 tick = 1us)，例如 72MHz 主频 Prescaler = 71
+ * - Counter Period 设为最大值 (32 位定时器 0xFFFFFFFF，16 位定时器 0xFFFF)
+ * - 一个通道配置为 Output Compare No Output (Frozen)，并开启该定时器的全局中断
+ */
+extern TIM_HandleTypeDef htim2;
+#define DELAY_ASYNC_TIM_HANDLE   (&htim2)
+#define DELAY_ASYNC_TIM_CHANNEL  TIM_CHANNEL_1
+#define DELAY_ASYNC_TIM_IT       TIM_IT_CC1
+#define DELAY_ASYNC_TIM_FLAG     TIM_FLAG_CC1
+#define DELAY_ASYNC_TIM_EVENT    TIM_EVENTSOURCE_CC1
+
+/* 计数器位宽：TIM2/TIM5 为 32，其余大多为 16 */
+#ifndef DELAY_ASYNC_TIM_BITS
+#define DELAY_ASYNC_TIM_BITS     32
+#endif
+
+/* 同时挂起的定时请求上限 (静态最小堆) */
+#define DELAY_ASYNC_MAX_TIMERS   16
+
+/* 短于此值的阻塞延时直接 DWT 忙等，挂起/唤醒任务本身就要几微秒 */
+#define DELAY_ASYNC_SPIN_US      20
+
+/* 阻塞延时 (以及 dht_read) 等待用的任务通知下标：避开默认的 0 号，
+ * 应用或其它驱动发给同一任务的通知不会把它提前唤醒。
+ * 需要 FreeRTOS V10.4 及以上，且 FreeRTOSConfig.h 中 configTASK_NOTIFICATION_ARRAY_ENTRIES 大于该值 */
+#define DELAY_ASYNC_NOTIFY_INDEX 1
+
+/**
+ * @brief 到期回调 (在定时器中断上下文中执行，请保持短小)
+ */
+typedef void (*delay_async_cb_t)(void *arg);
+
+/**
+ * @brief 初始化异步延时服务，启动定时器
+ * @note  在 MX_TIMx_Init 之后调用
+ */
+void delay_async_init(void);
+
+/**
+ * @brief 注册一个单次定时回调 (非阻塞，立即返回)
+ * @param us 延时微秒数 (32 位定时器可达 ~35 分钟，16 位定时器会自动分段比较)
+ * @param cb 到期回调
+ * @param arg 回调参数
+ * @return 0 成功，-1 队列已满
+ */
+int delay_async_us(uint32_t us, delay_async_cb_t cb, void *arg);
+
+/**
+ * @brief 定时器比较中断处理
+ * @note  必须在 HAL_TIM_OC_DelayElapsedCallback 中调用:
+ *        if (htim == DELAY_ASYNC_TIM_HANDLE) delay_async_irq_handler();
+ */
+void delay_async_irq_handler(void);
+
+/**
+ * @brief 当前时间 (us，32 位回绕)
+ */
+uint32_t delay_async_now_us(void);
+
+#if defined(USE_FREERTOS)
+/**
+ * @brief 阻塞延时：挂起当前任务，由比较中断通过任务通知唤醒
+ * @note  不依赖 RTOS tick，50us~2ms 区间也能让出 CPU；只能在任务中调用
+ * @param us 微秒数
+ */
+void delay_block_us(uint32_t us);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DELAY_ASYNC_H__ */
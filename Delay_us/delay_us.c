@@ -2,16 +2,272 @@
  * @file delay_us.c
  * @brief 基于 Cortex-M DWT (Data Watchpoint and Trace) 的高精度微秒延时库
  * @author 退休全栈嵌入式专家团
- * @note   兼容 STM32F1/F4/F7/H7 等 Cortex-M3/M4/M7 内核
+ * @note   兼容 STM32F1/F4/F7/H7 等 Cortex-M3/M4/M7 内核；
+ *         Cortex-M0/M0+ (F0/G0/L0/C0) 自动退化为 SysTick 或自由运行 TIM 计数
  */
 
 #include "delay_us.h"
 
-/* 记录每微秒需要的 CPU 周期数 (Ticks) */
+/* CMSIS 只在 M3 及以上内核的头文件里定义 DWT，M0/M0+ 上连符号都没有 */
+#if defined(DWT_BASE)
+    #define DELAY_HAS_DWT   1
+#else
+    #define DELAY_HAS_DWT   0
+#endif
+
+/* 当前使用的时间基准 */
+static delay_timebase_t timebase = DELAY_TIMEBASE_NONE;
+
+/* 记录每微秒需要的时间基准计数 (Ticks)；DWT/SysTick 下就是 CPU 周期数 */
 static volatile uint32_t us_ticks = 0;
 
+/* 每微秒 tick 数的小数部分 (Q32)：时间基准不是整数 MHz 或不到 1MHz 时非 0 */
+static uint32_t us_frac = 0;
+
+/* 时间基准频率，统计换算用 */
+static uint32_t tb_freq = 0;
+
+/* 单次 32 位忙等能安全覆盖的最大微秒数，超过后走分段长延时 */
+static uint32_t us_max_single = 0;
+
+/* 纳秒换算系数 (Q32 定点数)：ticks = (ns * ns_mult) >> 32，避免运行时除法 */
+static uint32_t ns_mult = 0;
+
+/* 自校准测得的固定开销 (函数调用 + 入口计算 + 退出判断)，单位：tick */
+static uint32_t call_overhead = 0;
+
+/* 分段长延时每段的 tick 数，远小于 2^31，保证无符号差值判断永远正确 */
+#define DELAY_CHUNK_TICKS   0x40000000u
+
+/* 校准采样次数，取最小值排除中断干扰 */
+#define DELAY_CALIB_ROUNDS  8
+
+#if defined(USE_DRV_STATS)
+static delay_stats_t delay_stats;
+
+/**
+ * @brief  记一次忙等 (任务和中断都会调用，关中断保证 64 位累加不被打断)
+ * @note   相比忙等本身，这几条指令可以忽略
+ */
+static inline void delay_stats_add(uint32_t ticks)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    delay_stats.calls++;
+    delay_stats.busy_ticks += ticks;
+    if (ticks > delay_stats.busy_max) delay_stats.busy_max = ticks;
+    __set_PRIMASK(primask);
+}
+#else
+#define delay_stats_add(ticks)  ((void)0)
+#endif
+
+/* ================= 时间基准层 ================= */
+
+/**
+ * @brief  读取时间基准的当前计数 (统一为向上计数)
+ * @note   DWT 为 32 位自由运行；SysTick/TIM 会在重装值处回绕，由 tb_elapsed 处理
+ */
+static inline uint32_t tb_read(void)
+{
+    switch (timebase) {
+#if DELAY_HAS_DWT
+    case DELAY_TIMEBASE_DWT:
+        return DWT->CYCCNT;
+#endif
+#if defined(DELAY_TIMEBASE_TIM)
+    case DELAY_TIMEBASE_TIMER:
+        return DELAY_TIMEBASE_TIM->CNT;
+#endif
+    case DELAY_TIMEBASE_SYSTICK:
+        /* SysTick 是向下计数的 24 位计数器，翻转成向上计数 */
+        return SysTick->LOAD - SysTick->VAL;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief  计数器周期 (重装值 + 1)，DWT 返回 0 表示 2^32
+ */
+static inline uint32_t tb_period(void)
+{
+    switch (timebase) {
+#if defined(DELAY_TIMEBASE_TIM)
+    case DELAY_TIMEBASE_TIMER:
+        return DELAY_TIMEBASE_TIM->ARR + 1;
+#endif
+    case DELAY_TIMEBASE_SYSTICK:
+        return SysTick->LOAD + 1;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief  两次读数之间经过的 tick (最多跨一次回绕)
+ */
+static inline uint32_t tb_elapsed(uint32_t prev, uint32_t cur, uint32_t period)
+{
+    return (cur >= prev || period == 0) ? (cur - prev) : (cur + period - prev);
+}
+
+/**
+ * @brief  检查 DWT 周期计数器是否真的可用
+ * @note   有的内核实现了 DWT 但没有 CYCCNT (NOCYCCNT 置位)，
+ *         有的芯片在调试器锁定时写 CYCCNTENA 无效，所以开启后再确认它在走
+ */
+static uint8_t tb_try_dwt(void)
+{
+#if DELAY_HAS_DWT
+    /* 解锁 DWT (对于某些 STM32，如 H7，或者是被调试器锁住的情况)
+     * CoreDebug->DEMCR 的 TRCENA 位必须置 1 才能使用 DWT
+     */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+    if (DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk) {
+        return 0;
+    }
+
+    /* 清零周期计数器 (CYCCNT) 并开启 (DWT_CTRL 的 CYCCNTENA 位置 1) */
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    uint32_t t0 = DWT->CYCCNT;
+    __NOP(); __NOP(); __NOP(); __NOP();
+    return (DWT->CYCCNT != t0);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief  选择时间基准并返回它的计数频率 (Hz)
+ */
+static uint32_t tb_select(void)
+{
+    if (tb_try_dwt()) {
+        timebase = DELAY_TIMEBASE_DWT;
+        return SystemCoreClock;
+    }
+
+#if defined(DELAY_TIMEBASE_TIM)
+    /* 用户提供了自由运行的定时器：确保它在计数即可 */
+    DELAY_TIMEBASE_TIM->CR1 |= 0x1u; /* CEN */
+    timebase = DELAY_TIMEBASE_TIMER;
+    return DELAY_TIMEBASE_TIM_HZ / (DELAY_TIMEBASE_TIM->PSC + 1);
+#else
+    /* SysTick 通常已被 HAL/RTOS 配置为 1ms 中断，我们只读 VAL 做节拍内插值，不碰它的配置。
+     * 如果还没人启动它，就以最大重装值、不开中断的方式自己跑起来 */
+    if (!(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk)) {
+        SysTick->LOAD = 0x00FFFFFF;
+        SysTick->VAL = 0;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+    timebase = DELAY_TIMEBASE_SYSTICK;
+    return (SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? SystemCoreClock : (SystemCoreClock / 8);
+#endif
+}
+
+/* ================= 延时核心 ================= */
+
+/**
+ * @brief  tick 级忙等 (已扣除固定开销)
+ * @note   ticks 必须小于 2^31
+ */
+static void delay_ticks(uint32_t ticks)
+{
+    uint32_t start_tick = tb_read();
+
+    /* 请求的 tick 数还不够抵消调用开销，进来一趟就已经够了 */
+    if (ticks <= call_overhead) {
+        return;
+    }
+    ticks -= call_overhead;
+
+#if DELAY_HAS_DWT
+    if (timebase == DELAY_TIMEBASE_DWT) {
+        /* * 这里的精髓在于利用 uint32_t 的溢出回绕特性。
+         * 即使 start_tick 接近 0xFFFFFFFF，
+         * (current - start) 的计算结果依然是正确的 tick 差值。
+         */
+        while ((DWT->CYCCNT - start_tick) < ticks)
+        {
+            /* * 在 FreeRTOS 环境下，如果这是一个极短的延时，
+             * 我们不希望调度器打断我们，导致延时变长（例如变成 1ms）。
+             * 但为了系统的实时性，通常我们允许中断发生。
+             * 如果需要绝对精确，可以在这里加 taskENTER_CRITICAL()，但慎用。
+             */
+            __NOP();
+        }
+        delay_stats_add(DWT->CYCCNT - start_tick);
+        return;
+    }
+#endif
+
+    /* * SysTick/TIM 的周期只有 1ms 左右，不能直接做差。
+     * 改为逐次累加相邻两次读数的差值，只要轮询间隔小于一个周期就不会丢 tick。
+     * 如果中断占用超过一个完整周期，延时会偏长而不会偏短。
+     */
+    uint32_t period = tb_period();
+    uint32_t prev = start_tick;
+    uint32_t elapsed = 0;
+
+    while (elapsed < ticks) {
+        uint32_t cur = tb_read();
+        elapsed += tb_elapsed(prev, cur, period);
+        prev = cur;
+    }
+    delay_stats_add(elapsed);
+}
+
+/**
+ * @brief  64 位 tick 的分段忙等，每段都远离 32 位回绕边界
+ */
+static void delay_ticks64(uint64_t ticks)
+{
+    while (ticks > DELAY_CHUNK_TICKS) {
+        delay_ticks(DELAY_CHUNK_TICKS);
+        ticks -= DELAY_CHUNK_TICKS;
+    }
+    delay_ticks((uint32_t)ticks);
+}
+
 /**
- * @brief  初始化 DWT 计数器
+ * @brief  测量 delay_us 自身的固定开销
+ * @note   以 1us 为样本：实测 tick - 理论 tick - 读计数器的开销 = 需要扣除的部分。
+ *         多次采样取最小值，被中断打断的那几次自然被淘汰。
+ */
+static void delay_calibrate(void)
+{
+    uint32_t best = 0xFFFFFFFF;
+    uint32_t read_cost = 0xFFFFFFFF;
+    uint32_t period = tb_period();
+
+    call_overhead = 0;
+
+    for (uint8_t i = 0; i < DELAY_CALIB_ROUNDS; i++) {
+        uint32_t t0 = tb_read();
+        uint32_t t1 = tb_read();
+        uint32_t d = tb_elapsed(t0, t1, period);
+        if (d < read_cost) read_cost = d;
+
+        t0 = tb_read();
+        delay_us(1);
+        t1 = tb_read();
+        d = tb_elapsed(t0, t1, period);
+        if (d < best) best = d;
+    }
+
+    /* delay_us(1) 请求的 tick 数：小数部分向上取整 */
+    uint32_t one_us = us_ticks + (us_frac != 0);
+
+    best = (best > read_cost) ? (best - read_cost) : 0;
+    call_overhead = (best > one_us) ? (best - one_us) : 0;
+}
+
+/**
+ * @brief  初始化延时组件
  * @note   在系统时钟配置完成后调用一次即可
  */
 void delay_init(void)
@@ -19,73 +275,113 @@ void delay_init(void)
     /* 1. 确保 SystemCoreClock 已更新为当前实际主频 */
     SystemCoreClockUpdate();
 
-    /* 2. 计算 1us 需要多少个时钟周期
+    /* 2. 选择时间基准：优先 DWT，没有则退化为 TIM / SysTick */
+    uint32_t tb_hz = tb_select();
+
+    /* 3. 计算 1us 需要多少个 tick
      * 例如：72MHz 主频 -> 1us = 72 个周期
      * 例如：400MHz 主频 -> 1us = 400 个周期
+     * 整数部分 + Q32 小数部分：直接整除的话 1MHz 以下是 0，
+     * 非整数 MHz (如 HSI 14.7456MHz) 每微秒都少几分之一个 tick
      */
-    us_ticks = SystemCoreClock / 1000000;
+    tb_freq = tb_hz;
+    us_ticks = tb_hz / 1000000;
+    us_frac = (uint32_t)(((uint64_t)(tb_hz % 1000000u) << 32) / 1000000u);
+    /* 小数部分最多给每微秒再加 1 个 tick，单段上限按 us_ticks + 1 算 */
+    uint32_t per_us = us_ticks + (us_frac != 0);
+    us_max_single = (per_us != 0) ? (0x7FFFFFFFu / per_us) : 0;
+    ns_mult = (uint32_t)(((uint64_t)tb_hz << 32) / 1000000000u);
 
-    /* 3. 解锁 DWT (对于某些 STM32，如 H7，或者是被调试器锁住的情况)
-     * CoreDebug->DEMCR 的 TRCENA 位必须置 1 才能使用 DWT
-     */
-    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    /* 4. 自校准：测出调用开销，之后每次延时都扣掉它 */
+    delay_calibrate();
 
-    /* 4. 清零周期计数器 (CYCCNT) */
-    DWT->CYCCNT = 0;
+#if defined(USE_DRV_STATS)
+    /* 校准本身的忙等不算 */
+    delay_reset_stats();
+#endif
+}
 
-    /* 5. 开启周期计数器
-     * DWT_CTRL 的 CYCCNTENA 位置 1
-     */
-    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+/**
+ * @brief  获取当前使用的时间基准
+ */
+delay_timebase_t delay_get_timebase(void)
+{
+    return timebase;
 }
 
+#if defined(USE_DRV_STATS)
+void delay_get_stats(delay_stats_t *out)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out = delay_stats;
+    __set_PRIMASK(primask);
+    out->ticks_per_us = us_ticks;
+    out->tb_hz = tb_freq;
+}
+
+void delay_reset_stats(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    delay_stats.calls = 0;
+    delay_stats.busy_ticks = 0;
+    delay_stats.busy_max = 0;
+    __set_PRIMASK(primask);
+}
+#endif
+
 /**
  * @brief  微秒级延时 (阻塞模式，但精度极高)
  * @param  us: 延时微秒数
  * @note   对于 < 100us 的延时，建议直接使用此函数。
- * DWT 是 32 位计数器，在 400MHz 下约 10 秒溢出，
- * 但下方的减法逻辑利用了无符号数回绕特性，
- * 只要延时不超过 2^32 个 tick (约 10秒) 都是安全的。
+ * DWT 是 32 位计数器，在 400MHz 下约 10 秒溢出。
+ * 短延时走 32 位快速路径；超过单段上限时按 64 位 tick 数分段等待，
+ * 因此 uint32_t 范围内的任意微秒数 (约 71 分钟) 都是安全的。
+ * 时间基准不是整数 MHz 时，小数部分按 Q32 累计后向上取整，保证不短于请求值。
  */
 void delay_us(uint32_t us)
 {
-    uint32_t start_tick = DWT->CYCCNT;
-    uint32_t target_ticks = us * us_ticks;
+    uint32_t frac = (us_frac != 0) ? (uint32_t)(((uint64_t)us * us_frac + 0xFFFFFFFFu) >> 32) : 0;
 
-    /* * 这里的精髓在于利用 uint32_t 的溢出回绕特性。
-     * 即使 start_tick 接近 0xFFFFFFFF，
-     * (current - start) 的计算结果依然是正确的 tick 差值。
-     */
-    while ((DWT->CYCCNT - start_tick) < target_ticks)
-    {
-        /* * 在 FreeRTOS 环境下，如果这是一个极短的延时，
-         * 我们不希望调度器打断我们，导致延时变长（例如变成 1ms）。
-         * 但为了系统的实时性，通常我们允许中断发生。
-         * 如果需要绝对精确，可以在这里加 taskENTER_CRITICAL()，但慎用。
-         */
-        __NOP(); 
+    if (us <= us_max_single) {
+        delay_ticks(us * us_ticks + frac);
+    } else {
+        delay_ticks64((uint64_t)us * us_ticks + frac);
     }
 }
 
+/**
+ * @brief  纳秒级延时
+ * @param  ns: 延时纳秒数
+ * @note   分辨率为 1 个 tick，但最短延时受调用开销限制
+ *         (校准后约为开销本身，72MHz 下几百纳秒)。
+ */
+void delay_ns(uint32_t ns)
+{
+    /* 向上取整，保证不短于请求值 */
+    uint64_t ticks = ((uint64_t)ns * ns_mult + 0xFFFFFFFFu) >> 32;
+    delay_ticks64(ticks);
+}
+
 /**
  * @brief  智能延时函数 (自动选择阻塞或 OS 挂起)
  * @param  us: 延时微秒数
  * @note   如果检测到运行了 FreeRTOS 且延时较长，则挂起任务；
- * 否则使用 DWT 死等。
+ * 否则忙等。
  */
 void delay_smart_us(uint32_t us)
 {
-    /* 阈值设定：比如 2000us (2ms) */
-    /* 如果你在 FreeRTOS 下且 tick 是 1ms，那么小于 1ms 的延时也没法 yield */
-    
 #if defined(USE_FREERTOS)
-    /* 假设 FreeRTOS 的 tick 是 1000Hz (1ms) */
-    const uint32_t os_threshold_us = 2000; 
+    /* 阈值 = 2 个 tick：vTaskDelay(n) 实际只保证 (n-1, n] 个 tick，
+     * 不到 2 个 tick 的延时 yield 出去误差比延时本身还大 */
+    const uint32_t tick_us = 1000000u / configTICK_RATE_HZ;
+    const uint32_t os_threshold_us = 2 * tick_us;
 
     if (us >= os_threshold_us)
     {
-        /* 转换为毫秒并向上取整，调用 RTOS 延时 */
-        vTaskDelay((us / 1000) + 1); 
+        /* 转换为 tick 并多加 1 个，保证不短于请求值 */
+        vTaskDelay((TickType_t)(us / tick_us) + 1);
     }
     else
     {
@@ -16,23 +16,74 @@ extern "C" {
     #include "task.h"
 #endif
 
+/* * 时间基准选择 (Cortex-M0/M0+ 没有 DWT 时生效)：
+ * 默认读取 SysTick 的当前值做节拍内插值，精度为 1 个 CPU 周期；
+ * 如果 SysTick 被占用或时钟源为 HCLK/8，可以指定一个自由运行的定时器
+ * (预分频 0，Counter Period 拉满，CubeMX 中配置并启动)。
+ */
+// #define DELAY_TIMEBASE_TIM      TIM14
+// #define DELAY_TIMEBASE_TIM_HZ   SystemCoreClock   /* 定时器输入时钟 (预分频之前) */
+
+typedef enum {
+    DELAY_TIMEBASE_NONE = 0,  /* 尚未初始化 */
+    DELAY_TIMEBASE_DWT,       /* DWT->CYCCNT，M3/M4/M7 */
+    DELAY_TIMEBASE_SYSTICK,   /* SysTick 节拍内插值 */
+    DELAY_TIMEBASE_TIMER      /* 用户指定的自由运行 TIM */
+} delay_timebase_t;
+
 /**
- * @brief 初始化 DWT 延时组件
+ * @brief 初始化延时组件 (自动选择 DWT / TIM / SysTick)
  */
 void delay_init(void);
 
 /**
- * @brief 微秒延时 (DWT 忙等待)
+ * @brief 获取 delay_init 选中的时间基准
+ */
+delay_timebase_t delay_get_timebase(void);
+
+/**
+ * @brief 微秒延时 (忙等待，计数来自 delay_init 选中的时间基准)
  * @param us 微秒数
  */
 void delay_us(uint32_t us);
 
+/**
+ * @brief 纳秒延时 (忙等待，已扣除调用开销；分辨率为时间基准的 1 个 tick)
+ * @param ns 纳秒数
+ */
+void delay_ns(uint32_t ns);
+
 /**
  * @brief 智能延时 (根据时长自动选择忙等待或操作系统挂起)
+ * @note  切换阈值由 configTICK_RATE_HZ 推导 (2 个 tick)
  * @param us 微秒数
  */
 void delay_smart_us(uint32_t us);
 
+#if defined(USE_DRV_STATS)
+/**
+ * @brief 忙等统计 (需要全局定义 USE_DRV_STATS)
+ * @note  tick 是 delay_init 选中的时间基准的计数，DWT / SysTick 下就是 CPU 周期
+ */
+typedef struct {
+    uint32_t calls;         // 忙等次数 (超过 2^30 tick 的超长延时按段计)
+    uint64_t busy_ticks;    // 累计忙等 tick
+    uint32_t busy_max;      // 单次最长忙等 tick
+    uint32_t ticks_per_us;  // 每微秒 tick 数的整数部分 (不到 1MHz 时为 0)
+    uint32_t tb_hz;         // 时间基准频率，换算微秒用这个
+} delay_stats_t;
+
+/**
+ * @brief 读取忙等统计快照
+ */
+void delay_get_stats(delay_stats_t *out);
+
+/**
+ * @brief 清零忙等统计
+ */
+void delay_reset_stats(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,202 @@
+/**
+ * @file drv_stats.c
+ * @brief 驱动运行统计的周期报告
+ * @note  只读各驱动的快照接口，不碰它们的热路径；速率按两次报告之间的增量计算，
+ *        所以驱动的计数器可以一直累加 (32 位回绕不影响差值)
+ */
+
+#include "drv_stats.h"
+
+#if defined(USE_DRV_STATS)
+
+#include "dma_fifo_print.h"
+#include <stdio.h>
+#include <string.h>
+#if DRV_STATS_OLED
+#include "Oled.h"
+#endif
+#if DRV_STATS_SOFT_OLED
+#include "soft_oled.h"
+#endif
+#if DRV_STATS_DELAY
+#include "delay_us.h"
+#endif
+
+/* 上一份报告时的快照 */
+static uint32_t stats_last_tick;
+#if DRV_STATS_OLED
+static OLED_Stats_t stats_last_oled;
+#endif
+#if DRV_STATS_SOFT_OLED
+static SoftOLED_Stats_t stats_last_soft;
+#endif
+#if DRV_STATS_PRINT
+static DMA_Print_Stats_t stats_last_print;
+#endif
+#if DRV_STATS_DELAY
+static delay_stats_t stats_last_delay;
+#endif
+
+static void stats_print(const char *line, int len)
+{
+    if (len <= 0) return;
+    if (len >= 128) len = 127;
+    DMA_Printf_Push(&g_dma_print_handle, (uint8_t *)line, (uint16_t)len);
+}
+
+/**
+ * @brief  区间内的增量换算成每秒
+ */
+static uint32_t stats_per_sec(uint32_t delta, uint32_t ms)
+{
+    return (uint32_t)(((uint64_t)delta * 1000u) / ms);
+}
+
+/**
+ * @brief  CPU 周期换算为微秒
+ */
+static uint32_t stats_cycles_to_us(uint64_t cycles)
+{
+    uint32_t mhz = SystemCoreClock / 1000000u;
+    return mhz ? (uint32_t)(cycles / mhz) : 0;
+}
+
+/**
+ * @brief  占用率 (0.1% 为单位)：busy_us / 区间长度
+ */
+static uint32_t stats_permille(uint32_t busy_us, uint32_t ms)
+{
+    return busy_us / ms;
+}
+
+#if DRV_STATS_OLED || DRV_STATS_SOFT_OLED
+/**
+ * @brief  两个 OLED 驱动的统计结构字段相同，共用一种输出格式
+ */
+static void stats_report_oled(const char *name, uint32_t ms, uint32_t xfers, uint32_t bytes,
+                              uint64_t busy, uint32_t frames, uint32_t frame_last, uint32_t frame_max)
+{
+    char line[128];
+    uint32_t busy_us = stats_cycles_to_us(busy);
+    uint32_t pm = stats_permille(busy_us, ms);
+    uint32_t last_us = stats_cycles_to_us(frame_last);
+    uint32_t max_us = stats_cycles_to_us(frame_max);
+
+    int len = snprintf(line, sizeof(line),
+                       "  %-6s %lu xfer/s %lu B/s busy %lu.%lu%% frame %lu/s last %lu.%03lu max %lu.%03lu ms\r\n",
+                       name, (unsigned long)stats_per_sec(xfers, ms), (unsigned long)stats_per_sec(bytes, ms),
+                       (unsigned long)(pm / 10), (unsigned long)(pm % 10),
+                       (unsigned long)stats_per_sec(frames, ms),
+                       (unsigned long)(last_us / 1000), (unsigned long)(last_us % 1000),
+                       (unsigned long)(max_us / 1000), (unsigned long)(max_us % 1000));
+    stats_print(line, len);
+}
+#endif
+
+/**
+ * @brief  输出一份报告
+ * @note   每个驱动一行；B/s、次/s 是本区间的平均值，峰值类 (max、peak) 是上电或上次清零以来的
+ */
+void drv_stats_report(void)
+{
+    char line[128];
+    int len;
+    uint32_t now = HAL_GetTick();
+    uint32_t ms = now - stats_last_tick;
+
+    if (ms == 0) ms = 1;
+    stats_last_tick = now;
+
+    len = snprintf(line, sizeof(line), "\r\n[STAT] %lu ms @ %lu MHz\r\n",
+                   (unsigned long)ms, (unsigned long)(SystemCoreClock / 1000000u));
+    stats_print(line, len);
+
+#if DRV_STATS_OLED
+    {
+        OLED_Stats_t cur;
+        OLED_GetStats(&cur);
+        stats_report_oled("oled", ms, cur.xfers - stats_last_oled.xfers, cur.bytes - stats_last_oled.bytes,
+                          cur.busy_cycles - stats_last_oled.busy_cycles, cur.frames - stats_last_oled.frames,
+                          cur.frame_last, cur.frame_max);
+        stats_last_oled = cur;
+    }
+#endif
+
+#if DRV_STATS_SOFT_OLED
+    {
+        SoftOLED_Stats_t cur;
+        SoftOLED_GetStats(&cur);
+        stats_report_oled("soled", ms, cur.xfers - stats_last_soft.xfers, cur.bytes - stats_last_soft.bytes,
+                          cur.busy_cycles - stats_last_soft.busy_cycles, cur.frames - stats_last_soft.frames,
+                          cur.frame_last, cur.frame_max);
+        stats_last_soft = cur;
+    }
+#endif
+
+#if DRV_STATS_PRINT
+    {
+        DMA_Print_Stats_t cur;
+        DMA_Printf_GetStats(&g_dma_print_handle, &cur);
+        len = snprintf(line, sizeof(line),
+                       "  %-6s in %lu B/s tx %lu B/s %lu dma/s buf %u/%u peak %u drop %lu (+%lu)\r\n",
+                       "print",
+                       (unsigned long)stats_per_sec(cur.bytes_in - stats_last_print.bytes_in, ms),
+                       (unsigned long)stats_per_sec(cur.bytes_tx - stats_last_print.bytes_tx, ms),
+                       (unsigned long)stats_per_sec(cur.dma_xfers - stats_last_print.dma_xfers, ms),
+                       (unsigned)cur.level, (unsigned)TX_RING_BUFFER_SIZE, (unsigned)cur.level_max,
+                       (unsigned long)cur.dropped, (unsigned long)(cur.dropped - stats_last_print.dropped));
+        stats_print(line, len);
+        stats_last_print = cur;
+    }
+#endif
+
+#if DRV_STATS_DELAY
+    {
+        delay_stats_t cur;
+        delay_get_stats(&cur);
+        uint64_t ticks = cur.busy_ticks - stats_last_delay.busy_ticks;
+        uint32_t tb_hz = cur.tb_hz ? cur.tb_hz : 1000000u;
+        uint32_t busy_us = (uint32_t)(ticks * 1000000u / tb_hz);
+        uint32_t pm = stats_permille(busy_us, ms);
+        len = snprintf(line, sizeof(line),
+                       "  %-6s %lu call/s busy %lu us/s (%lu.%lu%%) max %lu us\r\n",
+                       "delay",
+                       (unsigned long)stats_per_sec(cur.calls - stats_last_delay.calls, ms),
+                       (unsigned long)stats_per_sec(busy_us, ms),
+                       (unsigned long)(pm / 10), (unsigned long)(pm % 10),
+                       (unsigned long)((uint64_t)cur.busy_max * 1000000u / tb_hz));
+        stats_print(line, len);
+        stats_last_delay = cur;
+    }
+#endif
+}
+
+void drv_stats_poll(void)
+{
+    if (HAL_GetTick() - stats_last_tick >= DRV_STATS_PERIOD_MS) {
+        drv_stats_report();
+    }
+}
+
+void drv_stats_reset(void)
+{
+#if DRV_STATS_OLED
+    OLED_ResetStats();
+    memset(&stats_last_oled, 0, sizeof(stats_last_oled));
+#endif
+#if DRV_STATS_SOFT_OLED
+    SoftOLED_ResetStats();
+    memset(&stats_last_soft, 0, sizeof(stats_last_soft));
+#endif
+#if DRV_STATS_PRINT
+    DMA_Printf_ResetStats(&g_dma_print_handle);
+    memset(&stats_last_print, 0, sizeof(stats_last_print));
+#endif
+#if DRV_STATS_DELAY
+    delay_reset_stats();
+    memset(&stats_last_delay, 0, sizeof(stats_last_delay));
+#endif
+    stats_last_tick = HAL_GetTick();
+}
+
+#endif /* USE_DRV_STATS */
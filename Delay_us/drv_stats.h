@@ -0,0 +1,75 @@
+#ifndef __DRV_STATS_H__
+#define __DRV_STATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* * 驱动运行统计：
+ * 全局定义 USE_DRV_STATS 后，OLED / 软件 OLED / dma_fifo_print / delay_us 在热路径上累加各自的计数器
+ * (每次 I2C 事务、每次 DMA 传输、每次忙等各几条指令)，并提供 xxx_GetStats / xxx_ResetStats 快照接口；
+ * 本模块把它们汇总成按秒折算的报告，通过 DMA 打印器周期输出。
+ * 不定义 USE_DRV_STATS 时计数器、接口和下面的宏全部不参与编译。
+ */
+
+/* ================= 用户配置区 ================= */
+
+/* 报告包含哪些驱动 (没加入工程的驱动置 0，否则链接不到它的快照接口) */
+#ifndef DRV_STATS_OLED
+#define DRV_STATS_OLED          1   /* 硬件 I2C OLED (Oled.c) */
+#endif
+#ifndef DRV_STATS_SOFT_OLED
+#define DRV_STATS_SOFT_OLED     0   /* 软件 I2C OLED (soft_oled.c) */
+#endif
+#ifndef DRV_STATS_PRINT
+#define DRV_STATS_PRINT         1   /* g_dma_print_handle */
+#endif
+#ifndef DRV_STATS_DELAY
+#define DRV_STATS_DELAY         1   /* delay_us 忙等 */
+#endif
+
+/* drv_stats_poll 的报告周期 (ms) */
+#ifndef DRV_STATS_PERIOD_MS
+#define DRV_STATS_PERIOD_MS     1000
+#endif
+
+/* 驱动计时用的周期计数：Cortex-M0/M0+ 没有 DWT，耗时类统计恒为 0 */
+#if defined(DWT_BASE)
+#define DRV_STATS_CYCLES()      (DWT->CYCCNT)
+#else
+#define DRV_STATS_CYCLES()      (0u)
+#endif
+
+#if defined(USE_DRV_STATS)
+
+/**
+ * @brief 输出一份报告：各计数器自上次报告以来的增量，按秒折算
+ * @note  报告走 g_dma_print_handle，本身也会计入打印器的统计 (每份约 250 字节)
+ */
+void drv_stats_report(void);
+
+/**
+ * @brief 到了 DRV_STATS_PERIOD_MS 就输出一份报告，放在主循环或低优先级任务中
+ */
+void drv_stats_poll(void);
+
+/**
+ * @brief 清零所有驱动的计数器，下一份报告从此刻算起
+ */
+void drv_stats_reset(void);
+
+#else
+
+#define drv_stats_report()      ((void)0)
+#define drv_stats_poll()        ((void)0)
+#define drv_stats_reset()       ((void)0)
+
+#endif /* USE_DRV_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DRV_STATS_H__ */
@@ -0,0 +1,244 @@
+/**
+ * @file dwt_profiler.c
+ * @brief 基于 DWT 周期计数器的轻量级性能分析器
+ * @note  探针统计表为静态分配，报告通过 dma_fifo_print 非阻塞输出
+ */
+
+#include "dwt_profiler.h"
+
+#if PROF_ENABLE
+
+#include "dma_fifo_print.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 探针统计表 */
+static prof_probe_t prof_table[PROF_MAX_PROBES];
+static uint8_t prof_count = 0;
+volatile uint16_t prof_gen = 1;
+
+/* 64 位扩展：高 32 位 + 上一次看到的低 32 位 */
+static uint32_t cyc_high = 0;
+static uint32_t cyc_last = 0;
+
+/**
+ * @brief  初始化 (开启 DWT 并清空统计表)
+ * @note   表清空后 ID 会重新分配，代号加一让各个 PROF_BEGIN 下次执行时重新注册
+ */
+void prof_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(prof_table, 0, sizeof(prof_table));
+    prof_count = 0;
+    if (++prof_gen == 0) {
+        prof_gen = 1;
+    }
+    cyc_high = 0;
+    cyc_last = DWT->CYCCNT;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  清空统计数据，保留探针名称
+ */
+void prof_reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t i = 0; i < prof_count; i++) {
+        const char *name = prof_table[i].name;
+        memset(&prof_table[i], 0, sizeof(prof_probe_t));
+        prof_table[i].name = name;
+        prof_table[i].min = 0xFFFFFFFF;
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  64 位周期计数
+ * @note   检测到低 32 位变小就说明发生了一次回绕，高位 +1。
+ *         关中断保证 ISR 与任务同时调用时高低位一致。
+ */
+uint64_t prof_cycles64(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t now = DWT->CYCCNT;
+    if (now < cyc_last) {
+        cyc_high++;
+    }
+    cyc_last = now;
+    uint64_t result = ((uint64_t)cyc_high << 32) | now;
+
+    __set_PRIMASK(primask);
+    return result;
+}
+
+/**
+ * @brief  按名称注册探针
+ * @note   只在每个 PROF_BEGIN 第一次执行时调用，线性查找即可
+ */
+uint8_t prof_register(const char *name)
+{
+    uint8_t id = PROF_INVALID_ID;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t i = 0; i < prof_count; i++) {
+        if (strcmp(prof_table[i].name, name) == 0) {
+            id = i;
+            break;
+        }
+    }
+
+    if (id == PROF_INVALID_ID && prof_count < PROF_MAX_PROBES) {
+        id = prof_count++;
+        memset(&prof_table[id], 0, sizeof(prof_probe_t));
+        prof_table[id].name = name;
+        prof_table[id].min = 0xFFFFFFFF;
+    }
+
+    __set_PRIMASK(primask);
+    return id;
+}
+
+/**
+ * @brief  注册并带上代号
+ * @note   和 prof_register 在同一个临界区里读代号，prof_init 不会夹在两者之间
+ */
+uint32_t prof_bind(const char *name)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t bound = ((uint32_t)prof_gen << 8) | prof_register(name);
+    __set_PRIMASK(primask);
+    return bound;
+}
+
+/**
+ * @brief  计算直方图桶号 (按耗时的二进制位数分桶)
+ */
+static uint8_t prof_bucket(uint32_t cycles)
+{
+    uint32_t bits = (cycles == 0) ? 0 : (32 - __CLZ(cycles));
+
+    if (bits <= PROF_HIST_MIN_SHIFT) return 0;
+    bits -= PROF_HIST_MIN_SHIFT;
+    return (bits >= PROF_HIST_BUCKETS) ? (PROF_HIST_BUCKETS - 1) : (uint8_t)bits;
+}
+
+/**
+ * @brief  记录一次测量 (PROF_END 的热路径)
+ */
+void prof_record(uint8_t id, uint32_t start)
+{
+    /* 先取结束时刻，后面的统计开销不计入本次测量 */
+    uint32_t delta = DWT->CYCCNT - start;
+
+    if (id >= prof_count) return;
+
+    prof_probe_t *p = &prof_table[id];
+    uint8_t bucket = prof_bucket(delta);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    p->count++;
+    p->total += delta;
+    if (delta < p->min) p->min = delta;
+    if (delta > p->max) p->max = delta;
+    p->hist[bucket]++;
+
+    __set_PRIMASK(primask);
+
+    /* 顺带维护 64 位扩展，保证长时间运行不丢回绕 */
+    (void)prof_cycles64();
+}
+
+const prof_probe_t *prof_get(uint8_t id)
+{
+    return (id < prof_count) ? &prof_table[id] : NULL;
+}
+
+/**
+ * @brief  周期数换算为纳秒 (避免浮点，也避免 printf 的 %llu 依赖)
+ */
+static uint32_t prof_cycles_to_ns(uint32_t cycles)
+{
+    uint32_t mhz = SystemCoreClock / 1000000;
+    if (mhz == 0) return 0;
+    return (uint32_t)(((uint64_t)cycles * 1000) / mhz);
+}
+
+#define PROF_LINE_SIZE  128
+
+/**
+ * @brief  输出一行；len 是 snprintf 的返回值，被截断时只发缓冲区里实际有的部分
+ */
+static void prof_print(const char *line, int len)
+{
+    if (len <= 0) return;
+    if (len >= PROF_LINE_SIZE) len = PROF_LINE_SIZE - 1;
+    DMA_Printf_Push(&g_dma_print_handle, (uint8_t *)line, (uint16_t)len);
+}
+
+/**
+ * @brief  输出统计报告
+ * @note   每个探针两行：汇总 + 直方图。耗时同时给出周期数和微秒数。
+ */
+void prof_dump(void)
+{
+    char line[PROF_LINE_SIZE];
+    int len;
+
+    len = snprintf(line, sizeof(line), "\r\n[PROF] %u probes @ %lu MHz\r\n",
+                   (unsigned)prof_count, (unsigned long)(SystemCoreClock / 1000000));
+    prof_print(line, len);
+
+    for (uint8_t i = 0; i < prof_count; i++) {
+        prof_probe_t snap;
+
+        /* 拷贝快照，避免打印过程中被 ISR 改写 */
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        snap = prof_table[i];
+        __set_PRIMASK(primask);
+
+        if (snap.count == 0) {
+            len = snprintf(line, sizeof(line), "  %-16s n=0\r\n", snap.name);
+            prof_print(line, len);
+            continue;
+        }
+
+        uint32_t mean = (uint32_t)(snap.total / snap.count);
+        uint32_t mean_ns = prof_cycles_to_ns(mean);
+        uint32_t max_ns = prof_cycles_to_ns(snap.max);
+
+        len = snprintf(line, sizeof(line),
+                       "  %-16s n=%lu min=%lu max=%lu mean=%lu cyc (%lu.%03lu/%lu.%03lu us)\r\n",
+                       snap.name, (unsigned long)snap.count,
+                       (unsigned long)snap.min, (unsigned long)snap.max, (unsigned long)mean,
+                       (unsigned long)(mean_ns / 1000), (unsigned long)(mean_ns % 1000),
+                       (unsigned long)(max_ns / 1000), (unsigned long)(max_ns % 1000));
+        prof_print(line, len);
+
+        len = snprintf(line, sizeof(line), "  %-16s hist(<2^%d..):", "", PROF_HIST_MIN_SHIFT);
+        for (uint8_t b = 0; b < PROF_HIST_BUCKETS && len > 0 && len < (int)sizeof(line); b++) {
+            len += snprintf(line + len, sizeof(line) - len, " %lu", (unsigned long)snap.hist[b]);
+        }
+        if (len > 0 && len < (int)sizeof(line) - 2) {
+            line[len++] = '\r';
+            line[len++] = '\n';
+        }
+        prof_print(line, len);
+    }
+}
+
+#endif /* PROF_ENABLE */
@@ -0,0 +1,126 @@
+#ifndef __DWT_PROFILER_H__
+#define __DWT_PROFILER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* ================= 用户配置区 ================= */
+
+/* 总开关：置 0 后所有 PROF_xxx 宏展开为空，不占用任何 Flash/RAM/周期 */
+#ifndef PROF_ENABLE
+#define PROF_ENABLE         1
+#endif
+
+/* 最多可注册的探针数量 (静态表，按需调整) */
+#ifndef PROF_MAX_PROBES
+#define PROF_MAX_PROBES     16
+#endif
+
+/* 直方图桶数量：第 i 个桶统计 [2^(MIN_SHIFT+i-1), 2^(MIN_SHIFT+i)) 周期，
+ * 第 0 个桶统计 < 2^MIN_SHIFT，最后一个桶兜底所有更长的耗时 */
+#ifndef PROF_HIST_BUCKETS
+#define PROF_HIST_BUCKETS   8
+#endif
+#ifndef PROF_HIST_MIN_SHIFT
+#define PROF_HIST_MIN_SHIFT 8   /* 256 周期起步，72MHz 下约 3.5us */
+#endif
+
+#define PROF_INVALID_ID     0xFF
+
+/**
+ * @brief 单个探针的统计数据
+ */
+typedef struct {
+    const char *name;                   // 探针名称 (指向字符串常量)
+    uint32_t count;                     // 命中次数
+    uint32_t min;                       // 最短耗时 (周期)
+    uint32_t max;                       // 最长耗时 (周期)
+    uint64_t total;                     // 累计耗时 (周期)，用于计算平均值
+    uint32_t hist[PROF_HIST_BUCKETS];   // 对数直方图
+} prof_probe_t;
+
+#if PROF_ENABLE
+
+/* 探针表的代号：prof_init 清空表时加一，PROF_BEGIN 缓存的 ID 随之作废 */
+extern volatile uint16_t prof_gen;
+
+/**
+ * @brief 初始化性能分析器 (内部会确保 DWT 已开启)
+ * @note  可在 delay_init 之前或之后调用
+ */
+void prof_init(void);
+
+/**
+ * @brief 清空所有探针的统计数据 (保留已注册的名称)
+ */
+void prof_reset(void);
+
+/**
+ * @brief 读取扩展到 64 位的周期计数
+ * @note  只要两次调用间隔不超过一次 CYCCNT 回绕 (400MHz 下约 10 秒) 即可保证单调。
+ *        PROF_END 每次都会顺带调用，正常运行的固件无需额外维护。
+ */
+uint64_t prof_cycles64(void);
+
+/**
+ * @brief 按名称注册探针 (同名返回同一个 ID)
+ * @return 探针 ID，表满时返回 PROF_INVALID_ID
+ */
+uint8_t prof_register(const char *name);
+
+/**
+ * @brief 注册探针并带上当前代号，PROF_BEGIN 首次执行 (或 prof_init 之后) 时自动调用
+ * @return (prof_gen << 8) | ID；表满时 ID 为 PROF_INVALID_ID，同样会被缓存，之后不再查表
+ */
+uint32_t prof_bind(const char *name);
+
+/**
+ * @brief 记录一次测量结果
+ * @param id 探针 ID
+ * @param start PROF_BEGIN 时刻的 CYCCNT
+ */
+void prof_record(uint8_t id, uint32_t start);
+
+/**
+ * @brief 通过 DMA 打印器输出全部探针的统计报告
+ * @note  报告走 g_dma_print_handle，不会阻塞 CPU；报告本身较长，注意环形缓冲区容量
+ */
+void prof_dump(void);
+
+/**
+ * @brief 获取探针统计数据 (只读)，用于自定义上报
+ */
+const prof_probe_t *prof_get(uint8_t id);
+
+/* * 探针宏：同一作用域内 BEGIN/END 成对使用，tag 为合法的 C 标识符
+ *   PROF_BEGIN(oled_flush);
+ *   OLED_Flush();
+ *   PROF_END(oled_flush);
+ * 首次执行时按名称注册，之后热路径只有一次代号比较和一次 CYCCNT 读取。
+ * 缓存值为 0 (代号 0 从不使用) 表示还没注册过；表满时缓存 PROF_INVALID_ID，PROF_END 直接忽略。
+ */
+#define PROF_BEGIN(tag)                                                     \
+    static uint32_t prof_id_##tag;                                          \
+    if ((prof_id_##tag >> 8) != prof_gen) prof_id_##tag = prof_bind(#tag); \
+    uint32_t prof_t0_##tag = DWT->CYCCNT
+
+#define PROF_END(tag)   prof_record((uint8_t)prof_id_##tag, prof_t0_##tag)
+
+#else
+
+#define prof_init()         ((void)0)
+#define prof_reset()        ((void)0)
+#define prof_dump()         ((void)0)
+#define PROF_BEGIN(tag)     do {} while (0)
+#define PROF_END(tag)       do {} while (0)
+
+#endif /* PROF_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DWT_PROFILER_H__ */
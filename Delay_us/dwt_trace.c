@@ -0,0 +1,95 @@
+/**
+ * @file dwt_trace.c
+ * @brief 基于 DWT 周期计数器的事件时间线记录器 (M0/M0+ 用 SysTick 代替)
+ * @note  记录写入无锁环形缓冲区，由 trace_drain 打包成 COBS 遥测帧经 dma_fifo_print 发出，
+ *        PC 端用 tools/trace2json.c 转成 Chrome trace / Perfetto 可以直接打开的 JSON
+ */
+
+#include "dwt_trace.h"
+
+#if TRACE_ENABLE
+
+#include "dma_fifo_print.h"
+#include <string.h>
+
+#if !DMA_PRINT_TELEMETRY
+#error "dwt_trace 需要 dma_fifo_print.h 中开启 DMA_PRINT_TELEMETRY"
+#endif
+
+trace_rec_t trace_buf[TRACE_BUF_RECORDS];
+volatile uint32_t trace_wr = 0;
+
+static uint32_t trace_rd = 0;
+static uint32_t trace_lost = 0;
+
+/**
+ * @brief  初始化
+ */
+void trace_init(void)
+{
+#if defined(DWT_BASE)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(trace_buf, 0, sizeof(trace_buf));
+    trace_wr = 0;
+    trace_rd = 0;
+    trace_lost = 0;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief  打包发送
+ * @note   帧负载: core_hz (4) | 累计丢失数 (4) | 记录 x N
+ *         主机端靠 core_hz 把周期换算成微秒，靠丢失数提示时间线有缺口
+ */
+uint16_t trace_drain(void)
+{
+    uint8_t frame[8 + TRACE_RECORDS_PER_FRAME * sizeof(trace_rec_t)];
+    uint16_t sent = 0;
+
+    for (;;) {
+        uint32_t wr = trace_wr;
+
+        // 写入方跑得比发送快，最老的记录已经被覆盖
+        if (wr - trace_rd > TRACE_BUF_RECORDS) {
+            trace_lost += wr - trace_rd - TRACE_BUF_RECORDS;
+            trace_rd = wr - TRACE_BUF_RECORDS;
+        }
+
+        uint32_t n = wr - trace_rd;
+        if (n == 0) {
+            break;
+        }
+        if (n > TRACE_RECORDS_PER_FRAME) {
+            n = TRACE_RECORDS_PER_FRAME;
+        }
+
+        memcpy(&frame[0], &SystemCoreClock, 4);
+        memcpy(&frame[4], &trace_lost, 4);
+        for (uint32_t i = 0; i < n; i++) {
+            memcpy(&frame[8 + i * sizeof(trace_rec_t)],
+                   &trace_buf[(trace_rd + i) & (TRACE_BUF_RECORDS - 1)],
+                   sizeof(trace_rec_t));
+        }
+
+        // 串口缓冲区满了就留到下次，记录不前移
+        if (DMA_Printf_Frame(&g_dma_print_handle, TRACE_FRAME_TYPE, frame,
+                             (uint16_t)(8 + n * sizeof(trace_rec_t))) != 0) {
+            break;
+        }
+        trace_rd += n;
+        sent += n;
+    }
+    return sent;
+}
+
+uint32_t trace_dropped(void)
+{
+    return trace_lost;
+}
+
+#endif /* TRACE_ENABLE */
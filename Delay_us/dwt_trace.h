@@ -0,0 +1,176 @@
+#ifndef __DWT_TRACE_H__
+#define __DWT_TRACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* ================= 用户配置区 ================= */
+
+/* 总开关：置 0 后所有 TRACE_xxx 宏展开为空 */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE            1
+#endif
+
+/* 记录缓冲区容量 (条)，必须是 2 的幂；每条 8 字节 */
+#ifndef TRACE_BUF_RECORDS
+#define TRACE_BUF_RECORDS       256
+#endif
+
+/* 通过 DMA_Printf_Frame 发送时使用的帧类型，不要与自己的遥测帧冲突 */
+#ifndef TRACE_FRAME_TYPE
+#define TRACE_FRAME_TYPE        0x7E
+#endif
+
+/* 每帧最多携带的记录数：8 字节帧头 + 30 x 8 = 248，正好是 DMA_TELEM_MAX_PAYLOAD */
+#define TRACE_RECORDS_PER_FRAME 30
+
+#if (TRACE_BUF_RECORDS & (TRACE_BUF_RECORDS - 1)) != 0
+#error "TRACE_BUF_RECORDS 必须是 2 的幂"
+#endif
+
+/* * 事件 ID (16 位)：
+ *   [15:14] 类型  0=瞬时事件 1=开始 2=结束 3=计数器
+ *   [13:8]  轨道  对应 Chrome trace 里的一行 (tid)
+ *   [7:0]   事件号 (轨道内自定义)
+ * 附带 16 位参数 arg：长度、IRQ 号、任务号、计数值等
+ */
+#define TRACE_KIND_INSTANT      0u
+#define TRACE_KIND_BEGIN        1u
+#define TRACE_KIND_END          2u
+#define TRACE_KIND_COUNTER      3u
+
+#define TRACE_ID(kind, track, evt) \
+    ((uint16_t)(((kind) << 14) | (((track) & 0x3Fu) << 8) | ((evt) & 0xFFu)))
+
+/* 预定义轨道 (8 以后留给用户) */
+#define TRACE_TRACK_ISR         0   /* 事件号 = IRQ 号 */
+#define TRACE_TRACK_TASK        1   /* 事件号 = RTOS 任务号 */
+#define TRACE_TRACK_OLED        2
+#define TRACE_TRACK_DMA_PRINT   3
+#define TRACE_TRACK_USER        8
+
+/* 驱动内置事件 (需要全局定义 USE_DWT_TRACE 才会埋点) */
+#define TRACE_EVT_OLED_WRITE    1   /* OLED 数据写入，arg = 字节数 */
+#define TRACE_EVT_OLED_CMD      2   /* OLED 命令写入，arg = 命令字 */
+#define TRACE_EVT_DMA_TX        1   /* 串口 DMA 传输，arg = 字节数 */
+
+/**
+ * @brief 单条记录 (8 字节)
+ */
+typedef struct {
+    uint32_t cycles;    // 事件发生时的周期计数 (TRACE_CYCLES)
+    uint16_t id;        // 事件 ID
+    uint16_t arg;       // 参数
+} trace_rec_t;
+
+#if TRACE_ENABLE
+
+/* * 时间戳：M3 及以上直接读 DWT->CYCCNT。
+ * Cortex-M0/M0+ 没有 DWT，用 "毫秒节拍 x SysTick 周期 + 当前计数" 拼出等效的周期数，
+ * 要求 SysTick 用内核时钟、1ms 中断 (HAL 默认配置)，否则主机端换算出的时间不对
+ */
+#if defined(DWT_BASE)
+#define TRACE_CYCLES()          (DWT->CYCCNT)
+#else
+/**
+ * @brief 由 SysTick 拼出的周期数 (必须在关中断时调用)
+ * @note  关中断期间 SysTick 回绕了但中断还没进，uwTick 少加了一拍：看 PENDSTSET 补上，
+ *        并重读 VAL (第一次可能是回绕前读的)
+ */
+static inline uint32_t trace_systick_cycles(void)
+{
+    uint32_t period = SysTick->LOAD + 1u;
+    uint32_t val = SysTick->VAL;
+    uint32_t ms = HAL_GetTick();
+
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        val = SysTick->VAL;
+        ms++;
+    }
+    return ms * period + (period - 1u - val);
+}
+#define TRACE_CYCLES()          trace_systick_cycles()
+#endif
+
+/* 热路径直接内联访问 */
+extern trace_rec_t trace_buf[TRACE_BUF_RECORDS];
+extern volatile uint32_t trace_wr;
+
+/**
+ * @brief 初始化 (有 DWT 时开启周期计数器，清空缓冲区)
+ */
+void trace_init(void);
+
+/**
+ * @brief 把积压的记录打包成遥测帧交给 DMA 打印器
+ * @note  必须在最低优先级运行 (主循环或 RTOS 空闲钩子)：写入方在申请槽位和填写内容之间
+ *        不能被 trace_drain 抢占，否则可能读到还没写完的记录
+ * @return 本次发送的记录数
+ */
+uint16_t trace_drain(void);
+
+/**
+ * @brief 因缓冲区被覆盖而丢失的记录总数
+ */
+uint32_t trace_dropped(void);
+
+/**
+ * @brief 记录一个事件 (可在任意中断/任务中调用，无锁)
+ * @note  M3 及以上用 LDREX/STREX 申请槽位，时间戳在同一个原子区间里读取，
+ *        保证缓冲区中的顺序就是时间顺序；M0/M0+ 关中断申请槽位，时间戳来自 SysTick
+ */
+static inline void trace_event(uint16_t id, uint16_t arg)
+{
+    uint32_t idx, cyc;
+
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3) && defined(DWT_BASE)
+    do {
+        idx = __LDREXW(&trace_wr);
+        cyc = TRACE_CYCLES();
+    } while (__STREXW(idx + 1, &trace_wr));
+#else
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    idx = trace_wr;
+    cyc = TRACE_CYCLES();
+    trace_wr = idx + 1;
+    __set_PRIMASK(primask);
+#endif
+
+    trace_rec_t *r = &trace_buf[idx & (TRACE_BUF_RECORDS - 1)];
+    r->cycles = cyc;
+    r->id = id;
+    r->arg = arg;
+}
+
+#define TRACE_INSTANT(track, evt, arg)  trace_event(TRACE_ID(TRACE_KIND_INSTANT, track, evt), (uint16_t)(arg))
+#define TRACE_BEGIN(track, evt, arg)    trace_event(TRACE_ID(TRACE_KIND_BEGIN, track, evt), (uint16_t)(arg))
+#define TRACE_END(track, evt, arg)      trace_event(TRACE_ID(TRACE_KIND_END, track, evt), (uint16_t)(arg))
+#define TRACE_COUNTER(track, evt, val)  trace_event(TRACE_ID(TRACE_KIND_COUNTER, track, evt), (uint16_t)(val))
+
+/* 中断进出：放在 IRQHandler 的第一行和最后一行 */
+#define TRACE_ISR_ENTER(irqn)           TRACE_BEGIN(TRACE_TRACK_ISR, (irqn), 0)
+#define TRACE_ISR_EXIT(irqn)            TRACE_END(TRACE_TRACK_ISR, (irqn), 0)
+
+#else
+
+#define trace_init()                    ((void)0)
+#define trace_drain()                   (0u)
+#define trace_dropped()                 (0u)
+#define TRACE_INSTANT(track, evt, arg)  ((void)0)
+#define TRACE_BEGIN(track, evt, arg)    ((void)0)
+#define TRACE_END(track, evt, arg)      ((void)0)
+#define TRACE_COUNTER(track, evt, val)  ((void)0)
+#define TRACE_ISR_ENTER(irqn)           ((void)0)
+#define TRACE_ISR_EXIT(irqn)            ((void)0)
+
+#endif /* TRACE_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DWT_TRACE_H__ */
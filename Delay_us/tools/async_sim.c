@@ -0,0 +1,283 @@
+/**
+ * @file async_sim.c
+ * @brief 主机端工具：在模拟时钟上校验 delay_async 的最小堆调度与 delay_block_us
+ * @note  纯 C99，直接链接 MCU 端的 delay_async.c，HAL 换成 host/ 下的替身。用法:
+ *          gcc -O2 -Ihost -I.. -o async_sim async_sim.c ../delay_async.c
+ *          gcc -O2 -Ihost -I.. -DDELAY_ASYNC_TIM_BITS=16 -o async_sim16 async_sim.c ../delay_async.c
+ *          ./async_sim [轮数]
+ *        模拟时钟每步计数器 +1 (1 tick = 1us)，计数器等于 CCR 时置比较标志，
+ *        标志与中断使能同时成立就像 HAL_TIM_IRQHandler 一样清标志并调用 delay_async_irq_handler。
+ *        校验：每个回调恰好在截止时刻执行、按截止时间先后执行、队列满时拒绝；
+ *        计数器回绕、16 位定时器的长延时分段、回调里再注册、零延时补发事件；
+ *        delay_block_us 不被默认通知槽上的通知和同一下标上残留的通知提前唤醒。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "delay_async.h"
+
+#if DELAY_ASYNC_TIM_BITS >= 32
+#define SIM_MASK    0xFFFFFFFFu
+#else
+#define SIM_MASK    ((1u << DELAY_ASYNC_TIM_BITS) - 1u)
+#endif
+
+/* ================= 模拟硬件 ================= */
+
+uint32_t host_primask;
+uint32_t SystemCoreClock = 72000000u;
+
+static TIM_TypeDef sim_tim;
+TIM_HandleTypeDef htim2 = { &sim_tim, 0 };
+
+static uint64_t sim_time;       // 绝对时间 (us)，不回绕
+
+/**
+ * @brief 派发挂起的比较中断 (关中断期间不派发)
+ */
+static void sim_irq(void)
+{
+    while (!host_primask && (sim_tim.SR & sim_tim.DIER & TIM_IT_CC1)) {
+        sim_tim.SR &= ~TIM_FLAG_CC1;
+        delay_async_irq_handler();
+    }
+}
+
+static void sim_tick(void)
+{
+    sim_time++;
+    sim_tim.CNT = (sim_tim.CNT + 1u) & SIM_MASK;
+    if (sim_tim.CNT == sim_tim.CCR[0]) {
+        sim_tim.SR |= TIM_FLAG_CC1;
+    }
+    sim_irq();
+}
+
+static void sim_run(uint32_t us)
+{
+    while (us--) sim_tick();
+}
+
+static void sim_reset(uint32_t cnt)
+{
+    memset(&sim_tim, 0, sizeof(sim_tim));
+    sim_tim.CNT = cnt & SIM_MASK;
+    sim_time = 0;
+    delay_async_init();
+}
+
+/* ================= 单任务 FreeRTOS 替身 ================= */
+
+static uint32_t notify[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+static TaskHandle_t const sim_task = (TaskHandle_t)&notify;
+
+BaseType_t xTaskGetSchedulerState(void) { return taskSCHEDULER_RUNNING; }
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return sim_task; }
+
+uint32_t ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear, TickType_t wait)
+{
+    (void)wait;
+    while (notify[index] == 0) sim_tick();      // 任务挂起期间时间照走
+    uint32_t v = notify[index];
+    notify[index] = clear ? 0 : v - 1;
+    return v;
+}
+
+void vTaskNotifyGiveIndexedFromISR(TaskHandle_t task, UBaseType_t index, BaseType_t *woken)
+{
+    if (task == sim_task) notify[index]++;
+    *woken = pdTRUE;
+}
+
+/* delay_block_us 的退化路径 */
+void delay_us(uint32_t us) { sim_run(us); }
+void delay_smart_us(uint32_t us) { sim_run(us); }
+
+/* ================= 记录 ================= */
+
+#define MAX_EVENTS  4096
+
+typedef struct {
+    uint64_t due;       // 应该执行的绝对时间
+    uint64_t fired;     // 实际执行的绝对时间
+    int id;
+    int again;          // 回调里再注册的次数
+    uint32_t again_us;
+} sim_timer_t;
+
+static sim_timer_t timers[MAX_EVENTS];
+static int n_timers, n_fired, n_late, n_order;
+static uint64_t last_fired_due;
+
+static void sim_cb(void *arg)
+{
+    sim_timer_t *t = (sim_timer_t *)arg;
+
+    t->fired = sim_time;
+    n_fired++;
+    if (t->fired != t->due) n_late++;
+    if (t->due < last_fired_due) n_order++;
+    last_fired_due = t->due;
+
+    if (t->again > 0 && n_timers < MAX_EVENTS) {
+        sim_timer_t *n = &timers[n_timers++];
+        *n = *t;
+        n->again--;
+        n->due = sim_time + t->again_us;
+        n->fired = 0;
+        if (delay_async_us(t->again_us, sim_cb, n) != 0) n_timers--;
+    }
+}
+
+static int add_timer(uint32_t us, int again, uint32_t again_us)
+{
+    sim_timer_t *t = &timers[n_timers];
+    t->due = sim_time + us;
+    t->fired = 0;
+    t->id = n_timers;
+    t->again = again;
+    t->again_us = again_us;
+    if (delay_async_us(us, sim_cb, t) != 0) return -1;
+    n_timers++;
+    sim_irq();      // 零延时会立即补发比较事件
+    return 0;
+}
+
+static void clear_log(void)
+{
+    n_timers = n_fired = n_late = n_order = 0;
+    last_fired_due = 0;
+}
+
+static int report(const char *what)
+{
+    int missing = n_timers - n_fired;
+    int bad = missing || n_late || n_order;
+    printf("%-34s %s (%d timers, %d late, %d out of order, %d missing)\n", what,
+           bad ? "FAIL" : "ok", n_timers, n_late, n_order, missing);
+    return bad;
+}
+
+/* ================= 用例 ================= */
+
+/**
+ * @brief 随机截止时间：填满队列，边执行边补充，计数器从回绕点附近开始
+ */
+static int test_random(int rounds, uint32_t max_us)
+{
+    clear_log();
+    sim_reset(SIM_MASK - 3000u);
+
+    for (int r = 0; r < rounds; r++) {
+        int want = 1 + rand() % DELAY_ASYNC_MAX_TIMERS;
+        for (int k = 0; k < want && n_timers < MAX_EVENTS - 64; k++) {
+            if (add_timer((uint32_t)rand() % max_us, 0, 0) != 0) break;
+        }
+        sim_run((uint32_t)rand() % max_us);
+    }
+    sim_run(max_us + 1);
+    return report("random deadlines");
+}
+
+static int test_full(void)
+{
+    int bad = 0, refused;
+
+    clear_log();
+    sim_reset(0);
+    for (int i = 0; i < DELAY_ASYNC_MAX_TIMERS; i++) {
+        bad |= add_timer(100u + (uint32_t)i, 0, 0) != 0;
+    }
+    refused = add_timer(50, 0, 0) != 0;
+    sim_run(200);
+    bad |= report("queue full");
+    if (!refused) {
+        printf("  request beyond DELAY_ASYNC_MAX_TIMERS was accepted\n");
+        bad = 1;
+    }
+    return bad;
+}
+
+/**
+ * @brief 回调里再注册 (包括零延时)，以及超过半个计数周期的长延时
+ */
+static int test_chain(void)
+{
+    int bad = 0;
+
+    clear_log();
+    sim_reset(SIM_MASK - 10u);
+    add_timer(0, 20, 0);                        // 零延时链：每次回调立即再挂一个零延时
+    add_timer(5, 50, 37);
+    sim_run(5000u);
+    bad |= report("chained deadlines");
+
+#if DELAY_ASYNC_TIM_BITS < 32
+    clear_log();
+    sim_reset(0xFFF0u);
+    add_timer(250000u, 0, 0);                   // 约 3.8 圈，要先比较到中间点
+    add_timer(131072u, 0, 0);                   // 恰好两圈
+    add_timer(1, 3, 65536u);                    // 整圈间隔，CCR 与上一次相同
+    sim_run(260000u);
+    bad |= report("16-bit multi-wrap deadlines");
+#endif
+    return bad;
+}
+
+static void stray_give(void *arg)
+{
+    BaseType_t woken;
+    vTaskNotifyGiveIndexedFromISR(sim_task, (UBaseType_t)(uintptr_t)arg, &woken);
+}
+
+/**
+ * @brief delay_block_us 等满整段时间：期间有发到 0 号槽的通知，开始前同一下标上还残留一个通知
+ */
+static int test_block(void)
+{
+    const uint32_t us = 500;
+    int bad = 0;
+
+    sim_reset(SIM_MASK - 100u);
+    memset(notify, 0, sizeof(notify));
+
+    uint64_t t0 = sim_time;
+    delay_async_us(us / 2, stray_give, (void *)(uintptr_t)0);
+    notify[DELAY_ASYNC_NOTIFY_INDEX] = 1;
+    delay_block_us(us);
+    uint64_t took = sim_time - t0;
+
+    bad = took != us;
+    printf("%-34s %s (waited %llu us of %u, default slot holds %u)\n", "delay_block_us vs stray notify",
+           bad ? "FAIL" : "ok", (unsigned long long)took, (unsigned)us, (unsigned)notify[0]);
+
+    // 提前唤醒的旧定时器在下一次等待中途送来的通知也不能截断它
+    t0 = sim_time;
+    delay_async_us(us / 3, stray_give, (void *)(uintptr_t)DELAY_ASYNC_NOTIFY_INDEX);
+    delay_block_us(us);
+    took = sim_time - t0;
+    printf("%-34s %s (waited %llu us of %u)\n", "delay_block_us vs late give",
+           took != us ? "FAIL" : "ok", (unsigned long long)took, (unsigned)us);
+    bad |= took != us;
+
+    sim_run(us);
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = argc > 1 ? atoi(argv[1]) : 2000;
+    int bad = 0;
+
+    printf("delay_async on a %d-bit timer, %d heap slots\n", DELAY_ASYNC_TIM_BITS, DELAY_ASYNC_MAX_TIMERS);
+    srand(1);
+    bad |= test_random(rounds, 3000u);
+#if DELAY_ASYNC_TIM_BITS < 32
+    bad |= test_random(rounds / 20 + 1, 90000u);    // 16 位：单个延时跨过整圈
+#endif
+    bad |= test_full();
+    bad |= test_chain();
+    bad |= test_block();
+    return bad ? 1 : 0;
+}
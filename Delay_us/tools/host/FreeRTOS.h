@@ -0,0 +1,22 @@
+/**
+ * @file FreeRTOS.h
+ * @brief 主机端替身：单任务模型，只有 delay_async / dht_capture 用到的类型与配置
+ */
+
+#ifndef __HOST_FREERTOS_H__
+#define __HOST_FREERTOS_H__
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define portMAX_DELAY           0xFFFFFFFFu
+#define portYIELD_FROM_ISR(x)   ((void)(x))
+
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2
+
+#endif /* __HOST_FREERTOS_H__ */
@@ -0,0 +1,72 @@
+/**
+ * @file main.h
+ * @brief 主机端替身：只提供 delay_async / delay_us.h 用到的 HAL 与 CMSIS 接口
+ * @note  定时器是一组普通变量，由测试程序的模拟时钟推进；关中断只是记录 PRIMASK，
+ *        中断由模拟时钟在主流程里同步派发，不会真的打断临界区。
+ */
+
+#ifndef __HOST_MAIN_H__
+#define __HOST_MAIN_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+/* ================= 内核 ================= */
+
+extern uint32_t host_primask;
+
+static inline uint32_t __get_PRIMASK(void) { return host_primask; }
+static inline void __set_PRIMASK(uint32_t v) { host_primask = v; }
+static inline void __disable_irq(void) { host_primask = 1; }
+static inline void __enable_irq(void) { host_primask = 0; }
+
+extern uint32_t SystemCoreClock;
+
+/* ================= 定时器 ================= */
+
+typedef struct {
+    __IO uint32_t CR1, DIER, SR, EGR, CNT, ARR;
+    __IO uint32_t CCR[4];
+} TIM_TypeDef;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+    uint32_t Channel;
+} TIM_HandleTypeDef;
+
+/* 与 HAL 相同的取值：通道号 = CCR 下标 * 4，CCx 的中断/标志/事件位一致 */
+#define TIM_CHANNEL_1           0x0u
+#define TIM_CHANNEL_2           0x4u
+#define TIM_CHANNEL_3           0x8u
+#define TIM_CHANNEL_4           0xCu
+#define TIM_IT_CC1              (1u << 1)
+#define TIM_IT_CC2              (1u << 2)
+#define TIM_FLAG_CC1            (1u << 1)
+#define TIM_FLAG_CC2            (1u << 2)
+#define TIM_EVENTSOURCE_CC1     (1u << 1)
+#define TIM_EVENTSOURCE_CC2     (1u << 2)
+
+#define __HAL_TIM_GET_COUNTER(h)            ((h)->Instance->CNT)
+#define __HAL_TIM_SET_COMPARE(h, ch, v)     ((h)->Instance->CCR[(ch) >> 2] = (v))
+#define __HAL_TIM_CLEAR_FLAG(h, f)          ((h)->Instance->SR &= ~(uint32_t)(f))
+#define __HAL_TIM_ENABLE_IT(h, it)          ((h)->Instance->DIER |= (it))
+#define __HAL_TIM_DISABLE_IT(h, it)         ((h)->Instance->DIER &= ~(uint32_t)(it))
+
+static inline HAL_StatusTypeDef HAL_TIM_GenerateEvent(TIM_HandleTypeDef *h, uint32_t ev)
+{
+    h->Instance->SR |= ev;
+    return HAL_OK;
+}
+
+static inline HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *h, uint32_t ch)
+{
+    h->Instance->DIER |= 2u << (ch >> 2);
+    h->Instance->CR1 |= 1u;
+    return HAL_OK;
+}
+
+#endif /* __HOST_MAIN_H__ */
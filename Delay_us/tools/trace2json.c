@@ -0,0 +1,206 @@
+/**
+ * @file trace2json.c
+ * @brief 主机端工具：把 dwt_trace 的遥测帧转换成 Chrome trace JSON
+ * @note  纯 C99，复用 dma_fifo_print/tools/telem_host.c 解析 COBS 帧。用法:
+ *          gcc -O2 -I../../dma_fifo_print/tools -o trace2json trace2json.c ../../dma_fifo_print/tools/telem_host.c
+ *          stty -F /dev/ttyUSB0 921600 raw && timeout 5 cat /dev/ttyUSB0 > trace.bin
+ *          ./trace2json [-n names.txt] < trace.bin > trace.json
+ *        trace.json 用 chrome://tracing 或 https://ui.perfetto.dev 打开。
+ *        文本日志原样输出到 stderr。
+ *
+ *        names.txt 每行一个 "轨道 事件号 名称"，例如:
+ *          8 1 imu_read
+ *          8 2 pid_loop
+ *        也可以写 "轨道 * 名称" 给整条轨道命名。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "telem_host.h"
+
+#define TRACE_FRAME_TYPE    0x7E
+#define MAX_TRACKS          64
+
+typedef struct {
+    char *evt_name[MAX_TRACKS][256];
+    char *track_name[MAX_TRACKS];
+    uint8_t track_used[MAX_TRACKS];
+
+    uint64_t cycles;        // 展开到 64 位的时间戳
+    uint32_t last_cyc;
+    int have_time;
+    uint32_t core_hz;
+    uint32_t lost;
+    int first_event;
+    unsigned long records;
+} trace_ctx_t;
+
+static const char *default_track_name(unsigned track)
+{
+    switch (track) {
+    case 0: return "ISR";
+    case 1: return "Tasks";
+    case 2: return "OLED";
+    case 3: return "DMA print";
+    default: return NULL;
+    }
+}
+
+static void event_name(const trace_ctx_t *t, unsigned track, unsigned evt, char *out, size_t size)
+{
+    if (t->evt_name[track][evt]) {
+        snprintf(out, size, "%s", t->evt_name[track][evt]);
+        return;
+    }
+    switch (track) {
+    case 0: snprintf(out, size, "IRQ %u", evt); return;
+    case 1: snprintf(out, size, "task %u", evt); return;
+    case 2: snprintf(out, size, "%s", evt == 1 ? "oled_write" : evt == 2 ? "oled_cmd" : "oled"); return;
+    case 3: snprintf(out, size, "%s", evt == 1 ? "dma_tx" : "dma"); return;
+    default: snprintf(out, size, "evt %u.%u", track, evt); return;
+    }
+}
+
+static void emit_sep(trace_ctx_t *t)
+{
+    printf(t->first_event ? "\n  " : ",\n  ");
+    t->first_event = 0;
+}
+
+static void on_record(trace_ctx_t *t, uint32_t cyc, uint16_t id, uint16_t arg)
+{
+    static const char phase[4] = { 'i', 'B', 'E', 'C' };
+    unsigned kind = id >> 14;
+    unsigned track = (id >> 8) & 0x3F;
+    unsigned evt = id & 0xFF;
+    char name[64];
+
+    /* 32 位周期计数展开：相邻记录间隔远小于一次回绕；偶尔的小幅倒退 (中断嵌套) 按负数处理 */
+    if (!t->have_time) {
+        t->cycles = 0;
+        t->have_time = 1;
+    } else {
+        int32_t delta = (int32_t)(cyc - t->last_cyc);
+        t->cycles += (int64_t)delta;
+    }
+    t->last_cyc = cyc;
+
+    double us = (double)t->cycles * 1e6 / (double)(t->core_hz ? t->core_hz : 1);
+    event_name(t, track, evt, name, sizeof(name));
+    t->track_used[track] = 1;
+    t->records++;
+
+    emit_sep(t);
+    if (kind == 3) {
+        printf("{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%u}}",
+               name, us, track, arg);
+    } else if (kind == 0) {
+        printf("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%u}}",
+               name, us, track, arg);
+    } else {
+        printf("{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%u}}",
+               name, phase[kind], us, track, arg);
+    }
+}
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void on_frame(void *ctx, uint8_t type, const uint8_t *payload, uint16_t len)
+{
+    trace_ctx_t *t = (trace_ctx_t *)ctx;
+
+    if (type != TRACE_FRAME_TYPE || len < 8 || (len - 8) % 8 != 0) {
+        return;
+    }
+
+    t->core_hz = rd32(payload);
+    uint32_t lost = rd32(payload + 4);
+    if (lost != t->lost) {
+        fprintf(stderr, "trace2json: %u records lost on target (buffer overrun)\n", lost - t->lost);
+        t->lost = lost;
+    }
+
+    for (uint16_t i = 8; i < len; i += 8) {
+        on_record(t, rd32(payload + i),
+                  (uint16_t)(payload[i + 4] | (payload[i + 5] << 8)),
+                  (uint16_t)(payload[i + 6] | (payload[i + 7] << 8)));
+    }
+}
+
+static void on_text(void *ctx, const char *text, size_t len)
+{
+    (void)ctx;
+    fwrite(text, 1, len, stderr);
+}
+
+static int load_names(trace_ctx_t *t, const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[256], evt[16], name[128];
+    unsigned track;
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || sscanf(line, "%u %15s %127s", &track, evt, name) != 3 || track >= MAX_TRACKS) {
+            continue;
+        }
+        char *dup = malloc(strlen(name) + 1);
+        if (!dup) break;
+        strcpy(dup, name);
+        if (strcmp(evt, "*") == 0) {
+            t->track_name[track] = dup;
+        } else {
+            t->evt_name[track][strtoul(evt, NULL, 0) & 0xFF] = dup;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static trace_ctx_t t;
+    telem_parser_t parser;
+    uint8_t buf[4096];
+    size_t n;
+
+    if (argc == 3 && strcmp(argv[1], "-n") == 0) {
+        if (load_names(&t, argv[2]) != 0) return 1;
+    } else if (argc != 1) {
+        fprintf(stderr, "usage: %s [-n names.txt] < trace.bin > trace.json\n", argv[0]);
+        return 1;
+    }
+
+    t.first_event = 1;
+    telem_parser_init(&parser, on_frame, on_text, &t);
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    while ((n = fread(buf, 1, sizeof(buf), stdin)) > 0) {
+        telem_parser_feed(&parser, buf, n);
+    }
+    telem_parser_finish(&parser);
+
+    /* 轨道名称 (元数据事件) */
+    for (unsigned track = 0; track < MAX_TRACKS; track++) {
+        const char *name = t.track_name[track] ? t.track_name[track] : default_track_name(track);
+        if (!t.track_used[track]) continue;
+        emit_sep(&t);
+        if (name) {
+            printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", track, name);
+        } else {
+            printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"track %u\"}}", track, track);
+        }
+    }
+    printf("\n]}\n");
+
+    fprintf(stderr, "trace2json: %lu records, %lu frames, %lu bad frames\n",
+            t.records, (unsigned long)parser.frames_ok, (unsigned long)parser.crc_errors);
+    return 0;
+}
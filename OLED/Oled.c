@@ -3,20 +3,73 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#if OLED_USE_FAST_FMT
+#include "fast_fmt.h"
+#endif
+#if defined(USE_DWT_TRACE)
+#include "dwt_trace.h"
+#endif
+#if defined(USE_DRV_STATS)
+#include "drv_stats.h"
+#endif
+#if OLED_USE_IMAGE
+#include "oled_image.h"
+#endif
+#if OLED_USE_SCALE
+#include "oled_scale.h"
+#endif
 
 // SSD1306 Control Bytes
 #define OLED_CMD_MODE  0x00
 #define OLED_DATA_MODE 0x40
 
+#if defined(USE_DRV_STATS)
+static OLED_Stats_t oled_stats;
+
+/**
+ * @brief  记一次 I2C 事务：len 为负载长度，t0 为开始时的周期计数
+ * @note   OLED 只在一个上下文里绘制，计数器不加锁
+ */
+static inline void OLED_StatXfer(uint32_t t0, uint16_t len)
+{
+    oled_stats.xfers++;
+    oled_stats.bytes += 2u + len;
+    oled_stats.busy_cycles += DRV_STATS_CYCLES() - t0;
+}
+#define OLED_STAT_BEGIN()       uint32_t stat_t0 = DRV_STATS_CYCLES()
+#define OLED_STAT_END(len)      OLED_StatXfer(stat_t0, (len))
+#else
+#define OLED_STAT_BEGIN()       ((void)0)
+#define OLED_STAT_END(len)      ((void)0)
+#endif
+
 /**
- * @brief  内部使用的写命令函数 (优化版)
- * @note   利用 HAL_I2C_Mem_Write 直接发送，减少总线 Start/Stop 开销
+ * @brief  一次事务连续发送多条命令
+ * @note   MemAddress = 0x00 (Co = 0, D/C# = 0)：后面的字节全部按命令解析，
+ *         初始化表、窗口设置都只需要一次 Start/Stop。
+ *         cmds 必须是静态数据 (总线调度模式下只记录指针)
  */
-static void OLED_WriteCommand(uint8_t cmd)
+static void OLED_WriteCommands(const uint8_t *cmds, uint16_t len)
 {
-    // MemAddress = 0x00，表示写入的是命令
-    HAL_I2C_Mem_Write(OLED_I2C_HANDLE, OLED_I2C_ADDR, OLED_CMD_MODE, 
-                      I2C_MEMADD_SIZE_8BIT, &cmd, 1, 10);
+#if defined(USE_DWT_TRACE)
+    TRACE_BEGIN(TRACE_TRACK_OLED, TRACE_EVT_OLED_CMD, cmds[0]);
+#endif
+    OLED_STAT_BEGIN();
+#if OLED_USE_I2C_SCHED
+    // 同一优先级先进先出，后续数据不会抢到命令前面
+    uint32_t start = HAL_GetTick();
+    while (i2c_sched_mem_write(OLED_I2C_BUS, OLED_I2C_PRIO, OLED_I2C_ADDR, OLED_CMD_MODE,
+                               cmds, len, 0, NULL, NULL) != 0) {
+        if (HAL_GetTick() - start > 10) break;  // 队列一直满：丢弃，与阻塞版超时行为一致
+    }
+#else
+    HAL_I2C_Mem_Write(OLED_I2C_HANDLE, OLED_I2C_ADDR, OLED_CMD_MODE,
+                      I2C_MEMADD_SIZE_8BIT, (uint8_t *)cmds, len, 10);
+#endif
+    OLED_STAT_END(len);
+#if defined(USE_DWT_TRACE)
+    TRACE_END(TRACE_TRACK_OLED, TRACE_EVT_OLED_CMD, len);
+#endif
 }
 
 /**
@@ -28,14 +81,44 @@ static void OLED_WriteData(const uint8_t *data, uint16_t len)
     // MemAddress = 0x40，表示写入的是数据 (GDDRAM)
     // 我们可以直接把 Flash 里的字模指针传进来，HAL 库会直接读 Flash 发送
     // 效率极大提升，且不会爆栈
+#if defined(USE_DWT_TRACE)
+    TRACE_BEGIN(TRACE_TRACK_OLED, TRACE_EVT_OLED_WRITE, len);
+#endif
+    OLED_STAT_BEGIN();
+#if OLED_USE_I2C_SCHED
+    // 分段提交给总线调度器：每段之间高优先级的传感器读取可以插队。
+    // data 可能在调用者栈上 (刷屏条带、解码缓冲)，所以这里等到传完再返回；
+    // 等待期间 CPU 仍然只是在等，但总线不再被 OLED 独占
+    volatile int st = I2C_SCHED_PENDING;
+    uint32_t start = HAL_GetTick();
+    int queued = 1;
+    while (i2c_sched_mem_write(OLED_I2C_BUS, OLED_I2C_PRIO, OLED_I2C_ADDR, OLED_DATA_MODE,
+                               data, len, OLED_I2C_CHUNK, i2c_sched_sync_cb, (void *)&st) != 0) {
+        if (HAL_GetTick() - start > 100) {
+            queued = 0;     // 队列一直满：丢弃这次写入
+            break;
+        }
+    }
+    if (queued && i2c_sched_sync_wait(&st, 100) == I2C_SCHED_TIMEOUT &&
+        i2c_sched_cancel(OLED_I2C_BUS, i2c_sched_sync_cb, (void *)&st) != 0) {
+        // 超时撤销时恰好有一段在线上，DMA 还在读 data 和 st：等这一段结束
+        while (st == I2C_SCHED_PENDING) {
+        }
+    }
+#else
     HAL_I2C_Mem_Write(OLED_I2C_HANDLE, OLED_I2C_ADDR, OLED_DATA_MODE, 
                       I2C_MEMADD_SIZE_8BIT, (uint8_t *)data, len, 100);
+#endif
+    OLED_STAT_END(len);
+#if defined(USE_DWT_TRACE)
+    TRACE_END(TRACE_TRACK_OLED, TRACE_EVT_OLED_WRITE, len);
+#endif
 }
 
 /**
  * @brief  获取字模信息的查表函数 (补全了 12x24)
  */
-static void OLED_GetAsciiGlyph(char c, OLED_FontSize font, const uint8_t **glyph, uint8_t *width, uint8_t *pages)
+void OLED_GetAsciiGlyph(char c, OLED_FontSize font, const uint8_t **glyph, uint8_t *width, uint8_t *pages)
 {
     uint8_t idx = c - ' '; // 简单偏移，前提是已过滤不可见字符
     if (c < ' ' || c > '~') {
@@ -65,8 +148,9 @@ static void OLED_GetAsciiGlyph(char c, OLED_FontSize font, const uint8_t **glyph
  */
 void OLED_SetCursor(uint8_t x, uint8_t page)
 {
-    if (page > 7) page = 7;
-    if (x > 127) x = 127;
+    if (page > OLED_PANEL_MAX_PAGE) page = OLED_PANEL_MAX_PAGE;
+    if (x > OLED_PANEL_MAX_X) x = OLED_PANEL_MAX_X;
+    x += OLED_PANEL_COL_OFFSET;     // 可见区在 GDDRAM 中的起始列 (SH1106 = 2, 72x40 = 28)
 
     // 构造指令包：
     // [0] = Control Byte (0x00) -> 告诉 SSD1306 后面全是命令
@@ -80,51 +164,111 @@ void OLED_SetCursor(uint8_t x, uint8_t page)
     cmds[3] = 0x10 | ((x >> 4) & 0x0F);
 
     // 使用 Master_Transmit 一次性发出去
+    OLED_STAT_BEGIN();
+#if OLED_USE_I2C_SCHED
+    uint32_t start = HAL_GetTick();
+    while (i2c_sched_write(OLED_I2C_BUS, OLED_I2C_PRIO, OLED_I2C_ADDR, cmds, 4, NULL, NULL) != 0) {
+        if (HAL_GetTick() - start > 10) break;
+    }
+#else
     HAL_I2C_Master_Transmit(OLED_I2C_HANDLE, OLED_I2C_ADDR, cmds, 4, 10);
+#endif
+    OLED_STAT_END(3);
+}
+
+/**
+ * @brief 从 (x, page) 开始连续写一段 GDDRAM 数据
+ * @note  给显示列表等外部渲染器用：渲染好的一整条直接突发写出
+ */
+void OLED_WriteArea(uint8_t x, uint8_t page, const uint8_t *data, uint16_t len)
+{
+    OLED_SetCursor(x, page);
+    OLED_WriteData(data, len);
 }
 
 void OLED_Clear(void)
 {
-    uint8_t zero_buf[128] = {0}; // 栈上开128字节通常没问题，甚至可以更大
+    uint8_t zero_buf[OLED_PANEL_WIDTH] = {0}; // 栈上开一行 (最多 128 字节) 通常没问题
     // 某些低端单片机如果栈不够，可以改小分批刷，或者定义为 static
 
-    for (uint8_t i = 0; i < 8; i++) {
+#if OLED_PANEL_HADDR
+    // 水平寻址：窗口设一次，每行数据接着上一行写，省掉每页的光标命令
+    static const uint8_t frame_begin[] = { OLED_PANEL_FRAME_BEGIN };
+    static const uint8_t frame_end[] = { OLED_PANEL_FRAME_END };
+    OLED_WriteCommands(frame_begin, sizeof(frame_begin));
+    for (uint8_t i = 0; i < OLED_PANEL_PAGES; i++) {
+        OLED_WriteData(zero_buf, OLED_PANEL_WIDTH);
+    }
+    OLED_WriteCommands(frame_end, sizeof(frame_end));
+#else
+    for (uint8_t i = 0; i < OLED_PANEL_PAGES; i++) {
         OLED_SetCursor(0, i);
-        // 一次刷一整行 (128字节)，利用 I2C 连续写入特性
-        OLED_WriteData(zero_buf, 128);
+        // 一次刷一整行，利用 I2C 连续写入特性
+        OLED_WriteData(zero_buf, OLED_PANEL_WIDTH);
     }
+#endif
 }
 
-void OLED_Init(void)
+/**
+ * @brief 整帧刷新
+ * @note  支持水平寻址的屏：设一次窗口，整帧 OLED_PANEL_FRAME_BYTES 字节一次突发；
+ *        SH1106：每页一次光标 + 一次整页突发，这是它能做到的最少事务数
+ */
+void OLED_WriteFrame(const uint8_t *fb)
 {
-    // 初始化序列建议紧凑发送，这里为了可读性保留原样，
-    // 实际生产中可以定义一个 const 数组一次性发完。
-    HAL_Delay(100); // 上电延时
-
-    OLED_WriteCommand(0xAE); // Display Off
-
-    OLED_WriteCommand(0xD5); OLED_WriteCommand(0x80); // Clock Divide
-    OLED_WriteCommand(0xA8); OLED_WriteCommand(0x3F); // Multiplex
-    OLED_WriteCommand(0xD3); OLED_WriteCommand(0x00); // Offset
-    OLED_WriteCommand(0x40);                          // Start Line
+#if defined(USE_DRV_STATS)
+    uint32_t frame_t0 = DRV_STATS_CYCLES();
+#endif
+#if OLED_PANEL_HADDR
+    static const uint8_t frame_begin[] = { OLED_PANEL_FRAME_BEGIN };
+    static const uint8_t frame_end[] = { OLED_PANEL_FRAME_END };
+    OLED_WriteCommands(frame_begin, sizeof(frame_begin));
+    OLED_WriteData(fb, OLED_PANEL_FRAME_BYTES);
+    OLED_WriteCommands(frame_end, sizeof(frame_end));
+#else
+    for (uint8_t i = 0; i < OLED_PANEL_PAGES; i++) {
+        OLED_WriteArea(0, i, fb + i * OLED_PANEL_WIDTH, OLED_PANEL_WIDTH);
+    }
+#endif
+#if defined(USE_DRV_STATS)
+    uint32_t frame_cycles = DRV_STATS_CYCLES() - frame_t0;
+    oled_stats.frames++;
+    oled_stats.frame_last = frame_cycles;
+    if (frame_cycles > oled_stats.frame_max) oled_stats.frame_max = frame_cycles;
+#endif
+}
 
-    OLED_WriteCommand(0x8D); OLED_WriteCommand(0x14); // Charge Pump (重要!)
+#if defined(USE_DRV_STATS)
+void OLED_GetStats(OLED_Stats_t *out)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out = oled_stats;
+    __set_PRIMASK(primask);
+}
 
-    OLED_WriteCommand(0x20); OLED_WriteCommand(0x02); // Page Addressing Mode (0x02更稳健)
-    
-    OLED_WriteCommand(0xA1); // Segment Remap
-    OLED_WriteCommand(0xC8); // COM Scan Direction
+void OLED_ResetStats(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(&oled_stats, 0, sizeof(oled_stats));
+    __set_PRIMASK(primask);
+}
+#endif
 
-    OLED_WriteCommand(0xDA); OLED_WriteCommand(0x12); // COM Pins
-    OLED_WriteCommand(0x81); OLED_WriteCommand(0xCF); // Contrast
-    OLED_WriteCommand(0xD9); OLED_WriteCommand(0xF1); // Pre-charge
-    OLED_WriteCommand(0xDB); OLED_WriteCommand(0x40); // VCOM Detect
+void OLED_Init(void)
+{
+    // 初始化序列来自 oled_panel.h，按型号在编译期选定
+    static const uint8_t init_cmds[] = { OLED_PANEL_INIT };
 
-    OLED_WriteCommand(0xA4); // Resume to RAM
-    OLED_WriteCommand(0xA6); // Normal Display
-    OLED_WriteCommand(0xAF); // Display On
+    // 上电等待按截止时刻算：之前的初始化已经用掉的时间不用再等
+    while (HAL_GetTick() < OLED_PANEL_POWERUP_MS) {
+    }
 
+    // 整张表一次事务发完；最后的 Display On 留到清屏之后，上电时 GDDRAM 里的随机花屏不会闪出来
+    OLED_WriteCommands(init_cmds, sizeof(init_cmds) - 1);
     OLED_Clear();
+    OLED_WriteCommands(&init_cmds[sizeof(init_cmds) - 1], 1);
 }
 
 /**
@@ -140,8 +284,8 @@ void OLED_ShowChar(uint8_t x, uint8_t page, char c, OLED_FontSize font)
     if (!glyph) return;
 
     // 2. 越界保护
-    if (x + width > 128) return;
-    if (page + pages > 8) return;
+    if (x + width > OLED_PANEL_WIDTH) return;
+    if (page + pages > OLED_PANEL_PAGES) return;
 
     // 3. 分页绘制
     for (uint8_t p = 0; p < pages; p++) {
@@ -153,50 +297,162 @@ void OLED_ShowChar(uint8_t x, uint8_t page, char c, OLED_FontSize font)
     }
 }
 
+#if OLED_USE_IMAGE
 /**
- * @brief 显示字符串 (支持自动换行和 \n)
+ * @brief 显示压缩图片
+ * @note  每页只发一次光标，数据按 OLED_IMAGE_CHUNK 分段解码、分段发送，
+ *        RAM 只占一个分段；屏幕外的列直接按包跳过
  */
-void OLED_ShowString(uint8_t x, uint8_t page, const char *str, OLED_FontSize font)
+void OLED_DrawImage(uint8_t x, uint8_t page, const uint8_t *img)
 {
-    const uint8_t *dummy_glyph = NULL;
-    uint8_t char_w = 0, char_h_pages = 0;
-    
-    // 获取当前字体的高度和宽度信息 (假设等宽)
-    OLED_GetAsciiGlyph('A', font, &dummy_glyph, &char_w, &char_h_pages);
+    uint8_t chunk[OLED_IMAGE_CHUNK];
+    oled_img_dec_t dec;
+    uint8_t w = OLED_IMG_WIDTH(img);
+    uint8_t pages = OLED_IMG_PAGES(img);
 
-    while (*str) {
-        // [牛点] 处理换行符
-        if (*str == '\n') {
-            x = 0;
-            page += char_h_pages;
-            str++;
-            continue;
+    if (x > OLED_PANEL_MAX_X || page > OLED_PANEL_MAX_PAGE) return;
+    uint8_t vis_w = (x + w > OLED_PANEL_WIDTH) ? (uint8_t)(OLED_PANEL_WIDTH - x) : w;
+
+    oled_img_begin(&dec, img);
+    for (uint8_t p = 0; p < pages && page + p < OLED_PANEL_PAGES; p++) {
+        OLED_SetCursor(x, page + p);
+        for (uint8_t col = 0; col < vis_w; ) {
+            uint8_t n = (vis_w - col > OLED_IMAGE_CHUNK) ? OLED_IMAGE_CHUNK : (uint8_t)(vis_w - col);
+            oled_img_read(&dec, chunk, n);
+            OLED_WriteData(chunk, n);  // 页寻址模式下列地址自动递增，分段之间不用重设光标
+            col += n;
         }
+        oled_img_skip(&dec, (uint16_t)(w - vis_w));
+    }
+}
+#endif
 
-        // [牛点] 自动换行
-        if (x + char_w > 128) {
-            x = 0;
-            page += char_h_pages;
+#if OLED_USE_SCALE
+/**
+ * @brief 放大字符串
+ * @note  每个字符现场从 6x8 字模生成 (查表展开，无逐像素循环)，逐页直接写屏
+ */
+void OLED_ShowStringScaled(uint8_t x, uint8_t page, const char *str, uint8_t scale, uint8_t smooth)
+{
+    uint8_t buf[OLED_SCALE_BUF_LEN];
+    const uint8_t *glyph = NULL;
+    uint8_t width = 0, pages = 0;
+
+    while (*str) {
+        OLED_GetAsciiGlyph(*str++, OLED_FONT_6X8, &glyph, &width, &pages);
+        width = oled_scale_glyph(glyph, scale, smooth, buf);
+        pages = (uint8_t)(width / OLED_SCALE_SRC_W);
+        if (x + width > OLED_PANEL_WIDTH) break;
+
+        for (uint8_t p = 0; p < pages && page + p < OLED_PANEL_PAGES; p++) {
+            OLED_WriteArea(x, page + p, buf + p * width, width);
         }
+        x += width;
+    }
+}
+#endif
+
+/**
+ * @brief 文本光标：ShowString 和 Printf 共用的逐字符排版状态
+ */
+typedef struct {
+    uint8_t x;
+    uint8_t page;
+    OLED_FontSize font;
+    uint8_t char_w;
+    uint8_t char_h_pages;
+    uint8_t full;           // 已到达底部，后续字符全部丢弃
+} OLED_TextCursor;
+
+static void OLED_TextBegin(OLED_TextCursor *cur, uint8_t x, uint8_t page, OLED_FontSize font)
+{
+    const uint8_t *dummy_glyph = NULL;
 
-        // 底部越界检查
-        if (page + char_h_pages > 8) break;
+    cur->x = x;
+    cur->page = page;
+    cur->font = font;
+    cur->full = 0;
 
-        OLED_ShowChar(x, page, *str, font);
-        x += char_w;
-        str++;
+    // 获取当前字体的高度和宽度信息 (假设等宽)
+    OLED_GetAsciiGlyph('A', font, &dummy_glyph, &cur->char_w, &cur->char_h_pages);
+}
+
+/**
+ * @brief 排版并绘制一个字符 (处理 \n、自动换行和底部越界)
+ */
+static void OLED_TextPut(OLED_TextCursor *cur, char c)
+{
+    if (cur->full) return;
+
+    // [牛点] 处理换行符
+    if (c == '\n') {
+        cur->x = 0;
+        cur->page += cur->char_h_pages;
+        return;
     }
+
+    // [牛点] 自动换行
+    if (cur->x + cur->char_w > OLED_PANEL_WIDTH) {
+        cur->x = 0;
+        cur->page += cur->char_h_pages;
+    }
+
+    // 底部越界检查
+    if (cur->page + cur->char_h_pages > OLED_PANEL_PAGES) {
+        cur->full = 1;
+        return;
+    }
+
+    OLED_ShowChar(cur->x, cur->page, c, cur->font);
+    cur->x += cur->char_w;
 }
 
+/**
+ * @brief 显示字符串 (支持自动换行和 \n)
+ */
+void OLED_ShowString(uint8_t x, uint8_t page, const char *str, OLED_FontSize font)
+{
+    OLED_TextCursor cur;
+    OLED_TextBegin(&cur, x, page, font);
+
+    while (*str && !cur.full) {
+        OLED_TextPut(&cur, *str++);
+    }
+}
+
+#if OLED_USE_FAST_FMT
+/**
+ * @brief fast_fmt 的输出回调：格式化出来的字符直接进入字模管线
+ */
+static void OLED_PrintfSink(void *ctx, const char *s, uint16_t len)
+{
+    OLED_TextCursor *cur = (OLED_TextCursor *)ctx;
+    while (len-- && !cur->full) {
+        OLED_TextPut(cur, *s++);
+    }
+}
+#endif
+
 // 格式化打印函数
 void OLED_Printf(uint8_t x, uint8_t page, OLED_FontSize font, const char *format, ...)
 {
-    char str_buf[64]; // 缓冲区
     va_list args;
 
+#if OLED_USE_FAST_FMT
+    // 边格式化边绘制，不需要栈上的字符串缓冲区
+    OLED_TextCursor cur;
+    OLED_TextBegin(&cur, x, page, font);
+
+    va_start(args, format);
+    fmt_vformat(OLED_PrintfSink, &cur, format, args);
+    va_end(args);
+#else
+    char str_buf[64]; // 缓冲区
+
     va_start(args, format);
     vsnprintf(str_buf, sizeof(str_buf), format, args);
     va_end(args);
 
     OLED_ShowString(x, page, str_buf, font);
-}
+#endif
+}
\ No newline at end of file
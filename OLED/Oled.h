@@ -7,12 +7,44 @@ extern "C" {
 
 #include "main.h"
 #include "font.h"  // 包含字体定义
+#include "oled_panel.h"  // 屏幕型号 (分辨率/列偏移/初始化序列)
 /* --- 配置区 --- */
 // 定义使用的 I2C 句柄，外部引用
 extern I2C_HandleTypeDef hi2c1;
 #define OLED_I2C_HANDLE   &hi2c1
 #define OLED_I2C_ADDR     0x78  // 已经左移过的 8-bit 地址 (0x3C << 1)
 
+// Printf 使用 fast_fmt 直接把格式化结果送进字模管线 (无中间缓冲区、不链接 newlib 的 vsnprintf)
+// 需要把 fast_fmt/ 加入工程和头文件路径，且不支持 %e %g；默认 0 使用 vsnprintf + 栈缓冲区
+#ifndef OLED_USE_FAST_FMT
+#define OLED_USE_FAST_FMT 0
+#endif
+
+// 压缩图片支持 (oled_image 格式)：默认关闭，置 1 并把 oled_image.c 加入工程后启用
+#ifndef OLED_USE_IMAGE
+#define OLED_USE_IMAGE 0
+#endif
+#define OLED_IMAGE_CHUNK  32    // 边解码边发送的分段大小 (栈上)
+
+// 由 6x8 字库实时放大 2~4 倍的大字：默认关闭，置 1 并把 oled_scale.c 加入工程后启用，
+// 只用大号数字时可以不再链接 8x16/12x24 字库
+#ifndef OLED_USE_SCALE
+#define OLED_USE_SCALE 0
+#endif
+
+// 与传感器共用 I2C 时走 i2c_sched 总线调度器 (需要 i2c_sched.c，并先调用 i2c_sched_init)：
+// 显存数据按 OLED_I2C_CHUNK 分段，段与段之间让高优先级的传感器读取先走
+#ifndef OLED_USE_I2C_SCHED
+#define OLED_USE_I2C_SCHED 0
+#endif
+#if OLED_USE_I2C_SCHED
+#include "i2c_sched.h"
+extern i2c_bus_t i2c1_bus;
+#define OLED_I2C_BUS      (&i2c1_bus)
+#define OLED_I2C_PRIO     I2C_PRIO_LOW
+#define OLED_I2C_CHUNK    32    // 32 字节 @400kHz ≈ 0.8ms，即传感器最坏要等的时间
+#endif
+
 /* --- API --- */
 void OLED_Init(void);
 void OLED_Clear(void);
@@ -20,9 +52,41 @@ void OLED_SetCursor(uint8_t x, uint8_t page);
 void OLED_ShowChar(uint8_t x, uint8_t page, char c, OLED_FontSize font);
 void OLED_ShowString(uint8_t x, uint8_t page, const char *str, OLED_FontSize font);
 
+// 从 (x, page) 开始连续写 GDDRAM，供显示列表 (oled_dlist) 等渲染器使用
+void OLED_WriteArea(uint8_t x, uint8_t page, const uint8_t *data, uint16_t len);
+// 整帧刷新：fb 为 OLED_PANEL_FRAME_BYTES 字节的页格式帧缓冲；支持水平寻址的屏一次突发写完，SH1106 逐页写
+void OLED_WriteFrame(const uint8_t *fb);
+// 查 ASCII 字模 (非法字符替换为 '?')
+void OLED_GetAsciiGlyph(char c, OLED_FontSize font, const uint8_t **glyph, uint8_t *width, uint8_t *pages);
+
+#if OLED_USE_IMAGE
+// 显示压缩图片 (页对齐，超出屏幕的部分裁掉)，逐段解码直接写屏
+void OLED_DrawImage(uint8_t x, uint8_t page, const uint8_t *img);
+#endif
+
+#if OLED_USE_SCALE
+// 放大字符串：scale = 2~4 (字高 16/24/32)，smooth 非 0 时平滑斜边 (2x/4x)，到右边界截断
+void OLED_ShowStringScaled(uint8_t x, uint8_t page, const char *str, uint8_t scale, uint8_t smooth);
+#endif
+
 // [老张赠送] 像 printf 一样打印调试信息
 void OLED_Printf(uint8_t x, uint8_t page, OLED_FontSize font, const char *format, ...);
 
+#if defined(USE_DRV_STATS)
+// 运行统计 (全局定义 USE_DRV_STATS 后才累加)，周期数来自 DWT
+typedef struct {
+    uint32_t xfers;         // I2C 事务数
+    uint32_t bytes;         // 总线字节数 (地址 + 控制字节 + 负载)
+    uint64_t busy_cycles;   // CPU 等在 I2C 传输上的累计周期
+    uint32_t frames;        // 整帧刷新 (OLED_WriteFrame) 次数
+    uint32_t frame_last;    // 最近一次整帧刷新耗时 (周期)
+    uint32_t frame_max;     // 最长一次整帧刷新耗时 (周期)
+} OLED_Stats_t;
+
+void OLED_GetStats(OLED_Stats_t *out);
+void OLED_ResetStats(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
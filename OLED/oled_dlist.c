@@ -0,0 +1,599 @@
+/**
+ * @file oled_dlist.c
+ * @brief 显示列表记录与分条栅格化
+ */
+
+#include "oled_dlist.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#if OLED_USE_FAST_FMT
+#include "fast_fmt.h"
+#endif
+#if OLED_USE_IMAGE
+#include "oled_image.h"
+#endif
+#if OLED_USE_SCALE
+#include "oled_scale.h"
+#endif
+
+/* ================= 后端映射 ================= */
+
+#if OLED_DLIST_USE_SOFT
+#define DL_WRITE(x, page, data, len)    SoftOLED_WriteArea(x, page, data, len)
+#define DL_GLYPH(c, font, g, w, p)      SoftOLED_GetGlyph(c, font, g, w, p)
+#else
+#define DL_WRITE(x, page, data, len)    OLED_WriteArea(x, page, data, len)
+#define DL_GLYPH(c, font, g, w, p)      dl_hw_glyph(c, font, g, w, p)
+
+static inline uint8_t dl_hw_glyph(char c, OLED_FontSize font, const uint8_t **glyph, uint8_t *width, uint8_t *pages)
+{
+    OLED_GetAsciiGlyph(c, font, glyph, width, pages);   // 硬件版总能查到 (非法字符替换为 '?')
+    return 1;
+}
+#endif
+
+#if OLED_USE_SCALE
+static uint8_t dl_scaled[OLED_SCALE_BUF_LEN];   // 放大字模的生成缓冲 (一次一个字符)
+#endif
+
+/**
+ * @brief 查字模，放大字体现场生成
+ */
+static uint8_t dl_glyph(char c, uint8_t font, const uint8_t **glyph, uint8_t *width, uint8_t *pages)
+{
+#if OLED_USE_SCALE
+    if (font & OLED_DL_FONT_SCALE_FLAG) {
+        const uint8_t *src = NULL;
+        uint8_t w = 0, p = 0;
+
+        if (!DL_GLYPH(c, OLED_FONT_6X8, &src, &w, &p)) return 0;
+        *width = oled_scale_glyph(src, font & 0x07u, (font & 0x10u) != 0, dl_scaled);
+        *pages = (uint8_t)(*width / OLED_SCALE_SRC_W);
+        *glyph = dl_scaled;
+        return 1;
+    }
+#endif
+    return DL_GLYPH(c, (OLED_FontSize)font, glyph, width, pages);
+}
+
+/* * 命令格式：首字节 = 操作码 << 2 | 绘制模式，其后为参数
+ *   TEXT:   x y font len chars[len]
+ *   LINE:   x0 y0 x1 y1
+ *   RECT:   x y w h
+ *   FILL:   x y w h
+ *   BITMAP: x y w h ptr (按字节拷贝的指针)
+ *   PLOT:   x y w h head ptr
+ *   IMAGE:  x y ptr (oled_image 压缩图片，宽高在图片头里)
+ */
+enum {
+    DL_OP_TEXT = 1,
+    DL_OP_LINE,
+    DL_OP_RECT,
+    DL_OP_FILL,
+    DL_OP_BITMAP,
+    DL_OP_PLOT,
+    DL_OP_IMAGE,
+};
+
+#define DL_HDR(op, mode)    (uint8_t)(((op) << 2) | ((mode) & 0x03))
+#define DL_TEXT_HDR_LEN     5u
+#define DL_SHAPE_LEN        5u
+#define DL_BITMAP_LEN       (5u + sizeof(const uint8_t *))
+#define DL_PLOT_LEN         (6u + sizeof(const uint8_t *))
+#define DL_IMAGE_LEN        (3u + sizeof(const uint8_t *))
+
+static uint8_t dl_buf[OLED_DLIST_BYTES];
+static uint16_t dl_len = 0;
+static uint8_t dl_overflow = 0;
+static uint8_t dl_strip[OLED_DLIST_WIDTH];    // 唯一的条带缓冲区 (一页)
+
+#if OLED_DLIST_SKIP_UNCHANGED
+static uint32_t dl_page_hash[OLED_DLIST_HEIGHT / 8];
+static uint8_t dl_page_valid = 0;             // 每页一位：哈希与屏上内容一致
+#endif
+
+/**
+ * @brief 一次渲染的条带：第 top ~ top+7 行，列 [x0, x1)，buf[0] 对应 x0
+ */
+typedef struct {
+    uint8_t *buf;
+    int16_t top;
+    int16_t x0;
+    int16_t x1;
+} dl_strip_t;
+
+/* ================= 记录 ================= */
+
+static uint8_t *dl_alloc(uint16_t len)
+{
+    if (dl_len + len > OLED_DLIST_BYTES) {
+        dl_overflow = 1;
+        return NULL;
+    }
+    uint8_t *p = &dl_buf[dl_len];
+    dl_len += len;
+    return p;
+}
+
+static int dl_shape(uint8_t op, uint8_t a, uint8_t b, uint8_t c, uint8_t d, oled_dl_mode_t mode)
+{
+    uint8_t *p = dl_alloc(DL_SHAPE_LEN);
+    if (!p) return -1;
+
+    p[0] = DL_HDR(op, mode);
+    p[1] = a; p[2] = b; p[3] = c; p[4] = d;
+    return 0;
+}
+
+void oled_dl_begin(void)
+{
+    dl_len = 0;
+    dl_overflow = 0;
+}
+
+int oled_dl_text(uint8_t x, uint8_t y, OLED_FontSize font, oled_dl_mode_t mode, const char *str)
+{
+    size_t n = strlen(str);
+    if (n > 255) n = 255;
+
+    uint8_t *p = dl_alloc((uint16_t)(DL_TEXT_HDR_LEN + n));
+    if (!p) return -1;
+
+    p[0] = DL_HDR(DL_OP_TEXT, mode);
+    p[1] = x; p[2] = y; p[3] = (uint8_t)font; p[4] = (uint8_t)n;
+    memcpy(&p[DL_TEXT_HDR_LEN], str, n);
+    return 0;
+}
+
+#if OLED_USE_FAST_FMT
+/**
+ * @brief fast_fmt 输出回调：字符直接追加在 TEXT 命令后面，放不下的截断
+ */
+static void dl_printf_sink(void *ctx, const char *s, uint16_t len)
+{
+    uint8_t *hdr = (uint8_t *)ctx;
+    uint16_t room = OLED_DLIST_BYTES - dl_len;
+
+    if (len > room) len = room;
+    if (len > 255u - hdr[4]) len = 255u - hdr[4];
+    memcpy(&dl_buf[dl_len], s, len);
+    dl_len += len;
+    hdr[4] += (uint8_t)len;
+}
+#endif
+
+int oled_dl_printf(uint8_t x, uint8_t y, OLED_FontSize font, const char *format, ...)
+{
+    va_list args;
+
+#if OLED_USE_FAST_FMT
+    // 先占好命令头，格式化结果直接流进列表，不需要栈上的字符串缓冲区
+    uint8_t *p = dl_alloc(DL_TEXT_HDR_LEN);
+    if (!p) return -1;
+
+    p[0] = DL_HDR(DL_OP_TEXT, OLED_DL_SET);
+    p[1] = x; p[2] = y; p[3] = (uint8_t)font; p[4] = 0;
+
+    va_start(args, format);
+    int total = fmt_vformat(dl_printf_sink, p, format, args);
+    va_end(args);
+
+    if (total > p[4]) {
+        dl_overflow = 1;
+        return -1;
+    }
+    return 0;
+#else
+    char str_buf[64];
+
+    va_start(args, format);
+    vsnprintf(str_buf, sizeof(str_buf), format, args);
+    va_end(args);
+
+    return oled_dl_text(x, y, font, OLED_DL_SET, str_buf);
+#endif
+}
+
+int oled_dl_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, oled_dl_mode_t mode)
+{
+    return dl_shape(DL_OP_LINE, x0, y0, x1, y1, mode);
+}
+
+int oled_dl_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, oled_dl_mode_t mode)
+{
+    return dl_shape(DL_OP_RECT, x, y, w, h, mode);
+}
+
+int oled_dl_fill(uint8_t x, uint8_t y, uint8_t w, uint8_t h, oled_dl_mode_t mode)
+{
+    return dl_shape(DL_OP_FILL, x, y, w, h, mode);
+}
+
+int oled_dl_bitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bmp, oled_dl_mode_t mode)
+{
+    uint8_t *p = dl_alloc(DL_BITMAP_LEN);
+    if (!p) return -1;
+
+    p[0] = DL_HDR(DL_OP_BITMAP, mode);
+    p[1] = x; p[2] = y; p[3] = w; p[4] = h;
+    memcpy(&p[5], &bmp, sizeof(bmp));   // 列表按字节排布，指针可能不对齐
+    return 0;
+}
+
+int oled_dl_plot(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *samples, uint8_t head, oled_dl_mode_t mode)
+{
+    uint8_t *p = dl_alloc(DL_PLOT_LEN);
+    if (!p) return -1;
+
+    p[0] = DL_HDR(DL_OP_PLOT, mode);
+    p[1] = x; p[2] = y; p[3] = w; p[4] = h; p[5] = head;
+    memcpy(&p[6], &samples, sizeof(samples));
+    return 0;
+}
+
+#if OLED_USE_IMAGE
+int oled_dl_image(uint8_t x, uint8_t y, const uint8_t *img, oled_dl_mode_t mode)
+{
+    uint8_t *p = dl_alloc(DL_IMAGE_LEN);
+    if (!p) return -1;
+
+    p[0] = DL_HDR(DL_OP_IMAGE, mode);
+    p[1] = x; p[2] = y;
+    memcpy(&p[3], &img, sizeof(img));
+    return 0;
+}
+#endif
+
+void oled_dl_font_size(OLED_FontSize font, uint8_t *w, uint8_t *h)
+{
+    const uint8_t *glyph = NULL;
+    uint8_t pages = 0;
+
+    *w = 0;
+    if (!dl_glyph('A', (uint8_t)font, &glyph, w, &pages)) pages = 0;
+    *h = (uint8_t)(pages * 8);
+}
+
+uint16_t oled_dl_used(void)
+{
+    return dl_len;
+}
+
+uint8_t oled_dl_overflowed(void)
+{
+    return dl_overflow;
+}
+
+/* ================= 栅格化 ================= */
+
+/**
+ * @brief 行区间 [y, y+h) 落在条带内的部分，转成字节掩码
+ */
+static uint8_t dl_rows(int16_t y, int16_t h, int16_t top)
+{
+    int16_t a = y - top;
+    int16_t b = y + h - top;
+
+    if (a < 0) a = 0;
+    if (b > 8) b = 8;
+    if (a >= b) return 0;
+    return (uint8_t)((0xFFu << a) & (0xFFu >> (8 - b)));
+}
+
+static inline void dl_apply(uint8_t *dst, uint8_t bits, uint8_t mode)
+{
+    switch (mode) {
+    case OLED_DL_SET:   *dst |= bits; break;
+    case OLED_DL_CLEAR: *dst &= (uint8_t)~bits; break;
+    default:            *dst ^= bits; break;
+    }
+}
+
+/**
+ * @brief 从页格式的源图 (字模或位图) 中取出第 col 列、从第 dy 行起的 8 个像素
+ * @param dy 源图中的起始行，可为负 (源图顶端在条带内部)，范围 -63 ~ 63
+ */
+static inline uint8_t dl_src_byte(const uint8_t *src, uint8_t w, uint8_t pages, int16_t col, int16_t dy)
+{
+    int16_t k = (int16_t)(((dy + 64) >> 3) - 8);    // floor(dy / 8)
+    uint8_t sh = (uint8_t)((dy + 64) & 7);
+    uint16_t lo = (k >= 0 && k < pages) ? src[k * w + col] : 0;
+    uint16_t hi = (k + 1 >= 0 && k + 1 < pages) ? src[(k + 1) * w + col] : 0;
+
+    return (uint8_t)(((hi << 8) | lo) >> sh);
+}
+
+static void dl_draw_text(const dl_strip_t *s, const uint8_t *p)
+{
+    uint8_t mode = p[0] & 0x03;
+    uint8_t font = p[3];
+    const char *str = (const char *)&p[DL_TEXT_HDR_LEN];
+    const uint8_t *glyph = NULL;
+    uint8_t w = 0, pages = 0;
+
+    if (!dl_glyph('A', font, &glyph, &w, &pages)) return;
+
+    int16_t h = (int16_t)(pages * 8);
+    int16_t cx = p[1];
+    int16_t cy = p[2];
+
+    for (uint8_t i = 0; i < p[4]; i++) {
+        char c = str[i];
+
+        // 排版规则与 OLED_ShowString 一致：\n 和右边界都回到 x = 0
+        if (c == '\n') {
+            cx = 0;
+            cy += h;
+            continue;
+        }
+        if (cx + w > OLED_DLIST_WIDTH) {
+            cx = 0;
+            cy += h;
+        }
+        if (cy >= s->top + 8 || cy >= OLED_DLIST_HEIGHT) {
+            break;  // 排版只会往下走，后面的字符都不在这一条里
+        }
+
+        if (cy + h > s->top && cx < s->x1 && cx + w > s->x0) {
+            dl_glyph(c, font, &glyph, &w, &pages);
+
+            int16_t from = (cx > s->x0) ? cx : s->x0;
+            int16_t to = (cx + w < s->x1) ? (int16_t)(cx + w) : s->x1;
+            for (int16_t col = from; col < to; col++) {
+                uint8_t bits = dl_src_byte(glyph, w, pages, col - cx, (int16_t)(s->top - cy));
+                dl_apply(&s->buf[col - s->x0], bits, mode);
+            }
+        }
+        cx += w;
+    }
+}
+
+static void dl_draw_line(const dl_strip_t *s, const uint8_t *p)
+{
+    uint8_t mode = p[0] & 0x03;
+    int16_t x0 = p[1], y0 = p[2], x1 = p[3], y1 = p[4];
+
+    // 整条线都不经过这一条就不用走 Bresenham
+    if ((y0 < s->top && y1 < s->top) || (y0 >= s->top + 8 && y1 >= s->top + 8)) {
+        return;
+    }
+
+    int16_t dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
+    int16_t dy = (y1 > y0) ? (y0 - y1) : (y1 - y0);   // 取负
+    int16_t sx = (x0 < x1) ? 1 : -1;
+    int16_t sy = (y0 < y1) ? 1 : -1;
+    int16_t err = dx + dy;
+
+    for (;;) {
+        if (y0 >= s->top && y0 < s->top + 8 && x0 >= s->x0 && x0 < s->x1) {
+            dl_apply(&s->buf[x0 - s->x0], (uint8_t)(1u << (y0 - s->top)), mode);
+        }
+        if (x0 == x1 && y0 == y1) break;
+
+        int16_t e2 = (int16_t)(2 * err);
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+static void dl_draw_rect(const dl_strip_t *s, const uint8_t *p, uint8_t fill)
+{
+    uint8_t mode = p[0] & 0x03;
+    int16_t x = p[1], y = p[2], w = p[3], h = p[4];
+
+    uint8_t body = dl_rows(y, h, s->top);
+    if (!body || w == 0) return;
+
+    // 边框：左右两列整列，中间各列只有上下两条边；每列只 apply 一次，XOR 时角点不会被抵消
+    uint8_t edges = fill ? body : (uint8_t)(dl_rows(y, 1, s->top) | dl_rows(y + h - 1, 1, s->top));
+
+    int16_t from = (x > s->x0) ? x : s->x0;
+    int16_t to = (x + w < s->x1) ? (int16_t)(x + w) : s->x1;
+    for (int16_t col = from; col < to; col++) {
+        uint8_t bits = (col == x || col == x + w - 1) ? body : edges;
+        if (bits) dl_apply(&s->buf[col - s->x0], bits, mode);
+    }
+}
+
+static void dl_draw_bitmap(const dl_strip_t *s, const uint8_t *p)
+{
+    uint8_t mode = p[0] & 0x03;
+    int16_t x = p[1], y = p[2];
+    uint8_t w = p[3], h = p[4];
+    const uint8_t *bmp;
+
+    uint8_t rows = dl_rows(y, h, s->top);
+    if (!rows || w == 0) return;
+    memcpy(&bmp, &p[5], sizeof(bmp));
+
+    uint8_t pages = (uint8_t)((h + 7u) / 8u);
+    int16_t from = (x > s->x0) ? x : s->x0;
+    int16_t to = (x + w < s->x1) ? (int16_t)(x + w) : s->x1;
+    for (int16_t col = from; col < to; col++) {
+        // rows 同时裁掉最后一页里超出 h 的无效位
+        uint8_t bits = dl_src_byte(bmp, w, pages, col - x, (int16_t)(s->top - y)) & rows;
+        dl_apply(&s->buf[col - s->x0], bits, mode);
+    }
+}
+
+static void dl_draw_plot(const dl_strip_t *s, const uint8_t *p)
+{
+    uint8_t mode = p[0] & 0x03;
+    int16_t x = p[1], y = p[2];
+    uint8_t w = p[3], h = p[4], head = p[5];
+    const uint8_t *samples;
+
+    if (w == 0 || h == 0 || !dl_rows(y, h, s->top)) return;
+    memcpy(&samples, &p[6], sizeof(samples));
+
+    int16_t from = (x > s->x0) ? x : s->x0;
+    int16_t to = (x + w < s->x1) ? (int16_t)(x + w) : s->x1;
+    for (int16_t col = from; col < to; col++) {
+        uint8_t i = (uint8_t)(col - x);
+        uint8_t cur = samples[(uint16_t)(head + i) % w];
+        uint8_t prev = i ? samples[(uint16_t)(head + i - 1) % w] : cur;
+        if (cur >= h) cur = h - 1;
+        if (prev >= h) prev = h - 1;
+
+        // 每列画一段竖线连到上一个点，折线在陡峭处也是连续的
+        uint8_t lo = (cur < prev) ? cur : prev;
+        uint8_t hi = (cur < prev) ? prev : cur;
+        uint8_t bits = dl_rows((int16_t)(y + h - 1 - hi), (int16_t)(hi - lo + 1), s->top);
+        if (bits) dl_apply(&s->buf[col - s->x0], bits, mode);
+    }
+}
+
+#if OLED_USE_IMAGE
+/**
+ * @brief 压缩图片：两个解码器分别定位到条带上下跨越的两页，逐列边解码边合成
+ * @note  PackBits 不能随机访问，每条都从头按包跳过；跳过只走包头，开销与包数成正比
+ */
+static void dl_draw_image(const dl_strip_t *s, const uint8_t *p)
+{
+    uint8_t mode = p[0] & 0x03;
+    int16_t x = p[1], y = p[2];
+    const uint8_t *img;
+
+    memcpy(&img, &p[3], sizeof(img));
+    uint8_t w = OLED_IMG_WIDTH(img);
+    uint8_t pages = OLED_IMG_PAGES(img);
+
+    uint8_t rows = dl_rows(y, OLED_IMG_HEIGHT(img), s->top);
+    if (!rows || w == 0) return;
+
+    int16_t from = (x > s->x0) ? x : s->x0;
+    int16_t to = (x + w < s->x1) ? (int16_t)(x + w) : s->x1;
+    if (from >= to) return;
+
+    int16_t dy = (int16_t)(s->top - y);
+    int16_t k = (int16_t)(((dy + 64) >> 3) - 8);    // 条带顶行落在图片的第 k 页 (可为 -1)
+    uint8_t sh = (uint8_t)((dy + 64) & 7);
+    uint8_t has_lo = (k >= 0 && k < pages);
+    uint8_t has_hi = (k + 1 >= 0 && k + 1 < pages);
+    oled_img_dec_t lo, hi;
+
+    if (has_lo) {
+        oled_img_begin(&lo, img);
+        oled_img_skip(&lo, (uint16_t)(k * w + (from - x)));
+    }
+    if (has_hi) {
+        oled_img_begin(&hi, img);
+        oled_img_skip(&hi, (uint16_t)((k + 1) * w + (from - x)));
+    }
+
+    for (int16_t col = from; col < to; col++) {
+        uint16_t v = has_lo ? oled_img_next(&lo) : 0;
+        if (has_hi) v |= (uint16_t)(oled_img_next(&hi) << 8);
+        dl_apply(&s->buf[col - s->x0], (uint8_t)(v >> sh) & rows, mode);
+    }
+}
+#endif
+
+/**
+ * @brief 把整个列表栅格化到一条
+ */
+static void dl_render_strip(const dl_strip_t *s)
+{
+    uint16_t pos = 0;
+
+    memset(s->buf, 0, (size_t)(s->x1 - s->x0));
+
+    while (pos < dl_len) {
+        const uint8_t *p = &dl_buf[pos];
+
+        switch (p[0] >> 2) {
+        case DL_OP_TEXT:
+            dl_draw_text(s, p);
+            pos += DL_TEXT_HDR_LEN + p[4];
+            break;
+        case DL_OP_LINE:
+            dl_draw_line(s, p);
+            pos += DL_SHAPE_LEN;
+            break;
+        case DL_OP_RECT:
+        case DL_OP_FILL:
+            dl_draw_rect(s, p, (p[0] >> 2) == DL_OP_FILL);
+            pos += DL_SHAPE_LEN;
+            break;
+        case DL_OP_BITMAP:
+            dl_draw_bitmap(s, p);
+            pos += DL_BITMAP_LEN;
+            break;
+        case DL_OP_PLOT:
+            dl_draw_plot(s, p);
+            pos += DL_PLOT_LEN;
+            break;
+#if OLED_USE_IMAGE
+        case DL_OP_IMAGE:
+            dl_draw_image(s, p);
+            pos += DL_IMAGE_LEN;
+            break;
+#endif
+        default:
+            return;     // 不会发生：列表只由上面的接口写入
+        }
+    }
+}
+
+#if OLED_DLIST_SKIP_UNCHANGED
+/**
+ * @brief FNV-1a，用来判断一页内容是否与上次发出的相同
+ */
+static uint32_t dl_hash(const uint8_t *data, uint16_t len)
+{
+    uint32_t h = 2166136261u;
+    while (len--) {
+        h = (h ^ *data++) * 16777619u;
+    }
+    return h;
+}
+#endif
+
+void oled_dl_flush(void)
+{
+    dl_strip_t s = { dl_strip, 0, 0, OLED_DLIST_WIDTH };
+
+    for (uint8_t page = 0; page < OLED_DLIST_HEIGHT / 8; page++) {
+        s.top = (int16_t)(page * 8);
+        dl_render_strip(&s);
+
+#if OLED_DLIST_SKIP_UNCHANGED
+        uint32_t h = dl_hash(dl_strip, OLED_DLIST_WIDTH);
+        if ((dl_page_valid & (1u << page)) && dl_page_hash[page] == h) {
+            continue;
+        }
+        dl_page_hash[page] = h;
+        dl_page_valid |= (uint8_t)(1u << page);
+#endif
+        DL_WRITE(0, page, dl_strip, OLED_DLIST_WIDTH);
+    }
+}
+
+void oled_dl_flush_area(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    if (w == 0 || h == 0 || x >= OLED_DLIST_WIDTH || y >= OLED_DLIST_HEIGHT) return;
+
+    uint16_t x1 = (uint16_t)x + w;
+    uint16_t y1 = (uint16_t)y + h;
+    if (x1 > OLED_DLIST_WIDTH) x1 = OLED_DLIST_WIDTH;
+    if (y1 > OLED_DLIST_HEIGHT) y1 = OLED_DLIST_HEIGHT;
+
+    dl_strip_t s = { dl_strip, 0, x, (int16_t)x1 };
+
+    for (uint8_t page = y / 8; page < (y1 + 7u) / 8u; page++) {
+        s.top = (int16_t)(page * 8);
+        dl_render_strip(&s);
+#if OLED_DLIST_SKIP_UNCHANGED
+        dl_page_valid &= (uint8_t)~(1u << page);    // 只写了一部分列，整页哈希不再可信
+#endif
+        DL_WRITE(x, page, dl_strip, (uint16_t)(x1 - x));
+    }
+}
+
+void oled_dl_invalidate(void)
+{
+#if OLED_DLIST_SKIP_UNCHANGED
+    dl_page_valid = 0;
+#endif
+}
@@ -0,0 +1,136 @@
+/**
+ * @file oled_dlist.h
+ * @brief 显示列表 + 分条渲染：约 1/8 显存的 RAM 得到帧缓冲的绘制能力
+ * @note  绘制调用只记录成紧凑的命令，flush 时按页 (屏宽x8 像素) 逐条栅格化到
+ *        同一块屏宽字节 (128x64 屏为 128 字节) 的条带缓冲区，每渲染完一条就整条突发写出。
+ *        F030 / C0 这类放不下 1KB 帧缓冲的芯片也能画线、画框、任意 y 坐标的文字和位图。
+ */
+
+#ifndef __OLED_DLIST_H__
+#define __OLED_DLIST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ================= 用户配置区 ================= */
+
+/* 输出后端：0 = Oled.c (硬件 I2C)，1 = soft_oled.c (软件 I2C / DMA 波形 / 多屏广播) */
+#define OLED_DLIST_USE_SOFT     0
+
+/* 命令缓冲区大小 (字节)：一行 10 个字符的文字约 15 字节，直线/矩形 5 字节 */
+#define OLED_DLIST_BYTES        256
+
+/* * 跳过未变化的页：记录每页上次发出内容的哈希 (每页 4 字节)，
+ * 内容相同的页不再上总线，静态画面的刷新只剩栅格化的 CPU 开销。
+ */
+#define OLED_DLIST_SKIP_UNCHANGED 1
+
+#if OLED_DLIST_USE_SOFT
+#include "soft_oled.h"
+#else
+#include "Oled.h"
+#endif
+
+#define OLED_DLIST_WIDTH        OLED_PANEL_WIDTH    // 由 oled_panel.h 的型号决定
+#define OLED_DLIST_HEIGHT       OLED_PANEL_HEIGHT
+
+#if OLED_USE_SCALE
+/* * 放大字体：由 6x8 字模实时放大 scale (2~4) 倍，smooth 非 0 时做斜边平滑。
+ * 可以用在所有接受 OLED_FontSize 的地方 (oled_dl_text / oled_dl_printf / oled_widget)。
+ */
+#define OLED_DL_FONT_SCALE_FLAG     0x80u
+#define OLED_DL_FONT_SCALED(scale, smooth) \
+    ((OLED_FontSize)(OLED_DL_FONT_SCALE_FLAG | ((smooth) ? 0x10u : 0u) | ((scale) & 0x07u)))
+#endif
+
+/**
+ * @brief 绘制模式
+ */
+typedef enum {
+    OLED_DL_SET = 0,    // 点亮
+    OLED_DL_CLEAR,      // 熄灭 (在填充块上“挖”出反色文字)
+    OLED_DL_XOR,        // 取反
+} oled_dl_mode_t;
+
+/**
+ * @brief 清空显示列表，开始记录新的一帧
+ */
+void oled_dl_begin(void);
+
+/**
+ * @brief 文字 (y 为像素坐标，不必对齐到页；支持 \n 与自动换行，换行回到 x = 0)
+ * @note  字符串被拷贝进列表，调用后可立即复用
+ * @return 0 成功，-1 列表已满
+ */
+int oled_dl_text(uint8_t x, uint8_t y, OLED_FontSize font, oled_dl_mode_t mode, const char *str);
+
+/**
+ * @brief 格式化文字 (OLED_DL_SET 模式)，格式化结果直接写进列表
+ */
+int oled_dl_printf(uint8_t x, uint8_t y, OLED_FontSize font, const char *format, ...);
+
+/**
+ * @brief 直线 (Bresenham)
+ */
+int oled_dl_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, oled_dl_mode_t mode);
+
+/**
+ * @brief 矩形边框 / 实心矩形
+ */
+int oled_dl_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, oled_dl_mode_t mode);
+int oled_dl_fill(uint8_t x, uint8_t y, uint8_t w, uint8_t h, oled_dl_mode_t mode);
+
+/**
+ * @brief 位图 (SSD1306 原生页格式：每页 w 字节，字节内 bit0 在上，与 font.h 字模相同)
+ * @note  只记录指针，flush 完成前 bmp 必须有效 (通常放在 Flash 里)；为 1 的位才按 mode 绘制
+ */
+int oled_dl_bitmap(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bmp, oled_dl_mode_t mode);
+
+#if OLED_USE_IMAGE
+/**
+ * @brief 压缩图片 (oled_image 格式，y 不必按页对齐)，为 1 的位按 mode 绘制
+ * @note  只记录指针，flush 时边解码边合成到条带，不需要解压缓冲区
+ */
+int oled_dl_image(uint8_t x, uint8_t y, const uint8_t *img, oled_dl_mode_t mode);
+#endif
+
+/**
+ * @brief 折线 (波形)：第 i 列的值为 samples[(head + i) % w]，0 在底部、h-1 在顶部
+ * @note  只记录指针，适合直接传入环形采样缓冲区；超过 h-1 的值按 h-1 画
+ */
+int oled_dl_plot(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *samples, uint8_t head, oled_dl_mode_t mode);
+
+/**
+ * @brief 查询字体的字符宽度与高度 (像素)
+ */
+void oled_dl_font_size(OLED_FontSize font, uint8_t *w, uint8_t *h);
+
+/**
+ * @brief 渲染整屏并写出 (列表保留，可再次 flush)
+ */
+void oled_dl_flush(void);
+
+/**
+ * @brief 只渲染并写出覆盖 (x, y, w, h) 的页中 [x, x + w) 这些列
+ * @note  写出的是整页高度：这些列在相关页里不属于列表的旧内容会被清掉
+ */
+void oled_dl_flush_area(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+/**
+ * @brief 下次 flush 强制重发所有页
+ * @note  绕过显示列表直接调用 OLED_xxx 写过屏幕后调用
+ */
+void oled_dl_invalidate(void);
+
+/**
+ * @brief 已用字节数 / 本帧是否有命令因空间不足被丢弃
+ */
+uint16_t oled_dl_used(void);
+uint8_t oled_dl_overflowed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OLED_DLIST_H__ */
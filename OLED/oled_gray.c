@@ -0,0 +1,304 @@
+/**
+ * @file oled_gray.c
+ * @brief 2 位灰度帧率调制：位平面、差分区间与定时上屏
+ */
+
+#include "oled_gray.h"
+#include <string.h>
+
+#if !defined(OLED_GRAY_HOST)
+#if !OLED_USE_I2C_SCHED
+#error "oled_gray 依赖异步上屏管线：请在 Oled.h 中把 OLED_USE_I2C_SCHED 置 1"
+#endif
+#include "delay_async.h"
+
+#define GRAY_LOCK()     uint32_t primask = __get_PRIMASK(); __disable_irq()
+#define GRAY_UNLOCK()   __set_PRIMASK(primask)
+#else
+#define GRAY_LOCK()     do { } while (0)
+#define GRAY_UNLOCK()   do { } while (0)
+#endif
+
+#define GRAY_W      OLED_PANEL_WIDTH
+#define GRAY_PAGES  OLED_PANEL_PAGES
+
+/**
+ * @brief 列区间 [x0, x1)，x0 >= x1 表示空
+ */
+typedef struct {
+    uint8_t x0;
+    uint8_t x1;
+} gray_span_t;
+
+#define GRAY_SPAN_EMPTY  ((gray_span_t){ GRAY_W, 0 })
+
+/* 位平面 (页格式，与 OLED_WriteFrame 相同)：[0] = 低位，[1] = 高位 */
+static uint8_t gray_plane[2][OLED_PANEL_FRAME_BYTES];
+
+/* 每个平面在屏上停留的时隙数：高位是低位的两倍 */
+static const uint8_t gray_weight[2] = { 1, 2 };
+
+static gray_span_t gray_diff[GRAY_PAGES];       // 两平面内容不同的列 (commit 时重算)
+static gray_span_t gray_pend[2][GRAY_PAGES];    // 已提交、该平面下次上屏时必须重写的列
+static gray_span_t gray_drawn[GRAY_PAGES];      // 上次 commit 以来画过的列
+
+static uint8_t gray_shown;                      // 屏上 (或正在上屏) 的平面
+static volatile uint8_t gray_busy;              // 平面正在上屏
+static uint8_t gray_page;                       // 上屏进行到的页
+static oled_gray_stats_t gray_stats;
+
+/* ================= 区间 ================= */
+
+static inline void gray_span_add(gray_span_t *s, uint8_t x0, uint8_t x1)
+{
+    if (x0 < s->x0) s->x0 = x0;
+    if (x1 > s->x1) s->x1 = x1;
+}
+
+/**
+ * @brief 取出某平面某页这次要发的列：平面差分 ∪ 待重写，取完清空待重写
+ */
+static gray_span_t gray_take_span(uint8_t plane, uint8_t page)
+{
+    gray_span_t s = gray_diff[page];
+    gray_span_t *p = &gray_pend[plane][page];
+
+    if (p->x0 < p->x1) gray_span_add(&s, p->x0, p->x1);
+    *p = GRAY_SPAN_EMPTY;
+    return s;
+}
+
+/* ================= 上屏 ================= */
+
+#if !defined(OLED_GRAY_HOST)
+static void gray_page_done(int status, void *arg);
+#endif
+
+/**
+ * @brief 发送当前平面剩下的页
+ * @note  MCU：每次提交一页后返回，由该页的完成回调接着发下一页 (中断上下文)；
+ *        主机：同步写完所有页
+ */
+static void gray_upload_next(void)
+{
+    while (gray_page < GRAY_PAGES) {
+        uint8_t page = gray_page++;
+        gray_span_t s = gray_take_span(gray_shown, page);
+        if (s.x0 >= s.x1) continue;
+
+        const uint8_t *data = &gray_plane[gray_shown][page * GRAY_W + s.x0];
+        uint8_t len = (uint8_t)(s.x1 - s.x0);
+        uint8_t col = (uint8_t)(s.x0 + OLED_PANEL_COL_OFFSET);
+        gray_stats.bytes += len;
+
+#if defined(OLED_GRAY_HOST)
+        oled_gray_host_write(col, page, data, len);
+#else
+        uint8_t cur[4] = { 0x00, (uint8_t)(0xB0 | page), (uint8_t)(col & 0x0F), (uint8_t)(0x10 | (col >> 4)) };
+
+        // 平面缓冲区是静态的，调度器只记录指针；分段发送让传感器能在页中间插队
+        if (i2c_sched_write(OLED_I2C_BUS, OLED_I2C_PRIO, OLED_I2C_ADDR, cur, 4, NULL, NULL) == 0 &&
+            i2c_sched_mem_write(OLED_I2C_BUS, OLED_I2C_PRIO, OLED_I2C_ADDR, 0x40, data, len,
+                                OLED_I2C_CHUNK, gray_page_done, NULL) == 0) {
+            return;
+        }
+        // 队列满：这一页留到该平面下次上屏时整页重写
+        gray_pend[gray_shown][page] = (gray_span_t){ 0, GRAY_W };
+        gray_stats.overruns++;
+#endif
+    }
+    gray_busy = 0;
+}
+
+#if !defined(OLED_GRAY_HOST)
+static void gray_page_done(int status, void *arg)
+{
+    (void)arg;
+    if (status != I2C_SCHED_OK) {
+        gray_pend[gray_shown][gray_page - 1] = (gray_span_t){ 0, GRAY_W };
+    }
+    gray_upload_next();
+}
+#endif
+
+/**
+ * @brief 切换到另一个平面并开始上屏
+ */
+static void gray_switch(void)
+{
+    gray_shown ^= 1u;
+    gray_page = 0;
+    gray_busy = 1;
+    gray_stats.subframes++;
+    gray_upload_next();
+}
+
+/* ================= 节拍 ================= */
+
+#if defined(OLED_GRAY_HOST)
+static uint8_t gray_slots_left;
+
+uint8_t oled_gray_tick(uint8_t *shown)
+{
+    uint8_t switched = 0;
+
+    if (gray_slots_left == 0) {
+        gray_switch();
+        gray_slots_left = gray_weight[gray_shown];
+        switched = 1;
+    }
+    gray_slots_left--;
+    *shown = gray_shown;
+    return switched;
+}
+#else
+static volatile uint8_t gray_running;
+static volatile uint32_t gray_gen;  // 每次 start / stop 递增，用来识别上一条节拍链里过期的回调
+static uint32_t gray_deadline;      // 下一次换平面的绝对时刻 (us)
+
+/**
+ * @brief 定时器回调：按绝对时刻排下一次节拍，避免回调延迟一点点累积成漂移
+ */
+static void gray_timer_cb(void *arg)
+{
+    // stop 之后很快又 start 时，旧链的回调还在定时器堆里：它不能再续排，否则两条链同时换平面
+    if (!gray_running || (uint32_t)(uintptr_t)arg != gray_gen) return;
+
+    if (gray_busy) {
+        // 上一平面还没发完：再等一个时隙，保持当前平面，不让两平面的时间比例被打乱
+        gray_stats.overruns++;
+        gray_deadline += OLED_GRAY_SLOT_US;
+    } else {
+        gray_switch();
+        gray_deadline += (uint32_t)gray_weight[gray_shown] * OLED_GRAY_SLOT_US;
+    }
+
+    int32_t wait = (int32_t)(gray_deadline - delay_async_now_us());
+    if (wait <= 0) {
+        // 落后太多 (例如被长时间关中断)：从现在重新对齐
+        wait = OLED_GRAY_SLOT_US;
+        gray_deadline = delay_async_now_us() + OLED_GRAY_SLOT_US;
+    }
+    delay_async_us((uint32_t)wait, gray_timer_cb, arg);
+}
+
+void oled_gray_start(void)
+{
+    if (gray_running) return;
+    gray_gen++;
+    gray_running = 1;
+    gray_deadline = delay_async_now_us();
+    gray_timer_cb((void *)(uintptr_t)gray_gen);
+}
+
+void oled_gray_stop(void)
+{
+    gray_running = 0;       // 已排队的节拍到期后不再续排
+    gray_gen++;
+}
+#endif
+
+/* ================= 绘图 ================= */
+
+void oled_gray_init(void)
+{
+    memset(gray_plane, 0, sizeof(gray_plane));
+    for (uint8_t p = 0; p < GRAY_PAGES; p++) {
+        gray_diff[p] = GRAY_SPAN_EMPTY;
+        gray_pend[0][p] = GRAY_SPAN_EMPTY;
+        gray_pend[1][p] = GRAY_SPAN_EMPTY;
+        gray_drawn[p] = GRAY_SPAN_EMPTY;
+    }
+    gray_shown = 0;
+    gray_busy = 0;
+    memset(&gray_stats, 0, sizeof(gray_stats));
+#if defined(OLED_GRAY_HOST)
+    gray_slots_left = 0;
+#else
+    gray_running = 0;
+    gray_gen++;
+    OLED_Clear();           // 屏上与两个全零平面一致
+#endif
+}
+
+void oled_gray_clear(void)
+{
+    memset(gray_plane, 0, sizeof(gray_plane));
+    for (uint8_t p = 0; p < GRAY_PAGES; p++) {
+        gray_drawn[p] = (gray_span_t){ 0, GRAY_W };
+    }
+}
+
+void oled_gray_pixel(uint8_t x, uint8_t y, uint8_t level)
+{
+    if (x >= GRAY_W || y >= OLED_PANEL_HEIGHT) return;
+
+    uint16_t idx = (uint16_t)((y >> 3) * GRAY_W + x);
+    uint8_t bit = (uint8_t)(1u << (y & 7));
+
+    for (uint8_t b = 0; b < 2; b++) {
+        if (level & (1u << b)) gray_plane[b][idx] |= bit;
+        else                   gray_plane[b][idx] &= (uint8_t)~bit;
+    }
+    gray_span_add(&gray_drawn[y >> 3], x, (uint8_t)(x + 1));
+}
+
+void oled_gray_fill(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t level)
+{
+    if (x >= GRAY_W || y >= OLED_PANEL_HEIGHT || w == 0 || h == 0) return;
+
+    uint16_t x1 = (uint16_t)x + w, y1 = (uint16_t)y + h;
+    if (x1 > GRAY_W) x1 = GRAY_W;
+    if (y1 > OLED_PANEL_HEIGHT) y1 = OLED_PANEL_HEIGHT;
+
+    for (uint8_t page = y >> 3; page < (y1 + 7u) >> 3; page++) {
+        // 本页内被覆盖的行 -> 位掩码
+        uint16_t top = (uint16_t)(page * 8);
+        uint8_t a = (y > top) ? (uint8_t)(y - top) : 0;
+        uint8_t b = (y1 < top + 8) ? (uint8_t)(y1 - top) : 8;
+        uint8_t mask = (uint8_t)((0xFFu << a) & (0xFFu >> (8 - b)));
+
+        for (uint8_t pl = 0; pl < 2; pl++) {
+            uint8_t *row = &gray_plane[pl][page * GRAY_W];
+            uint8_t set = (level & (1u << pl)) ? mask : 0;
+            for (uint16_t c = x; c < x1; c++) {
+                row[c] = (uint8_t)((row[c] & ~mask) | set);
+            }
+        }
+        gray_span_add(&gray_drawn[page], x, (uint8_t)x1);
+    }
+}
+
+void oled_gray_commit(void)
+{
+    for (uint8_t page = 0; page < GRAY_PAGES; page++) {
+        gray_span_t d = gray_drawn[page];
+        if (d.x0 >= d.x1) continue;
+
+        // 重算整页的平面差分：画完之后两平面可能在别的列也变得相同/不同
+        const uint8_t *lo = &gray_plane[0][page * GRAY_W];
+        const uint8_t *hi = &gray_plane[1][page * GRAY_W];
+        gray_span_t diff = GRAY_SPAN_EMPTY;
+        for (uint8_t c = 0; c < GRAY_W; c++) {
+            if (lo[c] != hi[c]) {
+                if (diff.x0 > c) diff.x0 = c;
+                diff.x1 = (uint8_t)(c + 1);
+            }
+        }
+
+        GRAY_LOCK();
+        gray_diff[page] = diff;
+        gray_span_add(&gray_pend[0][page], d.x0, d.x1);
+        gray_span_add(&gray_pend[1][page], d.x0, d.x1);
+        GRAY_UNLOCK();
+
+        gray_drawn[page] = GRAY_SPAN_EMPTY;
+    }
+}
+
+void oled_gray_get_stats(oled_gray_stats_t *out)
+{
+    GRAY_LOCK();
+    *out = gray_stats;
+    GRAY_UNLOCK();
+}
@@ -0,0 +1,99 @@
+/**
+ * @file oled_gray.h
+ * @brief 2 位灰度：两个位平面按 2:1 的时间权重轮流上屏 (帧率调制 FRM)
+ * @note  SSD1306 只有开/关两种像素，灰度靠人眼积分：高位平面显示 2 个时隙、低位平面 1 个时隙，
+ *        像素的平均亮度就是 0 / 1/3 / 2/3 / 1 四级。要看起来不闪，每个时隙都得准时上屏：
+ *        - 节拍由 delay_async 定时器按绝对时刻驱动，不受主循环耽搁；
+ *        - 上屏走 i2c_sched 异步管线，每页一次光标 + 一次 DMA 写，页与页在完成回调里串联；
+ *        - 只发差分：切换平面时，两平面相同的列 (纯黑/纯白区域) 屏上已经是对的，
+ *          每页只写两平面不同的列区间，再加上新画过的列。
+ *        主机端定义 OLED_GRAY_HOST 后去掉总线/定时器部分，由模拟器驱动节拍 (见 tools/gray_emu.c)。
+ */
+
+#ifndef __OLED_GRAY_H__
+#define __OLED_GRAY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(OLED_GRAY_HOST)
+#include <stdint.h>
+#include "oled_panel.h"
+#else
+#include "Oled.h"
+#endif
+
+/* ================= 用户配置区 ================= */
+
+/* 一个时隙的长度 (us)：一个灰度周期 = 3 个时隙。
+ * 必须长于最坏情况下一个平面的差分上屏时间 (400kHz 下每字节 ≈22.5us)，
+ * 5000us 时周期 15ms (≈67Hz)，每个时隙最多约 200 字节差分 */
+#define OLED_GRAY_SLOT_US       5000
+
+/* ================= 接口 ================= */
+
+/* 灰度级 */
+#define OLED_GRAY_BLACK     0
+#define OLED_GRAY_DARK      1   // 1/3 亮度
+#define OLED_GRAY_LIGHT     2   // 2/3 亮度
+#define OLED_GRAY_WHITE     3
+
+/**
+ * @brief 运行统计
+ */
+typedef struct {
+    uint32_t subframes;     // 已上屏的平面次数
+    uint32_t bytes;         // 发出的 GDDRAM 数据字节 (不含光标命令)
+    uint32_t overruns;      // 时隙到了上一平面还没发完 (时隙太短或总线太忙)
+} oled_gray_stats_t;
+
+/**
+ * @brief 初始化：清空两个平面并清屏
+ * @note  在 OLED_Init / i2c_sched_init / delay_async_init 之后调用
+ */
+void oled_gray_init(void);
+
+/**
+ * @brief 开始 / 停止灰度轮换 (停止后屏上保留最后上屏的平面)
+ * @note  停止后可以马上再开始：上一轮还在定时器里排着的节拍会被认出来丢掉，不会出现两路同时换平面
+ */
+void oled_gray_start(void);
+void oled_gray_stop(void);
+
+/**
+ * @brief 绘图 (只改帧缓冲，oled_gray_commit 之后才保证上屏)
+ * @param level OLED_GRAY_BLACK ~ OLED_GRAY_WHITE
+ */
+void oled_gray_clear(void);
+void oled_gray_pixel(uint8_t x, uint8_t y, uint8_t level);
+void oled_gray_fill(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t level);
+
+/**
+ * @brief 提交本次绘制：重新计算改动页的平面差分，并安排这些列在两个平面上各重发一次
+ */
+void oled_gray_commit(void);
+
+/**
+ * @brief 读取统计
+ */
+void oled_gray_get_stats(oled_gray_stats_t *out);
+
+#if defined(OLED_GRAY_HOST)
+/**
+ * @brief [主机] 推进一个时隙：需要换平面时同步"上屏"并返回 1
+ * @param shown 返回当前屏上的平面 (0 = 低位，1 = 高位)
+ */
+uint8_t oled_gray_tick(uint8_t *shown);
+
+/**
+ * @brief [主机] 由模拟器实现：写一段 GDDRAM (列地址已含 OLED_PANEL_COL_OFFSET)
+ */
+void oled_gray_host_write(uint8_t col, uint8_t page, const uint8_t *data, uint16_t len);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OLED_GRAY_H__ */
@@ -0,0 +1,93 @@
+/**
+ * @file oled_image.c
+ * @brief PackBits 页格式图片解码
+ */
+
+#include "oled_image.h"
+#include <string.h>
+
+/**
+ * @brief 读入下一个包头
+ */
+static void img_load_packet(oled_img_dec_t *dec)
+{
+    uint8_t n;
+
+    do {
+        n = *dec->src++;
+    } while (n == 128);     // 空操作
+
+    if (n < 128) {
+        dec->repeat = 0;
+        dec->count = (uint8_t)(n + 1u);
+    } else {
+        dec->repeat = 1;
+        dec->count = (uint8_t)(257u - n);
+        dec->value = *dec->src++;
+    }
+}
+
+void oled_img_begin(oled_img_dec_t *dec, const uint8_t *img)
+{
+    dec->src = img + OLED_IMG_HDR_LEN;
+    dec->count = 0;
+    dec->repeat = 0;
+    dec->value = 0;
+}
+
+void oled_img_read(oled_img_dec_t *dec, uint8_t *dst, uint16_t n)
+{
+    while (n) {
+        if (dec->count == 0) {
+            img_load_packet(dec);
+        }
+
+        uint8_t take = (n < dec->count) ? (uint8_t)n : dec->count;
+        if (dec->repeat) {
+            memset(dst, dec->value, take);
+        } else {
+            memcpy(dst, dec->src, take);
+            dec->src += take;
+        }
+        dst += take;
+        n -= take;
+        dec->count -= take;
+    }
+}
+
+void oled_img_skip(oled_img_dec_t *dec, uint16_t n)
+{
+    while (n) {
+        if (dec->count == 0) {
+            img_load_packet(dec);
+        }
+
+        uint8_t take = (n < dec->count) ? (uint8_t)n : dec->count;
+        if (!dec->repeat) {
+            dec->src += take;
+        }
+        n -= take;
+        dec->count -= take;
+    }
+}
+
+uint8_t oled_img_next(oled_img_dec_t *dec)
+{
+    if (dec->count == 0) {
+        img_load_packet(dec);
+    }
+    dec->count--;
+    return dec->repeat ? dec->value : *dec->src++;
+}
+
+uint16_t oled_img_decode(const uint8_t *img, uint8_t *dst, uint16_t cap)
+{
+    uint16_t total = (uint16_t)(OLED_IMG_WIDTH(img) * OLED_IMG_PAGES(img));
+    oled_img_dec_t dec;
+
+    if (total > cap) return 0;
+
+    oled_img_begin(&dec, img);
+    oled_img_read(&dec, dst, total);
+    return total;
+}
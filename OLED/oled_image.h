@@ -0,0 +1,75 @@
+/**
+ * @file oled_image.h
+ * @brief 单色图片压缩格式 (页格式 + PackBits) 与流式解码器
+ * @note  与硬件无关 (PC 端转换工具也链接这份代码)。图片按 font.h 字模同样的页格式排布：
+ *        第 0 页 w 个字节、第 1 页 w 个字节……，字节内 bit0 在上。
+ *        OLED 图标/开机 Logo 大片是 0x00 或 0xFF，PackBits 通常能压到 20%~50%，
+ *        解码按“包”整段 memset / memcpy，不需要整幅图的临时缓冲区。
+ */
+
+#ifndef __OLED_IMAGE_H__
+#define __OLED_IMAGE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* * 数据格式：
+ *   [0] 宽度 (像素列数，1~255)
+ *   [1] 高度 (像素行数，1~255；页数 = (高度 + 7) / 8)
+ *   [2..] PackBits 压缩的页格式数据，解压后正好 宽度 x 页数 字节
+ *     控制字节 n = 0~127   : 后面 n+1 个字节原样输出
+ *     控制字节 n = 129~255 : 下一个字节重复 257-n 次 (2~128 次)
+ *     控制字节 n = 128     : 空操作
+ * 用 OLED/tools/img2c 从 PBM 图片生成。
+ */
+#define OLED_IMG_HDR_LEN    2u
+
+#define OLED_IMG_WIDTH(img)   ((img)[0])
+#define OLED_IMG_HEIGHT(img)  ((img)[1])
+#define OLED_IMG_PAGES(img)   ((uint8_t)(((img)[1] + 7u) / 8u))
+
+/**
+ * @brief 流式解码器：按顺序取出解压后的字节
+ */
+typedef struct {
+    const uint8_t *src;     // 下一个待读的压缩字节
+    uint8_t count;          // 当前包还剩多少字节
+    uint8_t repeat;         // 当前包是重复包
+    uint8_t value;          // 重复包的字节值
+} oled_img_dec_t;
+
+/**
+ * @brief 从图片开头 (解压后偏移 0) 开始解码
+ */
+void oled_img_begin(oled_img_dec_t *dec, const uint8_t *img);
+
+/**
+ * @brief 解出接下来的 n 个字节
+ * @note  调用者保证不超过图片剩余长度
+ */
+void oled_img_read(oled_img_dec_t *dec, uint8_t *dst, uint16_t n);
+
+/**
+ * @brief 跳过 n 个字节 (整包跳过，不逐字节解码)
+ */
+void oled_img_skip(oled_img_dec_t *dec, uint16_t n);
+
+/**
+ * @brief 取下一个字节
+ */
+uint8_t oled_img_next(oled_img_dec_t *dec);
+
+/**
+ * @brief 整幅解压到 dst (例如已有的帧缓冲)
+ * @return 解压后的字节数，cap 不够时返回 0
+ */
+uint16_t oled_img_decode(const uint8_t *img, uint8_t *dst, uint16_t cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OLED_IMAGE_H__ */
@@ -0,0 +1,220 @@
+/**
+ * @file oled_panel.h
+ * @brief 屏幕型号描述：分辨率、列偏移、支持的寻址模式、初始化序列 (编译期选择)
+ * @note  Oled.c / soft_oled.c / oled_dlist.c 的循环次数、越界检查和整屏刷新方式都由这里的常量决定，
+ *        换屏只改 OLED_PANEL 一处：
+ *        - 128x32 只有 4 页，清屏和整帧刷新的数据量减半；
+ *        - 72x40 (0.42 寸) 显示窗口在 GDDRAM 的第 28~99 列，坐标自动加偏移；
+ *        - SH1106 的 RAM 有 132 列、可见区从第 2 列开始，且没有水平寻址模式，
+ *          整帧刷新退化为每页一次光标 + 一次整页突发。
+ */
+
+#ifndef __OLED_PANEL_H__
+#define __OLED_PANEL_H__
+
+/* 可选型号 */
+#define OLED_PANEL_SSD1306_128X64   0
+#define OLED_PANEL_SSD1306_128X32   1
+#define OLED_PANEL_SSD1306_72X40    2
+#define OLED_PANEL_SH1106_128X64    3
+#define OLED_PANEL_SSD1309_128X64   4
+
+/* ================= 用户配置区 ================= */
+
+#ifndef OLED_PANEL
+#define OLED_PANEL  OLED_PANEL_SSD1306_128X64
+#endif
+
+/* 初始化参数：可在这里或编译选项里覆盖，不定义则用各型号的推荐值 */
+// #define OLED_PANEL_CONTRAST   0xCF   /* 对比度 0x00~0xFF */
+// #define OLED_PANEL_MULTIPLEX  0x3F   /* 复用率 - 1，默认 = 高度 - 1 */
+#ifndef OLED_PANEL_FLIP
+#define OLED_PANEL_FLIP       0         /* 1 = 旋转 180° (段重映射 0xA0 + COM 正向扫描 0xC0) */
+#endif
+
+/* 上电后多久才能发命令 (ms)，从 HAL_Init 开始的系统节拍算起：
+ * OLED_Init 之前的其它初始化 (时钟、外设、传感器自检……) 都算在这段时间里，
+ * 只有它们加起来不到这个时间时才需要等剩下的部分。只用于硬件 I2C 版，
+ * 软件 I2C 版用 soft_oled.h 的 SOFT_OLED_POWERUP_US */
+#ifndef OLED_PANEL_POWERUP_MS
+#define OLED_PANEL_POWERUP_MS 100
+#endif
+
+/* ================= 型号参数 ================= */
+/*
+ * OLED_PANEL_WIDTH / HEIGHT : 可见区像素
+ * OLED_PANEL_COL_OFFSET     : 可见区第 0 列对应的 GDDRAM 列地址
+ * OLED_PANEL_HADDR          : 1 = 支持水平寻址 (0x20 0x00 + 0x21/0x22 窗口)，整帧可以一次突发写完
+ * OLED_PANEL_INIT           : 初始化命令序列 (逗号分隔的字节)，最后一条是 Display On；
+ *                             驱动其余部分假定上电后处于页寻址模式。
+ *                             整张表在控制字节 0x00 之后一次事务发完 (Co = 0，后续字节全部按命令解析)，
+ *                             对比度 / 方向 / 复用率引用下面的可覆盖参数
+ */
+
+#if OLED_PANEL == OLED_PANEL_SSD1306_128X64
+#define OLED_PANEL_NAME         "SSD1306 128x64"
+#define OLED_PANEL_WIDTH        128
+#define OLED_PANEL_HEIGHT       64
+#define OLED_PANEL_COL_OFFSET   0
+#define OLED_PANEL_HADDR        1
+#define OLED_PANEL_CONTRAST_DEFAULT 0xCF
+#define OLED_PANEL_INIT                                     \
+    0xAE,               /* Display Off */                   \
+    0xD5, 0x80,         /* Clock Divide */                  \
+    0xA8, OLED_PANEL_MULTIPLEX, /* Multiplex */             \
+    0xD3, 0x00,         /* Offset */                        \
+    0x40,               /* Start Line */                    \
+    0x8D, 0x14,         /* Charge Pump (重要!) */           \
+    0x20, 0x02,         /* Page Addressing Mode */          \
+    OLED_PANEL_SEG_REMAP, /* Segment Remap */               \
+    OLED_PANEL_COM_SCAN,  /* COM Scan Direction */          \
+    0xDA, 0x12,         /* COM Pins: 交替 */                \
+    0x81, OLED_PANEL_CONTRAST, /* Contrast */               \
+    0xD9, 0xF1,         /* Pre-charge */                    \
+    0xDB, 0x40,         /* VCOM Detect */                   \
+    0xA4,               /* Resume to RAM */                 \
+    0xA6,               /* Normal Display */                \
+    0xAF                /* Display On */
+
+#elif OLED_PANEL == OLED_PANEL_SSD1306_128X32
+#define OLED_PANEL_NAME         "SSD1306 128x32"
+#define OLED_PANEL_WIDTH        128
+#define OLED_PANEL_HEIGHT       32
+#define OLED_PANEL_COL_OFFSET   0
+#define OLED_PANEL_HADDR        1
+#define OLED_PANEL_CONTRAST_DEFAULT 0x8F
+#define OLED_PANEL_INIT                                     \
+    0xAE,                                                   \
+    0xD5, 0x80,                                             \
+    0xA8, OLED_PANEL_MULTIPLEX,                             \
+    0xD3, 0x00,                                             \
+    0x40,                                                   \
+    0x8D, 0x14,                                             \
+    0x20, 0x02,                                             \
+    OLED_PANEL_SEG_REMAP,                                   \
+    OLED_PANEL_COM_SCAN,                                    \
+    0xDA, 0x02,         /* COM Pins: 顺序 (32 行模组) */    \
+    0x81, OLED_PANEL_CONTRAST,                              \
+    0xD9, 0xF1,                                             \
+    0xDB, 0x40,                                             \
+    0xA4,                                                   \
+    0xA6,                                                   \
+    0xAF
+
+#elif OLED_PANEL == OLED_PANEL_SSD1306_72X40
+#define OLED_PANEL_NAME         "SSD1306 72x40"
+#define OLED_PANEL_WIDTH        72
+#define OLED_PANEL_HEIGHT       40
+#define OLED_PANEL_COL_OFFSET   28
+#define OLED_PANEL_HADDR        1
+#define OLED_PANEL_CONTRAST_DEFAULT 0xAF
+#define OLED_PANEL_INIT                                     \
+    0xAE,                                                   \
+    0xD5, 0x80,                                             \
+    0xA8, OLED_PANEL_MULTIPLEX,                             \
+    0xD3, 0x00,                                             \
+    0x40,                                                   \
+    0x8D, 0x14,                                             \
+    0x20, 0x02,                                             \
+    OLED_PANEL_SEG_REMAP,                                   \
+    OLED_PANEL_COM_SCAN,                                    \
+    0xDA, 0x12,                                             \
+    0xAD, 0x30,         /* 内部 IREF (0.42 寸模组需要) */   \
+    0x81, OLED_PANEL_CONTRAST,                              \
+    0xD9, 0x22,                                             \
+    0xDB, 0x20,                                             \
+    0xA4,                                                   \
+    0xA6,                                                   \
+    0xAF
+
+#elif OLED_PANEL == OLED_PANEL_SH1106_128X64
+#define OLED_PANEL_NAME         "SH1106 128x64"
+#define OLED_PANEL_WIDTH        128
+#define OLED_PANEL_HEIGHT       64
+#define OLED_PANEL_COL_OFFSET   2       // 132 列 RAM，可见区居中
+#define OLED_PANEL_HADDR        0       // 只有页寻址
+#define OLED_PANEL_CONTRAST_DEFAULT 0xCF
+#define OLED_PANEL_INIT                                     \
+    0xAE,                                                   \
+    0xD5, 0x80,                                             \
+    0xA8, OLED_PANEL_MULTIPLEX,                             \
+    0xD3, 0x00,                                             \
+    0x40,                                                   \
+    0xAD, 0x8B,         /* DC-DC On (代替 0x8D 电荷泵) */   \
+    0x32,               /* Pump 电压 8.0V */                \
+    OLED_PANEL_SEG_REMAP,                                   \
+    OLED_PANEL_COM_SCAN,                                    \
+    0xDA, 0x12,                                             \
+    0x81, OLED_PANEL_CONTRAST,                              \
+    0xD9, 0x22,                                             \
+    0xDB, 0x35,                                             \
+    0xA4,                                                   \
+    0xA6,                                                   \
+    0xAF
+
+#elif OLED_PANEL == OLED_PANEL_SSD1309_128X64
+#define OLED_PANEL_NAME         "SSD1309 128x64"
+#define OLED_PANEL_WIDTH        128
+#define OLED_PANEL_HEIGHT       64
+#define OLED_PANEL_COL_OFFSET   0
+#define OLED_PANEL_HADDR        1
+#define OLED_PANEL_CONTRAST_DEFAULT 0xCF
+#define OLED_PANEL_INIT                                     \
+    0xAE,                                                   \
+    0xD5, 0xA0,                                             \
+    0xA8, OLED_PANEL_MULTIPLEX,                             \
+    0xD3, 0x00,                                             \
+    0x40,               /* 无内部电荷泵，VCC 由模组提供 */  \
+    0x20, 0x02,                                             \
+    OLED_PANEL_SEG_REMAP,                                   \
+    OLED_PANEL_COM_SCAN,                                    \
+    0xDA, 0x12,                                             \
+    0x81, OLED_PANEL_CONTRAST,                              \
+    0xD9, 0xF1,                                             \
+    0xDB, 0x40,                                             \
+    0xA4,                                                   \
+    0xA6,                                                   \
+    0xAF
+
+#else
+#error "未知的 OLED_PANEL"
+#endif
+
+/* ================= 初始化参数 ================= */
+
+#ifndef OLED_PANEL_CONTRAST
+#define OLED_PANEL_CONTRAST     OLED_PANEL_CONTRAST_DEFAULT
+#endif
+#ifndef OLED_PANEL_MULTIPLEX
+#define OLED_PANEL_MULTIPLEX    (OLED_PANEL_HEIGHT - 1)
+#endif
+#if OLED_PANEL_FLIP
+#define OLED_PANEL_SEG_REMAP    0xA0
+#define OLED_PANEL_COM_SCAN     0xC0
+#else
+#define OLED_PANEL_SEG_REMAP    0xA1
+#define OLED_PANEL_COM_SCAN     0xC8
+#endif
+
+/* ================= 派生常量 ================= */
+
+#define OLED_PANEL_PAGES        (OLED_PANEL_HEIGHT / 8)
+#define OLED_PANEL_MAX_X        (OLED_PANEL_WIDTH - 1)
+#define OLED_PANEL_MAX_PAGE     (OLED_PANEL_PAGES - 1)
+#define OLED_PANEL_FRAME_BYTES  (OLED_PANEL_WIDTH * OLED_PANEL_PAGES)
+
+#if (OLED_PANEL_HEIGHT % 8) != 0
+#error "OLED_PANEL_HEIGHT 必须是 8 的整数倍"
+#endif
+
+#if OLED_PANEL_HADDR
+/* 整屏写窗口：水平寻址 + 列/页范围，之后的数据跨页连续写入 */
+#define OLED_PANEL_FRAME_BEGIN                                          \
+    0x20, 0x00,                                                         \
+    0x21, OLED_PANEL_COL_OFFSET, (OLED_PANEL_COL_OFFSET + OLED_PANEL_MAX_X), \
+    0x22, 0x00, OLED_PANEL_MAX_PAGE
+/* 恢复页寻址 (其余接口依赖 0xB0 页地址命令) */
+#define OLED_PANEL_FRAME_END    0x20, 0x02
+#endif
+
+#endif /* __OLED_PANEL_H__ */
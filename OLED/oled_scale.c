@@ -0,0 +1,126 @@
+/**
+ * @file oled_scale.c
+ * @brief 放大字模生成：半字节展开表 + 按位 EPX
+ */
+
+#include "oled_scale.h"
+
+/* 半字节的每一位重复 s 次：bit i -> bit s*i ~ s*i+s-1 */
+static const uint16_t scale_lut[OLED_SCALE_MAX - 1][16] = {
+    { 0x0000, 0x0003, 0x000C, 0x000F, 0x0030, 0x0033, 0x003C, 0x003F,
+      0x00C0, 0x00C3, 0x00CC, 0x00CF, 0x00F0, 0x00F3, 0x00FC, 0x00FF },   /* 2x */
+    { 0x0000, 0x0007, 0x0038, 0x003F, 0x01C0, 0x01C7, 0x01F8, 0x01FF,
+      0x0E00, 0x0E07, 0x0E38, 0x0E3F, 0x0FC0, 0x0FC7, 0x0FF8, 0x0FFF },   /* 3x */
+    { 0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+      0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF },   /* 4x */
+};
+
+/* 半字节的位摊到偶数位：bit i -> bit 2i (EPX 交织上下两个子像素用) */
+static const uint8_t scale_spread[16] = {
+    0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15,
+    0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55,
+};
+
+/**
+ * @brief 一个 8 行的列纵向放大 s 倍 (s = 2~4)，结果最多 32 位
+ */
+static inline uint32_t scale_expand8(uint8_t col, uint8_t s)
+{
+    const uint16_t *lut = scale_lut[s - 2];
+    return lut[col & 0x0F] | ((uint32_t)lut[col >> 4] << (4u * s));
+}
+
+/**
+ * @brief 两个 8 行子像素列交织成 16 行：even -> 偶数行，odd -> 奇数行
+ */
+static inline uint16_t scale_interleave(uint8_t even, uint8_t odd)
+{
+    uint16_t e = (uint16_t)(scale_spread[even & 0x0F] | (scale_spread[even >> 4] << 8));
+    uint16_t o = (uint16_t)(scale_spread[odd & 0x0F] | (scale_spread[odd >> 4] << 8));
+    return (uint16_t)(e | (o << 1));
+}
+
+/**
+ * @brief 把一列放大后的位 (bits，共 pages*8 行) 写到 out 的第 x 列
+ */
+static inline void scale_put_col(uint8_t *out, uint8_t w, uint8_t pages, uint8_t x, uint32_t bits)
+{
+    for (uint8_t p = 0; p < pages; p++) {
+        out[p * w + x] = (uint8_t)(bits >> (8u * p));
+    }
+}
+
+/**
+ * @brief EPX (Scale2x)：源列 c 放大成左右两个 16 行的子列
+ * @note  上下邻居由移位得到，左右邻居就是相邻列，四个角的判定对 8 行同时按位完成：
+ *        左上 = (C == A && C != D && A != B) ? A : P，其余三个角对称
+ */
+static void scale_epx_col(const uint8_t *src, uint8_t c, uint16_t *left, uint16_t *right)
+{
+    uint8_t P = src[c];
+    uint8_t A = (uint8_t)(P << 1);                          // 上方像素
+    uint8_t D = (uint8_t)(P >> 1);                          // 下方像素
+    uint8_t C = c ? src[c - 1] : 0;                         // 左侧
+    uint8_t B = (c + 1u < OLED_SCALE_SRC_W) ? src[c + 1] : 0;   // 右侧
+
+    uint8_t e1 = (uint8_t)(~(C ^ A) & (C ^ D) & (A ^ B));
+    uint8_t e2 = (uint8_t)(~(A ^ B) & (A ^ C) & (B ^ D));
+    uint8_t e3 = (uint8_t)(~(D ^ C) & (D ^ B) & (C ^ A));
+    uint8_t e4 = (uint8_t)(~(B ^ D) & (B ^ A) & (D ^ C));
+
+    uint8_t tl = (uint8_t)((e1 & A) | (~e1 & P));
+    uint8_t tr = (uint8_t)((e2 & B) | (~e2 & P));
+    uint8_t bl = (uint8_t)((e3 & C) | (~e3 & P));
+    uint8_t br = (uint8_t)((e4 & D) | (~e4 & P));
+
+    *left = scale_interleave(tl, bl);
+    *right = scale_interleave(tr, br);
+}
+
+/**
+ * @brief 16 行的列再纵向放大 2 倍到 32 行 (4x 平滑用)
+ */
+static inline uint32_t scale_expand16x2(uint16_t col)
+{
+    return scale_expand8((uint8_t)col, 2) | (scale_expand8((uint8_t)(col >> 8), 2) << 16);
+}
+
+uint8_t oled_scale_glyph(const uint8_t *src, uint8_t scale, uint8_t smooth, uint8_t *out)
+{
+    if (scale < 1) scale = 1;
+    if (scale > OLED_SCALE_MAX) scale = OLED_SCALE_MAX;
+
+    uint8_t w = (uint8_t)(OLED_SCALE_SRC_W * scale);
+
+    if (scale == 1) {
+        for (uint8_t c = 0; c < OLED_SCALE_SRC_W; c++) out[c] = src[c];
+        return w;
+    }
+
+    if (smooth && (scale == 2 || scale == 4)) {
+        for (uint8_t c = 0; c < OLED_SCALE_SRC_W; c++) {
+            uint16_t l, r;
+            scale_epx_col(src, c, &l, &r);
+            if (scale == 2) {
+                scale_put_col(out, w, 2, (uint8_t)(2 * c), l);
+                scale_put_col(out, w, 2, (uint8_t)(2 * c + 1), r);
+            } else {
+                uint32_t l4 = scale_expand16x2(l);
+                uint32_t r4 = scale_expand16x2(r);
+                scale_put_col(out, w, 4, (uint8_t)(4 * c), l4);
+                scale_put_col(out, w, 4, (uint8_t)(4 * c + 1), l4);
+                scale_put_col(out, w, 4, (uint8_t)(4 * c + 2), r4);
+                scale_put_col(out, w, 4, (uint8_t)(4 * c + 3), r4);
+            }
+        }
+        return w;
+    }
+
+    for (uint8_t c = 0; c < OLED_SCALE_SRC_W; c++) {
+        uint32_t bits = scale_expand8(src[c], scale);
+        for (uint8_t k = 0; k < scale; k++) {
+            scale_put_col(out, w, scale, (uint8_t)(c * scale + k), bits);
+        }
+    }
+    return w;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file oled_scale.h
+ * @brief 由 6x8 基础字模实时生成 2x / 3x / 4x 放大字模 (半字节查表展开)
+ * @note  与硬件无关。大号数字不必再存 asc2_1608 / asc2_2412 (共约 5KB Flash)：
+ *        每个源列字节拆成两个半字节，查表得到纵向放大后的 2~4 个页字节，再横向重复，
+ *        没有逐像素循环。可选 EPX (Scale2x) 平滑，同样按位并行处理一整列。
+ */
+
+#ifndef __OLED_SCALE_H__
+#define __OLED_SCALE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define OLED_SCALE_SRC_W     6u                              /* 源字模宽度 (asc2_0806) */
+#define OLED_SCALE_MAX       4u
+#define OLED_SCALE_BUF_LEN   (OLED_SCALE_SRC_W * OLED_SCALE_MAX * OLED_SCALE_MAX)  /* 4x: 24 列 x 4 页 */
+
+/**
+ * @brief 生成放大字模
+ * @param src    6 字节的 6x8 字模 (asc2_0806 中的一项)
+ * @param scale  放大倍数 1~4 (超出范围按 4)
+ * @param smooth 非 0 时做 EPX 斜边平滑 (对 2x、4x 生效，3x 忽略)
+ * @param out    输出缓冲区，至少 6*scale*scale 字节；格式与 font.h 相同 (第 0 页 6*scale 字节，第 1 页……)
+ * @return 输出宽度 (像素列数 = 6*scale)，高度为 8*scale (scale 页)
+ */
+uint8_t oled_scale_glyph(const uint8_t *src, uint8_t scale, uint8_t smooth, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OLED_SCALE_H__ */
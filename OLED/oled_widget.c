@@ -0,0 +1,267 @@
+/**
+ * @file oled_widget.c
+ * @brief 保留模式小部件实现
+ */
+
+#include "oled_widget.h"
+#include <string.h>
+
+static oled_widget_t *ui_head = NULL;
+
+/* ================= 内部工具 ================= */
+
+static void ui_attach(oled_widget_t *w, uint8_t type, uint8_t x, uint8_t y, uint8_t width, uint8_t height)
+{
+    oled_widget_t **pp = &ui_head;
+
+    // 同一个部件重复初始化：先从链表里摘下来，否则追加时会把自己接到自己后面
+    while (*pp) {
+        if (*pp == w) {
+            *pp = w->next;
+            break;
+        }
+        pp = &(*pp)->next;
+    }
+
+    memset(w, 0, sizeof(oled_widget_t));
+    w->type = type;
+    w->x = x;
+    w->y = y;
+    w->w = width;
+    w->h = height;
+    w->dirty = 1;
+
+    // 追加到链表尾部，保持创建顺序 (后创建的画在上层)
+    pp = &ui_head;
+    while (*pp) pp = &(*pp)->next;
+    *pp = w;
+}
+
+/**
+ * @brief 把 value 按 [min, max] 线性映射到 [0, span]
+ */
+static uint8_t ui_scale(int32_t value, int32_t min, int32_t max, uint8_t span)
+{
+    if (max <= min || value <= min) return 0;
+    if (value >= max) return span;
+    return (uint8_t)(((int64_t)(value - min) * span) / (max - min));
+}
+
+/**
+ * @brief 定点数转字符串 (不走 printf，steady-state 只在值变化时才调用)
+ * @return 字符数
+ */
+static uint8_t ui_format_fixed(char *buf, int32_t value, uint8_t decimals)
+{
+    char tmp[OLED_UI_DECIMALS_MAX + 3];    // 最多 10 位数字 + 小数点
+    uint8_t n = 0;
+    uint32_t u = (value < 0) ? (0u - (uint32_t)value) : (uint32_t)value;
+
+    // 从低位往高位写；小数位不足时补 0，保证 "0.05" 这样的前导零
+    do {
+        tmp[n++] = (char)('0' + u % 10u);
+        u /= 10u;
+        if (n == decimals) tmp[n++] = '.';
+    } while (u || n <= decimals + (decimals ? 1u : 0u));
+
+    uint8_t len = 0;
+    if (value < 0) buf[len++] = '-';
+    while (n) buf[len++] = tmp[--n];
+    buf[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief 把一个部件记录进显示列表
+ */
+static void ui_record(const oled_widget_t *w)
+{
+    uint8_t cw, ch;
+
+    switch (w->type) {
+    case OLED_UI_LABEL:
+        oled_dl_text(w->x, w->y, (OLED_FontSize)w->font, OLED_DL_SET, w->u.label.text);
+        break;
+
+    case OLED_UI_NUMBER: {
+        char buf[OLED_UI_TEXT_MAX + 16];
+        uint8_t len = ui_format_fixed(buf, w->u.number.value, w->u.number.decimals);
+        if (w->u.number.unit) {
+            strncpy(&buf[len], w->u.number.unit, sizeof(buf) - len - 1);
+            buf[sizeof(buf) - 1] = '\0';
+            len = (uint8_t)strlen(buf);
+        }
+        if (len > w->u.number.chars) {
+            len = w->u.number.chars;    // 放不下就截断，不能画出自己的矩形
+            buf[len] = '\0';
+        }
+        oled_dl_font_size((OLED_FontSize)w->font, &cw, &ch);
+        oled_dl_text((uint8_t)(w->x + (w->u.number.chars - len) * cw), w->y,
+                     (OLED_FontSize)w->font, OLED_DL_SET, buf);
+        break;
+    }
+
+    case OLED_UI_BAR:
+        oled_dl_rect(w->x, w->y, w->w, w->h, OLED_DL_SET);
+        if (w->u.bar.fill && w->h > 2) {
+            oled_dl_fill((uint8_t)(w->x + 1), (uint8_t)(w->y + 1), w->u.bar.fill, (uint8_t)(w->h - 2), OLED_DL_SET);
+        }
+        break;
+
+    case OLED_UI_SPARK:
+        oled_dl_plot(w->x, w->y, w->w, w->h, w->u.spark.samples, w->u.spark.head, OLED_DL_SET);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 部件 o 是否落在 [x0, x1) x [y0, y1) 内 (相交 / 完全包含)
+ */
+static uint8_t ui_overlaps(const oled_widget_t *o, int16_t x0, int16_t x1, int16_t y0, int16_t y1)
+{
+    return o->x < x1 && o->x + o->w > x0 && o->y < y1 && o->y + o->h > y0;
+}
+
+static uint8_t ui_inside(const oled_widget_t *o, int16_t x0, int16_t x1, int16_t y0, int16_t y1)
+{
+    return o->x >= x0 && o->x + o->w <= x1 && o->y >= y0 && o->y + o->h <= y1;
+}
+
+/* ================= 创建 ================= */
+
+void oled_ui_label(oled_widget_t *w, uint8_t x, uint8_t y, OLED_FontSize font, uint8_t chars, const char *text)
+{
+    uint8_t cw, ch;
+    oled_dl_font_size(font, &cw, &ch);
+
+    ui_attach(w, OLED_UI_LABEL, x, y, (uint8_t)(chars * cw), ch);
+    w->font = (uint8_t)font;
+    if (text) {
+        strncpy(w->u.label.text, text, OLED_UI_TEXT_MAX - 1);
+    }
+}
+
+void oled_ui_number(oled_widget_t *w, uint8_t x, uint8_t y, OLED_FontSize font,
+                    uint8_t chars, uint8_t decimals, const char *unit)
+{
+    uint8_t cw, ch;
+    oled_dl_font_size(font, &cw, &ch);
+
+    ui_attach(w, OLED_UI_NUMBER, x, y, (uint8_t)(chars * cw), ch);
+    w->font = (uint8_t)font;
+    w->u.number.chars = chars;
+    w->u.number.decimals = (decimals > OLED_UI_DECIMALS_MAX) ? OLED_UI_DECIMALS_MAX : decimals;
+    w->u.number.unit = unit;
+}
+
+void oled_ui_bar(oled_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height, int32_t min, int32_t max)
+{
+    ui_attach(w, OLED_UI_BAR, x, y, width, height);
+    w->u.bar.min = min;
+    w->u.bar.max = max;
+}
+
+void oled_ui_spark(oled_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+                   int32_t min, int32_t max, uint8_t *samples)
+{
+    ui_attach(w, OLED_UI_SPARK, x, y, width, height);
+    w->u.spark.min = min;
+    w->u.spark.max = max;
+    w->u.spark.samples = samples;
+    memset(samples, 0, width);
+}
+
+/* ================= 更新 ================= */
+
+void oled_ui_set_text(oled_widget_t *w, const char *text)
+{
+    if (w->type != OLED_UI_LABEL) return;
+    if (strncmp(w->u.label.text, text, OLED_UI_TEXT_MAX - 1) == 0) return;
+
+    strncpy(w->u.label.text, text, OLED_UI_TEXT_MAX - 1);
+    w->dirty = 1;
+}
+
+void oled_ui_set_value(oled_widget_t *w, int32_t value)
+{
+    switch (w->type) {
+    case OLED_UI_NUMBER:
+        if (w->u.number.value != value) {
+            w->u.number.value = value;
+            w->dirty = 1;
+        }
+        break;
+
+    case OLED_UI_BAR: {
+        uint8_t fill = (w->w > 2) ? ui_scale(value, w->u.bar.min, w->u.bar.max, (uint8_t)(w->w - 2)) : 0;
+        if (w->u.bar.fill != fill) {
+            w->u.bar.fill = fill;
+            w->dirty = 1;
+        }
+        break;
+    }
+
+    case OLED_UI_SPARK:
+        oled_ui_push(w, value);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void oled_ui_push(oled_widget_t *w, int32_t value)
+{
+    if (w->type != OLED_UI_SPARK || w->w == 0 || w->h == 0) return;
+
+    w->u.spark.samples[w->u.spark.head] = ui_scale(value, w->u.spark.min, w->u.spark.max, (uint8_t)(w->h - 1));
+    w->u.spark.head = (uint8_t)((w->u.spark.head + 1u) % w->w);
+    w->dirty = 1;   // 整条波形左移，一定要重画
+}
+
+uint8_t oled_ui_update(void)
+{
+    uint8_t count = 0;
+
+    for (oled_widget_t *d = ui_head; d; d = d->next) {
+        if (!d->dirty) continue;
+
+        // flush_area 写出的是整页高度，所以要把同一页带、同一列范围内的邻居一起画上
+        int16_t x0 = d->x;
+        int16_t x1 = (int16_t)(d->x + d->w);
+        int16_t y0 = (int16_t)(d->y & ~7);
+        int16_t y1 = (int16_t)((d->y + d->h + 7) & ~7);
+
+        oled_dl_begin();
+        for (oled_widget_t *o = ui_head; o; o = o->next) {
+            if (ui_overlaps(o, x0, x1, y0, y1)) {
+                ui_record(o);
+            }
+        }
+        oled_dl_flush_area(d->x, d->y, d->w, d->h);
+
+        // 完整落在这次写出范围内的部件也已经是最新的了
+        for (oled_widget_t *o = d; o; o = o->next) {
+            if (o->dirty && ui_inside(o, x0, x1, y0, y1)) {
+                o->dirty = 0;
+            }
+        }
+        count++;
+    }
+    return count;
+}
+
+void oled_ui_invalidate(void)
+{
+    for (oled_widget_t *o = ui_head; o; o = o->next) {
+        o->dirty = 1;
+    }
+}
+
+void oled_ui_reset(void)
+{
+    ui_head = NULL;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file oled_widget.h
+ * @brief 保留模式小部件：标签、数值、进度条、波形，值不变就不重绘
+ * @note  每个部件缓存上一次显示的值 (数值、进度条的像素长度、文本)，
+ *        只有值真正变化时才标脏；oled_ui_update() 只重新渲染脏部件所在的矩形，
+ *        稳定画面下每帧的开销只剩几次比较。渲染复用 oled_dlist 的条带栅格化。
+ */
+
+#ifndef __OLED_WIDGET_H__
+#define __OLED_WIDGET_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "oled_dlist.h"
+
+/* ================= 用户配置区 ================= */
+
+/* 标签文本缓存长度 (含结尾 0) */
+#define OLED_UI_TEXT_MAX    20
+
+/* 数值部件小数位上限：int32 最多 10 位数字，再多只是补前导零 (超出的按上限处理) */
+#define OLED_UI_DECIMALS_MAX    9
+
+typedef enum {
+    OLED_UI_LABEL = 0,
+    OLED_UI_NUMBER,
+    OLED_UI_BAR,
+    OLED_UI_SPARK,
+} oled_ui_type_t;
+
+/**
+ * @brief 部件 (由调用者静态分配，初始化函数会把它挂进屏幕的部件链表)
+ * @note  对已经挂在链表里的部件再调用初始化函数等于重新创建：先摘下再挂到尾部 (画在最上层)
+ */
+typedef struct oled_widget {
+    struct oled_widget *next;
+    uint8_t type;
+    uint8_t x, y, w, h;             // 占用的矩形 (像素)
+    uint8_t font;
+    uint8_t dirty;
+    union {
+        struct {
+            char text[OLED_UI_TEXT_MAX];
+        } label;
+        struct {
+            int32_t value;
+            uint8_t chars;          // 显示宽度 (字符数，右对齐)
+            uint8_t decimals;       // 定点小数位数：value = 253, decimals = 1 -> "25.3"
+            const char *unit;       // 单位后缀，可为 NULL
+        } number;
+        struct {
+            int32_t min, max;
+            uint8_t fill;           // 缓存的是像素长度：值变了但长度没变也不重绘
+        } bar;
+        struct {
+            int32_t min, max;
+            uint8_t *samples;       // 调用者提供，长度 = w，存放换算后的像素高度
+            uint8_t head;           // 最旧的采样
+        } spark;
+    } u;
+} oled_widget_t;
+
+/**
+ * @brief 文本标签
+ * @param chars 占用宽度 (字符数)，新文本较短时多出的部分会被擦除
+ */
+void oled_ui_label(oled_widget_t *w, uint8_t x, uint8_t y, OLED_FontSize font, uint8_t chars, const char *text);
+
+/**
+ * @brief 定点数值 (右对齐)，例如 chars = 6、decimals = 1、unit = "C" 显示 " 25.3C"
+ * @note  decimals 超过 OLED_UI_DECIMALS_MAX 时按上限处理
+ */
+void oled_ui_number(oled_widget_t *w, uint8_t x, uint8_t y, OLED_FontSize font,
+                    uint8_t chars, uint8_t decimals, const char *unit);
+
+/**
+ * @brief 水平进度条 (带 1 像素边框)
+ */
+void oled_ui_bar(oled_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height, int32_t min, int32_t max);
+
+/**
+ * @brief 滚动波形，每 push 一个值向左移动一列
+ * @param samples 长度为 width 的缓冲区
+ */
+void oled_ui_spark(oled_widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+                   int32_t min, int32_t max, uint8_t *samples);
+
+/**
+ * @brief 更新标签文本 / 数值 / 进度条的值 (值没变化时什么都不做)
+ */
+void oled_ui_set_text(oled_widget_t *w, const char *text);
+void oled_ui_set_value(oled_widget_t *w, int32_t value);
+
+/**
+ * @brief 波形追加一个采样
+ */
+void oled_ui_push(oled_widget_t *w, int32_t value);
+
+/**
+ * @brief 重绘所有脏部件，只写出它们所在的矩形
+ * @note  会清空 oled_dlist 的命令缓冲区 (部件渲染借用它)
+ * @return 本次重绘的部件个数
+ */
+uint8_t oled_ui_update(void);
+
+/**
+ * @brief 全部部件标脏 (清屏或切换页面后调用)
+ */
+void oled_ui_invalidate(void);
+
+/**
+ * @brief 清空部件链表 (切换到新页面前调用)
+ */
+void oled_ui_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OLED_WIDGET_H__ */
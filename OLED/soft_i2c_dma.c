@@ -0,0 +1,224 @@
+#include "soft_i2c_dma.h"
+
+#if SOFT_I2C_USE_DMA
+
+#include <string.h>
+
+/* BSRR 写入值：低 16 位置位，高 16 位复位；0 表示保持不变 */
+#define W_SCL_H     ((uint32_t)OLED_SCL_PIN)
+#define W_SCL_L     ((uint32_t)OLED_SCL_PIN << 16)
+#define W_SDA_H     ((uint32_t)OLED_SDA_PIN)
+#define W_SDA_L     ((uint32_t)OLED_SDA_PIN << 16)
+#define W_NOP       0u
+
+#define HALF_WORDS  (SOFT_I2C_DMA_HALF_UNITS * 3u)
+
+/* 编码器阶段 */
+enum {
+    SID_IDLE = 0,
+    SID_START,
+    SID_BYTES,
+    SID_STOP,
+};
+
+/**
+ * @brief 排队中的写事务
+ */
+typedef struct {
+    const uint8_t *data;
+    uint16_t len;
+    uint8_t addr;
+    uint8_t ctrl;
+    uint8_t inline_buf[SOFT_I2C_DMA_INLINE];
+} sid_xfer_t;
+
+/* 双半区波形缓冲区 */
+static uint32_t sid_wave[2 * HALF_WORDS];
+static uint8_t sid_has_data[2];
+
+/* 单生产者 (提交方) / 单消费者 (DMA 中断) 队列 */
+static sid_xfer_t sid_queue[SOFT_I2C_DMA_QUEUE];
+static volatile uint8_t sid_q_head = 0;
+static volatile uint8_t sid_q_tail = 0;
+
+/* 编码器状态 (只在中断或引擎停止时访问) */
+static uint8_t sid_phase = SID_IDLE;
+static uint16_t sid_index;      // 0 = 地址, 1 = 控制字节, 2.. = 负载
+static uint8_t sid_bit;         // 0~7 数据位, 8 = ACK 时钟
+static volatile uint8_t sid_running = 0;
+
+/**
+ * @brief 生成下一个 3 字单元
+ * @return 0 表示队列已空，没有更多波形
+ */
+static uint8_t sid_next_unit(uint32_t *w)
+{
+    const sid_xfer_t *x = &sid_queue[sid_q_tail];
+
+    switch (sid_phase) {
+    case SID_IDLE:
+        if (sid_q_tail == sid_q_head) {
+            return 0;
+        }
+        /* fall through */
+    case SID_START:
+        // 第一拍保持空闲电平，兼作两个事务之间的总线空闲时间
+        w[0] = W_NOP;
+        w[1] = W_SDA_L;
+        w[2] = W_SCL_L;
+        sid_phase = SID_BYTES;
+        sid_index = 0;
+        sid_bit = 0;
+        return 1;
+
+    case SID_BYTES: {
+        uint8_t byte = (sid_index == 0) ? x->addr :
+                       (sid_index == 1) ? x->ctrl : x->data[sid_index - 2];
+
+        // 第 9 个时钟释放 SDA 给从机应答
+        w[0] = (sid_bit == 8 || (byte & (0x80u >> sid_bit))) ? W_SDA_H : W_SDA_L;
+        w[1] = W_SCL_H;
+        w[2] = W_SCL_L;
+
+        if (++sid_bit == 9) {
+            sid_bit = 0;
+            if (++sid_index == x->len + 2u) {
+                sid_phase = SID_STOP;
+            }
+        }
+        return 1;
+    }
+
+    case SID_STOP:
+    default:
+        w[0] = W_SDA_L;
+        w[1] = W_SCL_H;
+        w[2] = W_SDA_H;
+        sid_phase = SID_IDLE;
+        sid_q_tail = (uint8_t)((sid_q_tail + 1) % SOFT_I2C_DMA_QUEUE);
+        return 1;
+    }
+}
+
+/**
+ * @brief 填充半个缓冲区，剩余部分补 NOP
+ */
+static void sid_fill(uint8_t half)
+{
+    uint32_t *w = &sid_wave[half * HALF_WORDS];
+    uint16_t u = 0;
+
+    while (u < SOFT_I2C_DMA_HALF_UNITS && sid_next_unit(w)) {
+        w += 3;
+        u++;
+    }
+    sid_has_data[half] = (u != 0);
+
+    if (u < SOFT_I2C_DMA_HALF_UNITS) {
+        memset(w, 0, (SOFT_I2C_DMA_HALF_UNITS - u) * 3u * sizeof(uint32_t));
+    }
+}
+
+static void sid_stop(void)
+{
+    TIM_HandleTypeDef *htim = SOFT_I2C_DMA_TIM_HANDLE;
+
+    __HAL_TIM_DISABLE(htim);
+    __HAL_TIM_DISABLE_DMA(htim, TIM_DMA_UPDATE);
+    HAL_DMA_Abort(htim->hdma[TIM_DMA_ID_UPDATE]);
+    sid_running = 0;
+}
+
+/**
+ * @brief 半区播放完毕：补充刚播完的那一半
+ * @note  两个半区都没有数据且队列为空时停止定时器。
+ *        正在播放的另一半全是 NOP，提前停下不会截断波形。
+ */
+static void sid_half_done(uint8_t half)
+{
+    sid_fill(half);
+
+    if (!sid_has_data[0] && !sid_has_data[1] && sid_phase == SID_IDLE &&
+        sid_q_tail == sid_q_head) {
+        sid_stop();
+    }
+}
+
+static void sid_dma_half_cplt(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    sid_half_done(0);
+}
+
+static void sid_dma_cplt(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    sid_half_done(1);
+}
+
+static void sid_start(void)
+{
+    TIM_HandleTypeDef *htim = SOFT_I2C_DMA_TIM_HANDLE;
+    DMA_HandleTypeDef *hdma = htim->hdma[TIM_DMA_ID_UPDATE];
+
+    sid_fill(0);
+    sid_fill(1);
+    sid_running = 1;
+
+    hdma->XferHalfCpltCallback = sid_dma_half_cplt;
+    hdma->XferCpltCallback = sid_dma_cplt;
+    HAL_DMA_Start_IT(hdma, (uint32_t)sid_wave, (uint32_t)&OLED_SCL_PORT->BSRR, 2u * HALF_WORDS);
+
+    __HAL_TIM_SET_COUNTER(htim, 0);
+    __HAL_TIM_ENABLE_DMA(htim, TIM_DMA_UPDATE);
+    __HAL_TIM_ENABLE(htim);
+}
+
+void soft_i2c_dma_init(void)
+{
+    sid_q_head = 0;
+    sid_q_tail = 0;
+    sid_phase = SID_IDLE;
+    sid_running = 0;
+}
+
+void soft_i2c_dma_write(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint16_t len)
+{
+    uint8_t next = (uint8_t)((sid_q_head + 1) % SOFT_I2C_DMA_QUEUE);
+
+    // 队列满：等中断把最早的事务发完
+    while (next == sid_q_tail) {
+    }
+
+    sid_xfer_t *x = &sid_queue[sid_q_head];
+    x->addr = addr;
+    x->ctrl = ctrl;
+    x->len = len;
+    if (len <= SOFT_I2C_DMA_INLINE) {
+        memcpy(x->inline_buf, data, len);
+        x->data = x->inline_buf;
+    } else {
+        x->data = data;
+    }
+
+    // 先发布事务再检查引擎状态：中断要么看到新事务继续跑，要么已经停下由这里重新启动
+    // (引擎停止后中断不会再来，这里启动不会和中断冲突)
+    sid_q_head = next;
+
+    if (!sid_running) {
+        sid_start();
+    }
+}
+
+uint8_t soft_i2c_dma_busy(void)
+{
+    return sid_running || (sid_q_head != sid_q_tail);
+}
+
+void soft_i2c_dma_wait(void)
+{
+    while (soft_i2c_dma_busy()) {
+    }
+}
+
+#endif /* SOFT_I2C_USE_DMA */
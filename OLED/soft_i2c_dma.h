@@ -0,0 +1,78 @@
+#ifndef __SOFT_I2C_DMA_H
+#define __SOFT_I2C_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "soft_oled.h" // 复用 OLED_SCL/SDA 引脚定义
+
+/* * 定时器 + DMA 软件 I2C 波形引擎
+ * CPU 只负责把字节翻译成 GPIO BSRR 字，定时器每个更新事件触发一次 DMA，
+ * 把一个字写进 BSRR —— I2C 时序由定时器保证，传输期间 CPU 完全空闲。
+ *
+ * 每 3 个字 (3 个定时器节拍) 一个单元：
+ *   数据位:  SDA=位值 | SCL 高 | SCL 低     (低电平 2 拍，高电平 1 拍)
+ *   ACK:    SDA 释放 | SCL 高 | SCL 低     (只打时钟，不检查应答)
+ *   START:  空闲     | SDA 低 | SCL 低
+ *   STOP:   SDA 低   | SCL 高 | SDA 高
+ * 一个字节 27 个字。波形缓冲区分成两半循环播放，每播完一半在 DMA 中断里补下一半，
+ * 所以大块数据也只占固定的 RAM。
+ *
+ * ⚠️ SCL 和 SDA 必须在同一个 GPIO 端口 (共用一个 BSRR)。
+ * ⚠️ F4/F7 上只有 DMA2 能访问 AHB1 的 GPIO，请选 TIM1/TIM8 的 UP 请求。
+ */
+
+/* ================= 用户配置区 ================= */
+
+/* 节拍定时器：CubeMX 中把更新频率配置为 SOFT_I2C_DMA_TICK_HZ，并添加 TIMx_UP 的 DMA：
+ * Memory To Peripheral，Circular，Word/Word，内存地址递增，外设地址不递增 */
+extern TIM_HandleTypeDef htim1;
+#define SOFT_I2C_DMA_TIM_HANDLE  (&htim1)
+
+/* 节拍频率：SCL 频率 = 节拍 / 3。1.2MHz -> 400kHz (低 1.67us / 高 0.83us，满足 Fast-mode) */
+#define SOFT_I2C_DMA_TICK_HZ     1200000u
+
+/* 每半个缓冲区容纳的单元数 (1 单元 = 3 字 = 12 字节)。36 单元 = 4 个字节，
+ * 总 RAM 864 字节，每 90us (400kHz 下) 进一次 DMA 中断 */
+#define SOFT_I2C_DMA_HALF_UNITS  36
+
+/* 事务队列深度：提交后立即返回，队列满时才等待 */
+#define SOFT_I2C_DMA_QUEUE       8
+
+/* 不超过这个长度的负载在提交时拷贝进队列 (命令字等栈上的数据)，
+ * 更长的负载只记录指针，发送完成前调用者必须保证数据有效 (字库、静态缓冲区) */
+#define SOFT_I2C_DMA_INLINE      4
+
+/**
+ * @brief 初始化 (GPIO 需已配置为开漏输出并处于空闲高电平)
+ */
+void soft_i2c_dma_init(void);
+
+/**
+ * @brief 提交一次写事务: START | addr | ctrl | data[0..len-1] | STOP
+ * @note  非阻塞。引擎空闲时立即启动定时器和 DMA；正在发送时排队，
+ *        上一个事务的 STOP 之后无缝接着发送。队列满时等待。
+ * @param addr 8 位从机地址 (写)
+ * @param ctrl 控制字节 (SSD1306 的 0x00 命令 / 0x40 数据)
+ * @param data 负载，长度超过 SOFT_I2C_DMA_INLINE 时只保存指针
+ * @param len 负载长度
+ */
+void soft_i2c_dma_write(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 是否还有事务在发送或排队
+ */
+uint8_t soft_i2c_dma_busy(void);
+
+/**
+ * @brief 等待所有事务发送完成
+ */
+void soft_i2c_dma_wait(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SOFT_I2C_DMA_H */
@@ -2,6 +2,44 @@
 #include "delay_us.h"  // 包含你上传的高精度延时
 #include <stdarg.h>
 #include <stdio.h>
+#if OLED_USE_FAST_FMT
+#include "fast_fmt.h"
+#endif
+#if defined(USE_DWT_TRACE)
+#include "dwt_trace.h"
+#endif
+#if SOFT_I2C_USE_DMA
+#include "soft_i2c_dma.h"
+#endif
+#if defined(USE_DRV_STATS)
+#include "drv_stats.h"
+#include <string.h>
+#endif
+#if OLED_USE_IMAGE
+#include "oled_image.h"
+#endif
+#if OLED_USE_SCALE
+#include "oled_scale.h"
+#endif
+
+#if defined(USE_DRV_STATS)
+static SoftOLED_Stats_t soft_oled_stats;
+
+/**
+ * @brief 记一次 I2C 事务：len 为负载长度，t0 为开始时的周期计数
+ */
+static inline void SoftOLED_StatXfer(uint32_t t0, uint16_t len)
+{
+    soft_oled_stats.xfers++;
+    soft_oled_stats.bytes += 2u + len;
+    soft_oled_stats.busy_cycles += DRV_STATS_CYCLES() - t0;
+}
+#define SOFT_STAT_BEGIN()       uint32_t stat_t0 = DRV_STATS_CYCLES()
+#define SOFT_STAT_END(len)      SoftOLED_StatXfer(stat_t0, (len))
+#else
+#define SOFT_STAT_BEGIN()       ((void)0)
+#define SOFT_STAT_END(len)      ((void)0)
+#endif
 
 /* --- I2C 底层宏操作 (开漏输出模式) --- */
 /* * 硬件老王注：
@@ -9,6 +47,34 @@
  * 写 1 就是释放总线(高电平)，写 0 就是拉低。
  * 读数据时不需要切换输入/输出模式，直接读 IDR 即可！
  */
+#if defined(SOFT_I2C_CPU_HZ)
+
+#if !defined(DWT_BASE)
+#error "SOFT_I2C_CPU_HZ 需要 DWT 周期计数器，Cortex-M0/M0+ 请使用运行时 delay_us 路径"
+#endif
+
+/* 编译期模式：直接写 BSRR (低 16 位置位，高 16 位复位)，省掉 HAL 调用开销 */
+#define OLED_SCL_H()    (OLED_SCL_PORT->BSRR = OLED_SCL_PIN)
+#define OLED_SCL_L()    (OLED_SCL_PORT->BSRR = (uint32_t)OLED_SCL_PIN << 16)
+
+#define OLED_SDA_H()    (OLED_SDA_PORT->BSRR = OLED_SDA_PIN)
+#define OLED_SDA_L()    (OLED_SDA_PORT->BSRR = (uint32_t)OLED_SDA_PIN << 16)
+
+/**
+ * @brief 常量周期自旋
+ * @note  cycles 是编译期常量，内联后整段折叠为 "读 CYCCNT + 比较立即数" 的紧凑循环
+ */
+__STATIC_INLINE void I2C_SpinCycles(uint32_t cycles)
+{
+    uint32_t start = DWT->CYCCNT;
+    while ((DWT->CYCCNT - start) < cycles) {
+    }
+}
+
+#define I2C_DELAY()     I2C_SpinCycles(SOFT_I2C_WAIT_CYCLES)
+
+#else
+
 #define OLED_SCL_H()    HAL_GPIO_WritePin(OLED_SCL_PORT, OLED_SCL_PIN, GPIO_PIN_SET)
 #define OLED_SCL_L()    HAL_GPIO_WritePin(OLED_SCL_PORT, OLED_SCL_PIN, GPIO_PIN_RESET)
 
@@ -19,7 +85,10 @@
 // 得益于 DWT，这个 1us 在任何主频下都是精准的 1us
 #define I2C_DELAY()     delay_us(1) 
 
+#endif /* SOFT_I2C_CPU_HZ */
+
 /* ================= 软件 I2C 驱动层 ================= */
+#if !SOFT_I2C_USE_DMA && SOFT_I2C_LANES == 1
 
 /**
  * @brief I2C 起始信号
@@ -40,6 +109,7 @@ static void I2C_Start(void)
 static void I2C_Stop(void)
 {
     OLED_SDA_L();
+    I2C_DELAY();  // 上一个 ACK 时钟刚拉低 SCL：保证低电平和 SDA 建立时间
     OLED_SCL_H();
     I2C_DELAY();
     OLED_SDA_H(); // SCL高期间，SDA拉高 -> STOP
@@ -65,6 +135,25 @@ static void I2C_WaitAck(void)
  */
 static void I2C_SendByte(uint8_t byte)
 {
+#if defined(SOFT_I2C_CPU_HZ)
+    /* 编译期模式：8 位完全展开，每个半周期都是常量自旋，没有循环计数开销 */
+#define I2C_SEND_BIT(mask)                          \
+    do {                                            \
+        if (byte & (mask)) OLED_SDA_H();            \
+        else               OLED_SDA_L();            \
+        I2C_DELAY();                                \
+        OLED_SCL_H();                               \
+        I2C_DELAY();                                \
+        OLED_SCL_L();                               \
+    } while (0)
+
+    I2C_SEND_BIT(0x80); I2C_SEND_BIT(0x40);
+    I2C_SEND_BIT(0x20); I2C_SEND_BIT(0x10);
+    I2C_SEND_BIT(0x08); I2C_SEND_BIT(0x04);
+    I2C_SEND_BIT(0x02); I2C_SEND_BIT(0x01);
+
+#undef I2C_SEND_BIT
+#else
     uint8_t i;
     for (i = 0; i < 8; i++)
     {
@@ -79,21 +168,177 @@ static void I2C_SendByte(uint8_t byte)
         I2C_DELAY();
         OLED_SCL_L(); // 拉低 SCL 准备下一位
     }
+#endif
     I2C_WaitAck();
 }
+#endif /* !SOFT_I2C_USE_DMA && SOFT_I2C_LANES == 1 */
+
+#if SOFT_I2C_LANES > 1
+/* ================= 多路并行 I2C ================= */
+
+static const uint16_t lane_sda[SOFT_I2C_LANES] = SOFT_I2C_LANE_SDA_PINS;
+static uint16_t lane_sda_all;
+/* 位平面 (bit i = 第 i 路的数据位) -> BSRR 写入值，置位与复位一次完成 */
+static uint32_t lane_bsrr[1u << SOFT_I2C_LANES];
+
+static void I2C_Lanes_Init(void)
+{
+    lane_sda_all = 0;
+    for (uint8_t l = 0; l < SOFT_I2C_LANES; l++) {
+        lane_sda_all |= lane_sda[l];
+    }
+    for (uint16_t m = 0; m < (1u << SOFT_I2C_LANES); m++) {
+        uint16_t set = 0;
+        for (uint8_t l = 0; l < SOFT_I2C_LANES; l++) {
+            if (m & (1u << l)) set |= lane_sda[l];
+        }
+        lane_bsrr[m] = set | ((uint32_t)(lane_sda_all & ~set) << 16);
+    }
+}
+
+#define LANES_SDA_H()   (OLED_SCL_PORT->BSRR = lane_sda_all)
+#define LANES_SDA_L()   (OLED_SCL_PORT->BSRR = (uint32_t)lane_sda_all << 16)
+
+static void I2C_Lanes_Start(void)
+{
+    LANES_SDA_H();
+    OLED_SCL_H();
+    I2C_DELAY();
+    LANES_SDA_L();
+    I2C_DELAY();
+    OLED_SCL_L();
+}
 
+static void I2C_Lanes_Stop(void)
+{
+    LANES_SDA_L();
+    I2C_DELAY();
+    OLED_SCL_H();
+    I2C_DELAY();
+    LANES_SDA_H();
+    I2C_DELAY();
+}
 
+/**
+ * @brief 8x8 位矩阵转置：输入第 l 个字节是第 l 路的数据，
+ *        输出第 b 个字节的第 l 位是第 l 路数据的第 b 位
+ */
+static inline uint64_t I2C_Lanes_Transpose(uint64_t x)
+{
+    uint64_t t;
+    t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAull; x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull; x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull; x = x ^ t ^ (t << 28);
+    return x;
+}
 
 /**
- * @brief 写命令
+ * @brief 每路各发一个字节：先转置成 8 个位平面，每位只写一次 BSRR
  */
-static void SoftOLED_WriteCmd(uint8_t cmd)
+static void I2C_Lanes_SendByte(const uint8_t bytes[SOFT_I2C_LANES])
 {
+    uint64_t x = 0;
+    for (uint8_t l = 0; l < SOFT_I2C_LANES; l++) {
+        x |= (uint64_t)bytes[l] << (8 * l);
+    }
+    x = I2C_Lanes_Transpose(x);
+
+    for (int8_t b = 7; b >= 0; b--) {
+        OLED_SCL_PORT->BSRR = lane_bsrr[(uint8_t)(x >> (8 * b))];
+        I2C_DELAY();
+        OLED_SCL_H();
+        I2C_DELAY();
+        OLED_SCL_L();
+    }
+
+    // ACK 时钟 (所有路一起释放 SDA)
+    LANES_SDA_H();
+    I2C_DELAY();
+    OLED_SCL_H();
+    I2C_DELAY();
+    OLED_SCL_L();
+}
+
+/**
+ * @brief 所有路发送同一个字节 (地址、控制字节、广播命令)
+ */
+static void I2C_Lanes_SendCommon(uint8_t byte)
+{
+    for (int8_t b = 7; b >= 0; b--) {
+        if (byte & (1u << b)) LANES_SDA_H();
+        else                  LANES_SDA_L();
+        I2C_DELAY();
+        OLED_SCL_H();
+        I2C_DELAY();
+        OLED_SCL_L();
+    }
+    LANES_SDA_H();
+    I2C_DELAY();
+    OLED_SCL_H();
+    I2C_DELAY();
+    OLED_SCL_L();
+}
+
+/**
+ * @brief 一次事务里每路发送各自的数据
+ */
+static void I2C_Lanes_Write(uint8_t ctrl, const uint8_t *const data[SOFT_I2C_LANES], uint16_t len)
+{
+    uint8_t bytes[SOFT_I2C_LANES];
+
+    SOFT_STAT_BEGIN();
+    I2C_Lanes_Start();
+    I2C_Lanes_SendCommon(OLED_ADDR);
+    I2C_Lanes_SendCommon(ctrl);
+    for (uint16_t i = 0; i < len; i++) {
+        for (uint8_t l = 0; l < SOFT_I2C_LANES; l++) {
+            bytes[l] = data[l][i];
+        }
+        I2C_Lanes_SendByte(bytes);
+    }
+    I2C_Lanes_Stop();
+    SOFT_STAT_END(len);
+}
+
+static void I2C_Lanes_Broadcast(uint8_t ctrl, const uint8_t *data, uint16_t len)
+{
+    I2C_Lanes_Start();
+    I2C_Lanes_SendCommon(OLED_ADDR);
+    I2C_Lanes_SendCommon(ctrl);
+    for (uint16_t i = 0; i < len; i++) {
+        I2C_Lanes_SendCommon(data[i]);
+    }
+    I2C_Lanes_Stop();
+}
+#endif /* SOFT_I2C_LANES > 1 */
+
+/**
+ * @brief 一次事务连续发送多条命令 (控制字节 0x00 之后的字节全部按命令解析)
+ * @note  DMA 模式下超过 SOFT_I2C_DMA_INLINE 字节只记录指针，cmds 必须是静态数据
+ */
+static void SoftOLED_WriteCmds(const uint8_t *cmds, uint16_t len)
+{
+#if defined(USE_DWT_TRACE)
+    TRACE_BEGIN(TRACE_TRACK_OLED, TRACE_EVT_OLED_CMD, cmds[0]);
+#endif
+    SOFT_STAT_BEGIN();
+#if SOFT_I2C_USE_DMA
+    soft_i2c_dma_write(OLED_ADDR, OLED_CMD_MODE, cmds, len);
+#elif SOFT_I2C_LANES > 1
+    I2C_Lanes_Broadcast(OLED_CMD_MODE, cmds, len);
+#else
     I2C_Start();
     I2C_SendByte(OLED_ADDR);
     I2C_SendByte(OLED_CMD_MODE);
-    I2C_SendByte(cmd);
+    for (uint16_t i = 0; i < len; i++) {
+        I2C_SendByte(cmds[i]);
+    }
     I2C_Stop();
+#endif
+    SOFT_STAT_END(len);
+#if defined(USE_DWT_TRACE)
+    TRACE_END(TRACE_TRACK_OLED, TRACE_EVT_OLED_CMD, len);
+#endif
 }
 
 /**
@@ -101,11 +346,17 @@ static void SoftOLED_WriteCmd(uint8_t cmd)
  */
 static void SoftOLED_WriteData(uint8_t data)
 {
+#if SOFT_I2C_USE_DMA
+    soft_i2c_dma_write(OLED_ADDR, OLED_DATA_MODE, &data, 1);
+#elif SOFT_I2C_LANES > 1
+    I2C_Lanes_Broadcast(OLED_DATA_MODE, &data, 1);
+#else
     I2C_Start();
     I2C_SendByte(OLED_ADDR);
     I2C_SendByte(OLED_DATA_MODE);
     I2C_SendByte(data);
     I2C_Stop();
+#endif
 }
 
 /**
@@ -114,6 +365,16 @@ static void SoftOLED_WriteData(uint8_t data)
  */
 static void SoftOLED_WriteDataBlock(const uint8_t *data, uint16_t len)
 {
+#if defined(USE_DWT_TRACE)
+    TRACE_BEGIN(TRACE_TRACK_OLED, TRACE_EVT_OLED_WRITE, len);
+#endif
+    SOFT_STAT_BEGIN();
+#if SOFT_I2C_USE_DMA
+    // 只记录指针：data 必须在发送完成前保持有效 (字库在 Flash 中，清屏用静态缓冲区)
+    soft_i2c_dma_write(OLED_ADDR, OLED_DATA_MODE, data, len);
+#elif SOFT_I2C_LANES > 1
+    I2C_Lanes_Broadcast(OLED_DATA_MODE, data, len);
+#else
     I2C_Start();
     I2C_SendByte(OLED_ADDR);
     I2C_SendByte(OLED_DATA_MODE); // 开启连续数据传输模式
@@ -121,12 +382,18 @@ static void SoftOLED_WriteDataBlock(const uint8_t *data, uint16_t len)
         I2C_SendByte(data[i]);
     }
     I2C_Stop();
+#endif
+    SOFT_STAT_END(len);
+#if defined(USE_DWT_TRACE)
+    TRACE_END(TRACE_TRACK_OLED, TRACE_EVT_OLED_WRITE, len);
+#endif
 }
 
 /* ================= OLED 业务逻辑层 ================= */
 
 void SoftOLED_Init(void)
 {
+    static const uint8_t init_cmds[] = { OLED_PANEL_INIT };
     // 1. 初始化 DWT 延时 (这一步至关重要！)
     delay_init();
 
@@ -137,7 +404,12 @@ void SoftOLED_Init(void)
     // 这里假设用户使用的是 GPIOB，如果改了宏定义，这里记得改时钟
     __HAL_RCC_GPIOB_CLK_ENABLE(); 
 
+#if SOFT_I2C_LANES > 1
+    I2C_Lanes_Init();
+    GPIO_InitStruct.Pin = OLED_SCL_PIN | lane_sda_all;
+#else
     GPIO_InitStruct.Pin = OLED_SCL_PIN | OLED_SDA_PIN;
+#endif
     GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD; // [老师傅敲黑板] 必须开漏输出！
     GPIO_InitStruct.Pull = GPIO_PULLUP;         // 必须上拉
     GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH; // 高速模式
@@ -145,54 +417,147 @@ void SoftOLED_Init(void)
 
     // 3. 初始电平
     OLED_SCL_H();
+#if SOFT_I2C_LANES > 1
+    LANES_SDA_H();
+#else
     OLED_SDA_H();
-    delay_us(200); // 上电稳定等待
-
-    // 4. 发送初始化序列 (标准 SSD1306 初始化)
-    SoftOLED_WriteCmd(0xAE); // Display Off
-    SoftOLED_WriteCmd(0xD5); SoftOLED_WriteCmd(0x80);
-    SoftOLED_WriteCmd(0xA8); SoftOLED_WriteCmd(0x3F);
-    SoftOLED_WriteCmd(0xD3); SoftOLED_WriteCmd(0x00);
-    SoftOLED_WriteCmd(0x40);
-    SoftOLED_WriteCmd(0x8D); SoftOLED_WriteCmd(0x14); // Charge Pump Enable
-    SoftOLED_WriteCmd(0x20); SoftOLED_WriteCmd(0x02); // Page Addressing Mode
-    SoftOLED_WriteCmd(0xA1); // Segment Remap
-    SoftOLED_WriteCmd(0xC8); // COM Scan Direction
-    SoftOLED_WriteCmd(0xDA); SoftOLED_WriteCmd(0x12);
-    SoftOLED_WriteCmd(0x81); SoftOLED_WriteCmd(0xCF);
-    SoftOLED_WriteCmd(0xD9); SoftOLED_WriteCmd(0xF1);
-    SoftOLED_WriteCmd(0xDB); SoftOLED_WriteCmd(0x40);
-    SoftOLED_WriteCmd(0xA4);
-    SoftOLED_WriteCmd(0xA6);
-    SoftOLED_WriteCmd(0xAF); // Display On
+#endif
+
+#if SOFT_I2C_USE_DMA
+    soft_i2c_dma_init();
+#endif
 
+    // 4. 上电等待按截止时刻算 (从 HAL_Init 起)：节拍只有 1ms 分辨率，已走过的整毫秒直接抵扣，
+    //    剩下的用 delay_us 补足；前面的初始化用掉 1ms 以上就一点也不等
+    uint32_t tick = HAL_GetTick();
+    if (tick <= SOFT_OLED_POWERUP_US / 1000u && tick * 1000u < SOFT_OLED_POWERUP_US) {
+        delay_us(SOFT_OLED_POWERUP_US - tick * 1000u);
+    }
+
+    // 5. 初始化序列 (oled_panel.h 中按型号选定) 一次事务发完，Display On 留到清屏之后
+    SoftOLED_WriteCmds(init_cmds, sizeof(init_cmds) - 1);
     SoftOLED_Clear();
+    SoftOLED_WriteCmds(&init_cmds[sizeof(init_cmds) - 1], 1);
 }
 
 void SoftOLED_SetCursor(uint8_t x, uint8_t page)
 {
-    if (page > 7) page = 7;
-    if (x > 127) x = 127;
+    if (page > OLED_PANEL_MAX_PAGE) page = OLED_PANEL_MAX_PAGE;
+    if (x > OLED_PANEL_MAX_X) x = OLED_PANEL_MAX_X;
+    x += OLED_PANEL_COL_OFFSET;     // SH1106 / 72x40 的可见区不从第 0 列开始
 
-    SoftOLED_WriteCmd(0xB0 | page);
-    SoftOLED_WriteCmd(0x00 | (x & 0x0F));
-    SoftOLED_WriteCmd(0x10 | ((x >> 4) & 0x0F));
+    // 三条命令一次事务 (3 字节 <= SOFT_I2C_DMA_INLINE，DMA 模式下会被拷贝，栈变量安全)
+    uint8_t cmds[3] = { (uint8_t)(0xB0 | page), (uint8_t)(0x00 | (x & 0x0F)), (uint8_t)(0x10 | ((x >> 4) & 0x0F)) };
+    SoftOLED_WriteCmds(cmds, sizeof(cmds));
 }
 
 void SoftOLED_Clear(void)
 {
-    uint8_t zero_buf[128] = {0}; // 全0缓冲区
-    for (uint8_t i = 0; i < 8; i++) {
+    static const uint8_t zero_buf[OLED_PANEL_WIDTH] = {0}; // 全0缓冲区 (静态：DMA 模式下发送完成前必须有效)
+#if OLED_PANEL_HADDR
+    static const uint8_t frame_begin[] = { OLED_PANEL_FRAME_BEGIN };
+    static const uint8_t frame_end[] = { OLED_PANEL_FRAME_END };
+    SoftOLED_WriteCmds(frame_begin, sizeof(frame_begin)); // 水平寻址：各页首尾相接，不用逐页设光标
+    for (uint8_t i = 0; i < OLED_PANEL_PAGES; i++) {
+        SoftOLED_WriteDataBlock(zero_buf, OLED_PANEL_WIDTH);
+    }
+    SoftOLED_WriteCmds(frame_end, sizeof(frame_end));
+#else
+    for (uint8_t i = 0; i < OLED_PANEL_PAGES; i++) {
         SoftOLED_SetCursor(0, i);
-        SoftOLED_WriteDataBlock(zero_buf, 128); // 极速清屏
+        SoftOLED_WriteDataBlock(zero_buf, OLED_PANEL_WIDTH); // 极速清屏
     }
+#endif
 }
 
-void SoftOLED_ShowChar(uint8_t x, uint8_t page, char c, OLED_FontSize font)
+void SoftOLED_WriteFrame(const uint8_t *fb)
+{
+#if defined(USE_DRV_STATS)
+    uint32_t frame_t0 = DRV_STATS_CYCLES();
+#endif
+#if OLED_PANEL_HADDR
+    static const uint8_t frame_begin[] = { OLED_PANEL_FRAME_BEGIN };
+    static const uint8_t frame_end[] = { OLED_PANEL_FRAME_END };
+    SoftOLED_WriteCmds(frame_begin, sizeof(frame_begin));
+    SoftOLED_WriteDataBlock(fb, OLED_PANEL_FRAME_BYTES);   // 整帧一次突发
+    SoftOLED_WriteCmds(frame_end, sizeof(frame_end));
+#else
+    for (uint8_t i = 0; i < OLED_PANEL_PAGES; i++) {
+        SoftOLED_SetCursor(0, i);
+        SoftOLED_WriteDataBlock(fb + i * OLED_PANEL_WIDTH, OLED_PANEL_WIDTH);
+    }
+#endif
+#if SOFT_I2C_USE_DMA
+    soft_i2c_dma_wait(); // fb 通常马上要被下一帧改写
+#endif
+#if defined(USE_DRV_STATS)
+    uint32_t frame_cycles = DRV_STATS_CYCLES() - frame_t0;
+    soft_oled_stats.frames++;
+    soft_oled_stats.frame_last = frame_cycles;
+    if (frame_cycles > soft_oled_stats.frame_max) soft_oled_stats.frame_max = frame_cycles;
+#endif
+}
+
+#if defined(USE_DRV_STATS)
+void SoftOLED_GetStats(SoftOLED_Stats_t *out)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out = soft_oled_stats;
+    __set_PRIMASK(primask);
+}
+
+void SoftOLED_ResetStats(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(&soft_oled_stats, 0, sizeof(soft_oled_stats));
+    __set_PRIMASK(primask);
+}
+#endif
+
+void SoftOLED_WriteArea(uint8_t x, uint8_t page, const uint8_t *data, uint16_t len)
+{
+    SoftOLED_SetCursor(x, page);
+    SoftOLED_WriteDataBlock(data, len);
+#if SOFT_I2C_USE_DMA
+    soft_i2c_dma_wait(); // data 通常是调用者马上要复用的 RAM 缓冲区，必须等发完
+#endif
+}
+
+#if OLED_USE_IMAGE
+void SoftOLED_DrawImage(uint8_t x, uint8_t page, const uint8_t *img)
+{
+    uint8_t chunk[OLED_IMAGE_CHUNK];
+    oled_img_dec_t dec;
+    uint8_t w = OLED_IMG_WIDTH(img);
+    uint8_t pages = OLED_IMG_PAGES(img);
+
+    if (x > OLED_PANEL_MAX_X || page > OLED_PANEL_MAX_PAGE) return;
+    uint8_t vis_w = (x + w > OLED_PANEL_WIDTH) ? (uint8_t)(OLED_PANEL_WIDTH - x) : w;
+
+    oled_img_begin(&dec, img);
+    for (uint8_t p = 0; p < pages && page + p < OLED_PANEL_PAGES; p++) {
+        SoftOLED_SetCursor(x, page + p);
+        for (uint8_t col = 0; col < vis_w; ) {
+            uint8_t n = (vis_w - col > OLED_IMAGE_CHUNK) ? OLED_IMAGE_CHUNK : (uint8_t)(vis_w - col);
+            oled_img_read(&dec, chunk, n);
+            SoftOLED_WriteDataBlock(chunk, n);
+#if SOFT_I2C_USE_DMA
+            soft_i2c_dma_wait(); // 分段在栈上，发完才能解下一段
+#endif
+            col += n;
+        }
+        oled_img_skip(&dec, (uint16_t)(w - vis_w));
+    }
+}
+#endif
+
+/**
+ * @brief 查字模：返回 0 表示字体无效
+ */
+uint8_t SoftOLED_GetGlyph(char c, OLED_FontSize font, const uint8_t **glyph, uint8_t *width, uint8_t *pages)
 {
-    const uint8_t *glyph = NULL;
-    uint8_t width = 0, pages = 0;
-    
     // 字符偏移计算
     uint8_t idx = c - ' ';
     if (c < ' ' || c > '~') idx = 0; // 简单保护
@@ -200,23 +565,32 @@ void SoftOLED_ShowChar(uint8_t x, uint8_t page, char c, OLED_FontSize font)
     // 根据 font.h 选择字库
     switch (font) {
         case OLED_FONT_6X8: // asc2_0806
-            glyph = asc2_0806[idx]; width = 6; pages = 1;
+            *glyph = asc2_0806[idx]; *width = 6; *pages = 1;
             break;
         case OLED_FONT_6X12: // asc2_1206 (12字节, 6宽x2页)
-            glyph = asc2_1206[idx]; width = 6; pages = 2;
+            *glyph = asc2_1206[idx]; *width = 6; *pages = 2;
             break;
         case OLED_FONT_8X16: // asc2_1608 (16字节, 8宽x2页)
-            glyph = asc2_1608[idx]; width = 8; pages = 2;
+            *glyph = asc2_1608[idx]; *width = 8; *pages = 2;
             break;
         case OLED_FONT_12X24: // asc2_2412 (36字节, 12宽x3页)
-            glyph = asc2_2412[idx]; width = 12; pages = 3;
+            *glyph = asc2_2412[idx]; *width = 12; *pages = 3;
             break;
         default:
-            return;
+            return 0;
     }
+    return 1;
+}
+
+void SoftOLED_ShowChar(uint8_t x, uint8_t page, char c, OLED_FontSize font)
+{
+    const uint8_t *glyph = NULL;
+    uint8_t width = 0, pages = 0;
 
-    if (x + width > 128) return;
-    if (page + pages > 8) return;
+    if (!SoftOLED_GetGlyph(c, font, &glyph, &width, &pages)) return;
+
+    if (x + width > OLED_PANEL_WIDTH) return;
+    if (page + pages > OLED_PANEL_PAGES) return;
 
     // 绘制
     for (uint8_t p = 0; p < pages; p++) {
@@ -226,45 +600,161 @@ void SoftOLED_ShowChar(uint8_t x, uint8_t page, char c, OLED_FontSize font)
     }
 }
 
-void SoftOLED_ShowString(uint8_t x, uint8_t page, const char *str, OLED_FontSize font)
+#if OLED_USE_SCALE
+void SoftOLED_ShowStringScaled(uint8_t x, uint8_t page, const char *str, uint8_t scale, uint8_t smooth)
 {
-    // 预计算字体参数
-    uint8_t width = 0, h_pages = 0;
-    switch (font) {
-        case OLED_FONT_6X8:  width = 6; h_pages = 1; break;
-        case OLED_FONT_6X12: width = 6; h_pages = 2; break;
-        case OLED_FONT_8X16: width = 8; h_pages = 2; break;
-        case OLED_FONT_12X24: width = 12; h_pages = 3; break;
-        default: return;
-    }
+    uint8_t buf[OLED_SCALE_BUF_LEN];
+    const uint8_t *glyph = NULL;
+    uint8_t width = 0, pages = 0;
 
     while (*str) {
-        if (*str == '\n') { // 支持换行符
-            x = 0;
-            page += h_pages;
-            str++;
-            continue;
-        }
+        if (!SoftOLED_GetGlyph(*str++, OLED_FONT_6X8, &glyph, &width, &pages)) return;
+        width = oled_scale_glyph(glyph, scale, smooth, buf);
+        pages = (uint8_t)(width / OLED_SCALE_SRC_W);
+        if (x + width > OLED_PANEL_WIDTH) break;
 
-        if (x + width > 128) { // 自动换行
-            x = 0;
-            page += h_pages;
+        for (uint8_t p = 0; p < pages && page + p < OLED_PANEL_PAGES; p++) {
+            SoftOLED_WriteArea(x, page + p, buf + p * width, width); // DMA 模式下会等发完，buf 可以复用
         }
+        x += width;
+    }
+}
+#endif
+
+#if SOFT_I2C_LANES > 1
+void SoftOLED_WriteLanes(const uint8_t *const data[SOFT_I2C_LANES], uint16_t len)
+{
+    I2C_Lanes_Write(OLED_DATA_MODE, data, len);
+}
 
-        if (page + h_pages > 8) break; // 底部越界停止
+void SoftOLED_ShowStrings(uint8_t x, uint8_t page, const char *const str[SOFT_I2C_LANES], OLED_FontSize font)
+{
+    const char *s[SOFT_I2C_LANES];
+    const uint8_t *glyph[SOFT_I2C_LANES];
+    uint8_t width = 0, pages = 0;
 
-        SoftOLED_ShowChar(x, page, *str, font);
+    for (uint8_t l = 0; l < SOFT_I2C_LANES; l++) {
+        s[l] = str[l] ? str[l] : "";
+    }
+
+    for (;;) {
+        // 所有路的字符串都结束了才停，短的补空格
+        uint8_t any = 0;
+        for (uint8_t l = 0; l < SOFT_I2C_LANES; l++) {
+            char c = ' ';
+            if (*s[l]) {
+                c = *s[l]++;
+                any = 1;
+            }
+            if (!SoftOLED_GetGlyph(c, font, &glyph[l], &width, &pages)) return;
+        }
+        if (!any) return;
+        if (x + width > OLED_PANEL_WIDTH || page + pages > OLED_PANEL_PAGES) return;
+
+        // 同一字体宽度相同，每页一次事务同时写所有屏
+        for (uint8_t p = 0; p < pages; p++) {
+            const uint8_t *row[SOFT_I2C_LANES];
+            for (uint8_t l = 0; l < SOFT_I2C_LANES; l++) {
+                row[l] = glyph[l] + p * width;
+            }
+            SoftOLED_SetCursor(x, page + p);
+            I2C_Lanes_Write(OLED_DATA_MODE, row, width);
+        }
         x += width;
-        str++;
+    }
+}
+#endif
+
+/**
+ * @brief 文本光标：ShowString 和 Printf 共用的逐字符排版状态
+ */
+typedef struct {
+    uint8_t x;
+    uint8_t page;
+    OLED_FontSize font;
+    uint8_t width;
+    uint8_t h_pages;
+    uint8_t full;           // 已到达底部或字体无效，后续字符全部丢弃
+} SoftOLED_TextCursor;
+
+static void SoftOLED_TextBegin(SoftOLED_TextCursor *cur, uint8_t x, uint8_t page, OLED_FontSize font)
+{
+    cur->x = x;
+    cur->page = page;
+    cur->font = font;
+    cur->width = 0;
+    cur->h_pages = 0;
+    cur->full = 0;
+
+    // 预计算字体参数
+    switch (font) {
+        case OLED_FONT_6X8:  cur->width = 6; cur->h_pages = 1; break;
+        case OLED_FONT_6X12: cur->width = 6; cur->h_pages = 2; break;
+        case OLED_FONT_8X16: cur->width = 8; cur->h_pages = 2; break;
+        case OLED_FONT_12X24: cur->width = 12; cur->h_pages = 3; break;
+        default: cur->full = 1; break;
     }
 }
 
+static void SoftOLED_TextPut(SoftOLED_TextCursor *cur, char c)
+{
+    if (cur->full) return;
+
+    if (c == '\n') { // 支持换行符
+        cur->x = 0;
+        cur->page += cur->h_pages;
+        return;
+    }
+
+    if (cur->x + cur->width > OLED_PANEL_WIDTH) { // 自动换行
+        cur->x = 0;
+        cur->page += cur->h_pages;
+    }
+
+    if (cur->page + cur->h_pages > OLED_PANEL_PAGES) { // 底部越界停止
+        cur->full = 1;
+        return;
+    }
+
+    SoftOLED_ShowChar(cur->x, cur->page, c, cur->font);
+    cur->x += cur->width;
+}
+
+void SoftOLED_ShowString(uint8_t x, uint8_t page, const char *str, OLED_FontSize font)
+{
+    SoftOLED_TextCursor cur;
+    SoftOLED_TextBegin(&cur, x, page, font);
+
+    while (*str && !cur.full) {
+        SoftOLED_TextPut(&cur, *str++);
+    }
+}
+
+#if OLED_USE_FAST_FMT
+static void SoftOLED_PrintfSink(void *ctx, const char *s, uint16_t len)
+{
+    SoftOLED_TextCursor *cur = (SoftOLED_TextCursor *)ctx;
+    while (len-- && !cur->full) {
+        SoftOLED_TextPut(cur, *s++);
+    }
+}
+#endif
+
 void SoftOLED_Printf(uint8_t x, uint8_t page, OLED_FontSize font, const char *format, ...)
 {
-    char str_buf[128];
     va_list args;
+#if OLED_USE_FAST_FMT
+    // 边格式化边绘制，省掉 128 字节的栈缓冲区和 newlib 的 vsnprintf
+    SoftOLED_TextCursor cur;
+    SoftOLED_TextBegin(&cur, x, page, font);
+    va_start(args, format);
+    fmt_vformat(SoftOLED_PrintfSink, &cur, format, args);
+    va_end(args);
+#else
+    char str_buf[128];
     va_start(args, format);
     vsnprintf(str_buf, sizeof(str_buf), format, args);
     va_end(args);
     SoftOLED_ShowString(x, page, str_buf, font);
+#endif
 }
\ No newline at end of file
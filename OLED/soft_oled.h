@@ -7,6 +7,7 @@ extern "C" {
 
 #include "main.h" // 确保能包含 GPIO 定义
 #include "font.h" // 包含字体定义
+#include "oled_panel.h" // 屏幕型号 (分辨率/列偏移/初始化序列)
 /* ================= 用户配置区 ================= */
 /* 修改这里的宏定义来适配你的硬件引脚 */
 
@@ -18,8 +19,81 @@ extern "C" {
 #define OLED_SDA_PORT   GPIOB
 #define OLED_SDA_PIN    GPIO_PIN_7
 
+/* * 编译期时序 (可选)：主频和目标 SCL 速率在编译时已知时打开。
+ * 半个 SCL 周期直接折算为常量 CPU 周期数，I2C_DELAY() 变成一段内联的 DWT 自旋，
+ * 不再有运行时乘法和函数调用；字节发送循环也会被完全展开。
+ * 注释掉 SOFT_I2C_CPU_HZ 则回到运行时的 delay_us(1)。
+ */
+// #define SOFT_I2C_CPU_HZ     72000000u   /* 必须与 SystemCoreClock 一致 */
+#define SOFT_I2C_SCL_HZ     400000u     /* 目标 SCL 频率 */
+#define SOFT_I2C_EDGE_CYCLES 6u         /* 每个半周期里 BSRR 写入 + 自旋入口的固定开销 (周期) */
+
+#if defined(SOFT_I2C_CPU_HZ)
+/* 半周期 CPU 周期数 (向上取整，保证不超过目标频率) */
+#define SOFT_I2C_HALF_CYCLES  ((SOFT_I2C_CPU_HZ + 2u * SOFT_I2C_SCL_HZ - 1u) / (2u * SOFT_I2C_SCL_HZ))
+/* 扣除固定开销后真正需要自旋的周期数 */
+#define SOFT_I2C_WAIT_CYCLES  ((SOFT_I2C_HALF_CYCLES > SOFT_I2C_EDGE_CYCLES) ? \
+                               (SOFT_I2C_HALF_CYCLES - SOFT_I2C_EDGE_CYCLES) : 0u)
+/* 预计的 SCL 频率 (编译期常量，可用于静态断言或启动日志)。
+ * 只是按上面两个常量算出来的估计值：自旋按整圈退出、低电平期间要写两次 BSRR，
+ * 真实频率略低于它 (tools/scl_timing.c 按周期模拟，72MHz 时实测约 381kHz，见 Readme) */
+#define SOFT_I2C_SCL_ACTUAL_HZ (SOFT_I2C_CPU_HZ / (2u * (SOFT_I2C_WAIT_CYCLES + SOFT_I2C_EDGE_CYCLES)))
+#endif
+
+/* * 定时器 + DMA 波形引擎 (可选)：
+ * 置 1 后不再用 CPU 翻转引脚，命令和数据由 soft_i2c_dma.c 翻译成 BSRR 波形，
+ * 定时器触发 DMA 播放，发送期间 CPU 空闲。定时器和 DMA 配置见 soft_i2c_dma.h。
+ */
+#ifndef SOFT_I2C_USE_DMA
+#define SOFT_I2C_USE_DMA    0
+#endif
+
+/* * 多屏并行 (可选)：
+ * 多块屏共用一根 SCL，各自接一根 SDA (必须与 SCL 在同一个 GPIO 端口)。
+ * 每个半周期只写一次 BSRR，同时送出所有屏的数据位，N 块屏的刷新时间与 1 块相同。
+ * SOFT_I2C_LANES > 1 时 SoftOLED_xxx 的普通接口会同时写所有屏 (镜像)，
+ * 每块屏显示不同内容用 SoftOLED_ShowStrings / SoftOLED_WriteLanes。
+ */
+#ifndef SOFT_I2C_LANES
+#define SOFT_I2C_LANES          1                           /* 1~8 */
+#endif
+#ifndef SOFT_I2C_LANE_SDA_PINS
+#define SOFT_I2C_LANE_SDA_PINS  { GPIO_PIN_7, GPIO_PIN_8 }  /* 第 0 路通常就是 OLED_SDA_PIN */
+#endif
+
+#if SOFT_I2C_LANES > 1 && SOFT_I2C_USE_DMA
+#error "SOFT_I2C_LANES > 1 暂不支持 DMA 波形引擎"
+#endif
+#if SOFT_I2C_LANES < 1 || SOFT_I2C_LANES > 8
+#error "SOFT_I2C_LANES 取值范围 1~8"
+#endif
+
 /* ================= OLED 协议层 ================= */
 
+// Printf 使用 fast_fmt 直接把格式化结果送进字模管线 (与 Oled.h 共用同一个开关)
+#ifndef OLED_USE_FAST_FMT
+#define OLED_USE_FAST_FMT 0
+#endif
+
+// 压缩图片支持 (与 Oled.h 共用同一个开关，默认关闭，置 1 时需要 oled_image.c)
+#ifndef OLED_USE_IMAGE
+#define OLED_USE_IMAGE 0
+#endif
+#ifndef OLED_IMAGE_CHUNK
+#define OLED_IMAGE_CHUNK  32
+#endif
+
+// 由 6x8 字库实时放大的大字 (与 Oled.h 共用同一个开关，默认关闭，置 1 时需要 oled_scale.c)
+#ifndef OLED_USE_SCALE
+#define OLED_USE_SCALE 0
+#endif
+
+// 上电后多久才能发命令 (us)，和硬件版的 OLED_PANEL_POWERUP_MS 一样是从 HAL_Init 起算的截止时刻，
+// 默认与旧版的 delay_us(200) 相同 (硬件版的 100ms 不适用于软件 I2C 的屏)
+#ifndef SOFT_OLED_POWERUP_US
+#define SOFT_OLED_POWERUP_US 200u
+#endif
+
 #define OLED_ADDR       0x78 // I2C地址 (0x3C << 1)
 #define OLED_CMD_MODE   0x00
 #define OLED_DATA_MODE  0x40
@@ -32,6 +106,49 @@ void SoftOLED_ShowChar(uint8_t x, uint8_t page, char c, OLED_FontSize font);
 void SoftOLED_ShowString(uint8_t x, uint8_t page, const char *str, OLED_FontSize font);
 // 格式化打印 (类似于 printf)
 void SoftOLED_Printf(uint8_t x, uint8_t page, OLED_FontSize font, const char *format, ...);
+// 从 (x, page) 开始连续写 GDDRAM (DMA 模式下等发送完成才返回)，供显示列表等渲染器使用
+void SoftOLED_WriteArea(uint8_t x, uint8_t page, const uint8_t *data, uint16_t len);
+// 整帧刷新 (OLED_PANEL_FRAME_BYTES 字节页格式帧缓冲，DMA 模式下等发送完成才返回)
+void SoftOLED_WriteFrame(const uint8_t *fb);
+#if OLED_USE_IMAGE
+// 显示压缩图片 (页对齐)，逐段解码直接写屏
+void SoftOLED_DrawImage(uint8_t x, uint8_t page, const uint8_t *img);
+#endif
+#if OLED_USE_SCALE
+// 放大字符串：scale = 2~4，smooth 非 0 时平滑斜边 (2x/4x)
+void SoftOLED_ShowStringScaled(uint8_t x, uint8_t page, const char *str, uint8_t scale, uint8_t smooth);
+#endif
+// 查字模，返回 0 表示字体无效
+uint8_t SoftOLED_GetGlyph(char c, OLED_FontSize font, const uint8_t **glyph, uint8_t *width, uint8_t *pages);
+
+#if defined(USE_DRV_STATS)
+// 运行统计 (全局定义 USE_DRV_STATS 后才累加)；多路模式下一次广播按一次事务计
+typedef struct {
+    uint32_t xfers;         // I2C 事务数
+    uint32_t bytes;         // 总线字节数 (地址 + 控制字节 + 负载)
+    uint64_t busy_cycles;   // CPU 花在 I2C 上的累计周期 (位操作模式下就是发送时间，DMA 模式下只有提交和等待)
+    uint32_t frames;        // 整帧刷新 (SoftOLED_WriteFrame) 次数
+    uint32_t frame_last;    // 最近一次整帧刷新耗时 (周期)
+    uint32_t frame_max;     // 最长一次整帧刷新耗时 (周期)
+} SoftOLED_Stats_t;
+
+void SoftOLED_GetStats(SoftOLED_Stats_t *out);
+void SoftOLED_ResetStats(void);
+#endif
+
+#if SOFT_I2C_LANES > 1
+/**
+ * @brief 每块屏在同一位置显示各自的字符串，所有屏同时刷新
+ * @note  较短的字符串用空格补齐，到右边界截断 (不自动换行)
+ * @param str 每路一个字符串，NULL 视为空串
+ */
+void SoftOLED_ShowStrings(uint8_t x, uint8_t page, const char *const str[SOFT_I2C_LANES], OLED_FontSize font);
+
+/**
+ * @brief 每路发送各自的 GDDRAM 数据 (长度相同)，用于自定义图形
+ */
+void SoftOLED_WriteLanes(const uint8_t *const data[SOFT_I2C_LANES], uint16_t len);
+#endif
 #ifdef __cplusplus
 }
 #endif
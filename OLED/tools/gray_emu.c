@@ -0,0 +1,182 @@
+/**
+ * @file gray_emu.c
+ * @brief 主机端工具：模拟 SSD1306 的 GDDRAM，驱动 oled_gray 的节拍并积分每个像素的点亮时间
+ * @note  纯 C99，直接链接 MCU 端的 oled_gray.c (OLED_GRAY_HOST 模式)。用法:
+ *          gcc -O2 -I.. -DOLED_GRAY_HOST -o gray_emu gray_emu.c ../oled_gray.c
+ *          ./gray_emu [-a]
+ *        校验：每个像素积分出的亮度必须等于 灰度级 / 3，改图并 commit 之后依然成立；
+ *        统计：差分上屏每个平面实际发送的字节数，对比整屏重发；
+ *        -a 以字符画打印积分结果 (" .+#" 对应四级灰度)。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "oled_gray.h"
+
+#define W       OLED_PANEL_WIDTH
+#define H       OLED_PANEL_HEIGHT
+
+/* ================= 模拟屏 ================= */
+
+static uint8_t gddram[8][132];
+static uint32_t bus_bytes;
+
+void oled_gray_host_write(uint8_t col, uint8_t page, const uint8_t *data, uint16_t len)
+{
+    if (page >= 8 || col + len > 132) {
+        fprintf(stderr, "gray_emu: write out of GDDRAM (col %u page %u len %u)\n", col, page, len);
+        exit(1);
+    }
+    memcpy(&gddram[page][col], data, len);
+    bus_bytes += 4u + 2u + len;     // 光标事务 (地址 + 控制 + 3 条命令) + 数据事务头
+}
+
+static int screen_px(int x, int y)
+{
+    return (gddram[y / 8][x + OLED_PANEL_COL_OFFSET] >> (y % 8)) & 1;
+}
+
+/* ================= 积分 ================= */
+
+static uint32_t on_slots[H][W];
+static uint8_t expect[H][W];
+
+/**
+ * @brief 跑 cycles 个灰度周期 (每周期 3 个时隙)，逐时隙累加点亮次数
+ */
+static void integrate(int cycles)
+{
+    uint8_t shown;
+
+    memset(on_slots, 0, sizeof(on_slots));
+    for (int t = 0; t < cycles * 3; t++) {
+        oled_gray_tick(&shown);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                on_slots[y][x] += (uint32_t)screen_px(x, y);
+            }
+        }
+    }
+}
+
+static int verify(const char *what, int cycles)
+{
+    int bad = 0;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            if (on_slots[y][x] != (uint32_t)expect[y][x] * cycles) bad++;
+        }
+    }
+    printf("%-28s %s (%d px wrong)\n", what, bad ? "MISMATCH" : "ok", bad);
+    return bad;
+}
+
+static void ascii(int cycles)
+{
+    static const char shade[] = " .+#";
+    for (int y = 0; y < H; y += 2) {
+        for (int x = 0; x < W; x++) {
+            int lvl = (int)((on_slots[y][x] + cycles / 2) / cycles);
+            putchar(shade[lvl > 3 ? 3 : lvl]);
+        }
+        putchar('\n');
+    }
+}
+
+/* ================= 测试图案 ================= */
+
+static void draw_fill(int x, int y, int w, int h, int level)
+{
+    oled_gray_fill((uint8_t)x, (uint8_t)y, (uint8_t)w, (uint8_t)h, (uint8_t)level);
+    for (int j = y; j < y + h && j < H; j++) {
+        for (int i = x; i < x + w && i < W; i++) expect[j][i] = (uint8_t)level;
+    }
+}
+
+static void draw_pixel(int x, int y, int level)
+{
+    oled_gray_pixel((uint8_t)x, (uint8_t)y, (uint8_t)level);
+    expect[y][x] = (uint8_t)level;
+}
+
+/**
+ * @brief 典型 UI：大片黑底 + 白色边框/文字 + 一块灰度渐变区域
+ */
+static void draw_ui(int shift)
+{
+    oled_gray_clear();
+    memset(expect, 0, sizeof(expect));
+
+    draw_fill(0, 0, W, 1, 3);                       // 白色边框 (两平面相同，不进差分)
+    draw_fill(0, H - 1, W, 1, 3);
+    draw_fill(0, 0, 1, H, 3);
+    draw_fill(W - 1, 0, 1, H, 3);
+    for (int i = 0; i < 4; i++) {                   // 四级色阶条
+        draw_fill(4 + shift + i * 10, 4, 10, 10, i);
+    }
+    for (int x = 4; x < W - 4; x++) {               // 斜向抖动像素
+        draw_pixel(x, 20 + (x % 8), (x / 3) & 3);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int show = (argc > 1 && strcmp(argv[1], "-a") == 0);
+    const int cycles = 40;
+    oled_gray_stats_t st;
+    uint8_t shown;
+    int bad = 0;
+
+    printf("panel %s, slot %u us, cycle %u us\n", OLED_PANEL_NAME,
+           (unsigned)OLED_GRAY_SLOT_US, (unsigned)OLED_GRAY_SLOT_US * 3u);
+
+    oled_gray_init();
+    memset(gddram, 0, sizeof(gddram));
+
+    /* 1. 静态画面 */
+    draw_ui(0);
+    oled_gray_commit();
+    for (int t = 0; t < 3; t++) oled_gray_tick(&shown);     // 第一个周期把两个平面各发一遍
+    bus_bytes = 0;
+    oled_gray_get_stats(&st);
+    uint32_t sub0 = st.subframes, data0 = st.bytes;
+
+    integrate(cycles);
+    bad += verify("static frame", cycles);
+    oled_gray_get_stats(&st);
+    printf("  steady state: %.1f data bytes / subframe (full plane = %u), %.1f bus bytes / subframe\n",
+           (double)(st.bytes - data0) / (st.subframes - sub0), (unsigned)OLED_PANEL_FRAME_BYTES,
+           (double)bus_bytes / (st.subframes - sub0));
+    if (show) ascii(cycles);
+
+    /* 2. 整屏重画后 commit：色阶条右移 30 列 */
+    draw_ui(30);
+    oled_gray_commit();
+    for (int t = 0; t < 3; t++) oled_gray_tick(&shown);
+    integrate(cycles);
+    bad += verify("after redraw + commit", cycles);
+    if (show) ascii(cycles);
+
+    /* 3. 随机像素，多次小改动 */
+    srand(1);
+    for (int round = 0; round < 50; round++) {
+        for (int k = 0; k < 20; k++) {
+            draw_pixel(rand() % W, rand() % H, rand() % 4);
+        }
+        if (round % 3 == 0) {
+            int x = rand() % W, y = rand() % H;
+            draw_fill(x, y, 1 + rand() % 40, 1 + rand() % 20, rand() % 4);
+        }
+        oled_gray_commit();
+        for (int t = 0; t < 1 + rand() % 5; t++) oled_gray_tick(&shown);  // commit 落在周期任意位置
+    }
+    for (int t = 0; t < 3; t++) oled_gray_tick(&shown);
+    integrate(cycles);
+    bad += verify("random edits", cycles);
+
+    /* 4. 四级灰度对应的平均亮度与灰度周期 */
+    printf("perceived levels: 0, %.3f, %.3f, 1 (cycle %.1f Hz)\n", 1.0 / 3, 2.0 / 3,
+           1e6 / (3.0 * OLED_GRAY_SLOT_US));
+    return bad ? 1 : 0;
+}
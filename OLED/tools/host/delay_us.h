@@ -0,0 +1,14 @@
+/**
+ * @file delay_us.h
+ * @brief 主机端替身：软件 I2C 的半周期延时由测试程序实现 (推进模拟时间并采样引脚)
+ */
+
+#ifndef __HOST_DELAY_US_H__
+#define __HOST_DELAY_US_H__
+
+#include "main.h"
+
+void delay_init(void);
+void delay_us(uint32_t us);
+
+#endif /* __HOST_DELAY_US_H__ */
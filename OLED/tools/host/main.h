@@ -0,0 +1,102 @@
+/**
+ * @file main.h
+ * @brief 主机端替身：只提供 soft_oled.c / soft_i2c_dma.c 用到的 HAL 与 CMSIS 接口
+ * @note  GPIO 端口是一组普通变量。直接写 BSRR 的值由测试程序在下一次 HAL_GPIO_WritePin / delay_us 时
+ *        折算进 ODR (驱动在两次直接写 BSRR 之间总会调用其中之一)；定时器和 DMA 只记录状态，
+ *        波形由测试程序按 DMA 的源地址逐字"播放"。
+ */
+
+#ifndef __HOST_MAIN_H__
+#define __HOST_MAIN_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+/* ================= 内核 ================= */
+
+extern uint32_t host_primask;
+
+static inline uint32_t __get_PRIMASK(void) { return host_primask; }
+static inline void __set_PRIMASK(uint32_t v) { host_primask = v; }
+static inline void __disable_irq(void) { host_primask = 1; }
+static inline void __enable_irq(void) { host_primask = 0; }
+
+uint32_t HAL_GetTick(void);
+
+/* ================= GPIO ================= */
+
+typedef struct {
+    __IO uint32_t IDR, ODR, BSRR, BRR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef host_gpioa, host_gpiob;
+#define GPIOA   (&host_gpioa)
+#define GPIOB   (&host_gpiob)
+
+#define GPIO_PIN_0      ((uint16_t)0x0001)
+#define GPIO_PIN_1      ((uint16_t)0x0002)
+#define GPIO_PIN_2      ((uint16_t)0x0004)
+#define GPIO_PIN_3      ((uint16_t)0x0008)
+#define GPIO_PIN_4      ((uint16_t)0x0010)
+#define GPIO_PIN_5      ((uint16_t)0x0020)
+#define GPIO_PIN_6      ((uint16_t)0x0040)
+#define GPIO_PIN_7      ((uint16_t)0x0080)
+#define GPIO_PIN_8      ((uint16_t)0x0100)
+#define GPIO_PIN_9      ((uint16_t)0x0200)
+#define GPIO_PIN_10     ((uint16_t)0x0400)
+#define GPIO_PIN_11     ((uint16_t)0x0800)
+#define GPIO_PIN_12     ((uint16_t)0x1000)
+#define GPIO_PIN_13     ((uint16_t)0x2000)
+#define GPIO_PIN_14     ((uint16_t)0x4000)
+#define GPIO_PIN_15     ((uint16_t)0x8000)
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+typedef struct {
+    uint32_t Pin, Mode, Pull, Speed;
+} GPIO_InitTypeDef;
+
+#define GPIO_MODE_OUTPUT_OD     0x11u
+#define GPIO_PULLUP             0x1u
+#define GPIO_SPEED_FREQ_HIGH    0x2u
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()    ((void)0)
+
+static inline void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init) { (void)port; (void)init; }
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+
+/* ================= 定时器 + DMA ================= */
+
+typedef struct __DMA_HandleTypeDef {
+    void (*XferCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+    void (*XferHalfCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+} DMA_HandleTypeDef;
+
+typedef struct {
+    __IO uint32_t CR1, DIER, CNT;
+} TIM_TypeDef;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+    DMA_HandleTypeDef *hdma[7];
+} TIM_HandleTypeDef;
+
+#define TIM_DMA_ID_UPDATE   0u
+#define TIM_DMA_UPDATE      (1u << 8)
+#define TIM_CR1_CEN         (1u << 0)
+
+#define __HAL_TIM_ENABLE(h)             ((h)->Instance->CR1 |= TIM_CR1_CEN)
+#define __HAL_TIM_DISABLE(h)            ((h)->Instance->CR1 &= ~TIM_CR1_CEN)
+#define __HAL_TIM_ENABLE_DMA(h, d)      ((h)->Instance->DIER |= (d))
+#define __HAL_TIM_DISABLE_DMA(h, d)     ((h)->Instance->DIER &= ~(uint32_t)(d))
+#define __HAL_TIM_SET_COUNTER(h, v)     ((h)->Instance->CNT = (v))
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t len);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+
+#endif /* __HOST_MAIN_H__ */
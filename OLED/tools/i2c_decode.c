@@ -0,0 +1,138 @@
+/**
+ * @file i2c_decode.c
+ * @brief 主机端工具：播放 soft_i2c_dma 生成的 BSRR 波形，用 I2C 协议解码器逐字节核对
+ * @note  纯 C99，直接 #include MCU 端的 soft_i2c_dma.c (要拿到静态的波形缓冲区)，HAL 换成 host/ 下的替身。用法:
+ *          gcc -O2 -Ihost -I.. -Wno-pointer-to-int-cast -o i2c_decode i2c_decode.c
+ *          ./i2c_decode [事务数]
+ *        模拟 DMA 每个定时器节拍把一个字写进 BSRR，播到半区/末尾时调用对应的 DMA 回调，
+ *        i2c_wire.h 按引脚电平解码出 START/字节/STOP。校验：
+ *        1. 随机长度 (0~300 字节) 的事务在随机时刻提交 (包括播放中途、队列写满)，
+ *           解码结果与提交的 地址 | 控制字节 | 负载 完全一致，START/STOP 数等于事务数；
+ *        2. 短负载 (<= SOFT_I2C_DMA_INLINE) 提交后立即改写调用者的缓冲区，线上数据不受影响；
+ *        3. 时序 (节拍)：SCL 高 >= 1、低 >= 2，SDA 建立 >= 1，STOP 到下一个 START >= 1；
+ *        4. 队列发空后引擎自己停下，总线回到空闲高电平。
+ */
+
+#define SOFT_I2C_USE_DMA 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../soft_i2c_dma.c"
+#include "i2c_wire.h"
+
+/* ================= 模拟硬件 ================= */
+
+uint32_t host_primask;
+GPIO_TypeDef host_gpioa, host_gpiob;
+
+uint32_t HAL_GetTick(void) { return 0; }
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    if (state) port->ODR |= pin;
+    else       port->ODR &= ~(uint32_t)pin;
+}
+
+static TIM_TypeDef sim_tim;
+static DMA_HandleTypeDef sim_dma;
+TIM_HandleTypeDef htim1 = { &sim_tim, { &sim_dma } };
+
+static uint32_t dma_len, dma_pos;
+static uint8_t dma_on;
+static uint64_t ticks;
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t len)
+{
+    (void)hdma; (void)src; (void)dst;
+    dma_len = len;
+    dma_pos = 0;
+    dma_on = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    dma_on = 0;
+    return HAL_OK;
+}
+
+#define MAX_BYTES   400000u
+
+static i2c_wire_t bus;
+static uint8_t got[MAX_BYTES];
+
+/**
+ * @brief 播放最多 n 个节拍 (定时器停了就提前返回)
+ */
+static void sim_run(uint64_t n)
+{
+    while (n-- && dma_on && (sim_tim.CR1 & TIM_CR1_CEN) && (sim_tim.DIER & TIM_DMA_UPDATE)) {
+        uint32_t w = sid_wave[dma_pos];
+        GPIOB->ODR = (GPIOB->ODR | (w & 0xFFFFu)) & ~(w >> 16);
+        ticks++;
+        i2c_wire_step(&bus, !!(GPIOB->ODR & OLED_SCL_PIN), !!(GPIOB->ODR & OLED_SDA_PIN), ticks);
+
+        if (++dma_pos == dma_len / 2) {
+            sim_dma.XferHalfCpltCallback(&sim_dma);
+        } else if (dma_pos == dma_len) {
+            dma_pos = 0;
+            sim_dma.XferCpltCallback(&sim_dma);
+        }
+    }
+}
+
+/* ================= 用例 ================= */
+
+int main(int argc, char **argv)
+{
+    long n_tx = argc > 1 ? atol(argv[1]) : 3000;
+    static uint8_t expect[MAX_BYTES];
+    static uint8_t bufs[SOFT_I2C_DMA_QUEUE * 2][300];   // 长负载只记指针，轮换使用保证发完前不被改写
+    uint32_t ne = 0;
+    long tx = 0, bi = 0;
+
+    GPIOB->ODR = OLED_SCL_PIN | OLED_SDA_PIN;
+    i2c_wire_init(&bus, got, MAX_BYTES);
+    soft_i2c_dma_init();
+    srand(3);
+
+    for (; tx < n_tx; tx++) {
+        uint16_t len = (rand() % 3 == 0) ? (uint16_t)(rand() % 300) : (uint16_t)(rand() % (SOFT_I2C_DMA_INLINE + 1));
+        uint8_t *b = bufs[bi++ % (SOFT_I2C_DMA_QUEUE * 2)];
+        uint8_t ctrl = (rand() & 1) ? OLED_DATA_MODE : OLED_CMD_MODE;
+
+        if (ne + len + 2u > MAX_BYTES) break;
+        for (uint16_t i = 0; i < len; i++) b[i] = (uint8_t)rand();
+        expect[ne++] = OLED_ADDR;
+        expect[ne++] = ctrl;
+        memcpy(expect + ne, b, len);
+        ne += len;
+
+        // 单线程里队列满会死等：先播放到有空位 (真机上是中断在后台腾出来)
+        while ((uint8_t)((sid_q_head + 1) % SOFT_I2C_DMA_QUEUE) == sid_q_tail) {
+            sim_run(50);
+        }
+        soft_i2c_dma_write(OLED_ADDR, ctrl, b, len);
+        if (len <= SOFT_I2C_DMA_INLINE) {
+            memset(b, 0xEE, len);       // 已拷贝进队列，改写不能影响线上数据
+        }
+        sim_run((uint64_t)(rand() % 2000));
+    }
+    sim_run(UINT64_MAX);
+
+    int idle = !soft_i2c_dma_busy() && bus.scl && bus.sda && !dma_on;
+    int data_ok = bus.n == ne && memcmp(expect, got, ne) == 0;
+    int timing_ok = bus.min_high >= 1 && bus.min_low >= 2 && bus.min_setup >= 1 && bus.min_free >= 1;
+    int bad = !idle || !data_ok || !timing_ok || bus.errors || bus.starts != (uint32_t)tx || bus.stops != (uint32_t)tx;
+
+    printf("%ld transactions, %u bytes on the wire, %llu ticks (%.1f ticks/byte)\n",
+           tx, (unsigned)bus.n, (unsigned long long)ticks, (double)ticks / (bus.n ? bus.n : 1));
+    printf("%-30s %s (%u/%u bytes, %u starts, %u stops, %u protocol errors)\n", "decoded data",
+           (data_ok && !bus.errors && bus.starts == (uint32_t)tx && bus.stops == (uint32_t)tx) ? "ok" : "FAIL",
+           (unsigned)bus.n, (unsigned)ne, (unsigned)bus.starts, (unsigned)bus.stops, (unsigned)bus.errors);
+    printf("%-30s %s (SCL high %llu, low %llu, setup %llu, bus free %llu ticks)\n", "timing",
+           timing_ok ? "ok" : "FAIL", (unsigned long long)bus.min_high, (unsigned long long)bus.min_low,
+           (unsigned long long)bus.min_setup, (unsigned long long)bus.min_free);
+    printf("%-30s %s\n", "engine stopped, bus idle", idle ? "ok" : "FAIL");
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file i2c_wire.h
+ * @brief 主机端工具公用：按 SCL/SDA 的电平变化解码 I2C 写事务，并统计时序余量
+ * @note  只看主机发出的波形 (没有从机，ACK 时钟期间 SDA 应当是释放的高电平)。
+ *        每次任一根线变化调用一次 i2c_wire_step，时间单位由调用者决定 (定时器节拍、延时次数……)。
+ *        协议错误计入 errors：两根线同一时刻变化、SCL 高电平期间 SDA 变化却不在字节边界、
+ *        ACK 时钟被拉低、输出缓冲区写满。
+ */
+
+#ifndef __I2C_WIRE_H__
+#define __I2C_WIRE_H__
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t scl, sda;
+    uint8_t in_frame;
+    uint8_t bit;                // 0~7 数据位，8 = ACK
+    uint8_t byte;
+    uint32_t starts, stops, errors;
+
+    uint8_t *out;               // 解码出的字节 (地址、控制字节、负载) 依次追加
+    uint32_t n, cap;
+
+    uint64_t t_scl, t_sda, t_stop;
+    uint64_t min_high;          // 事务内 SCL 高电平最短时间
+    uint64_t min_low;           // 事务内 SCL 低电平最短时间
+    uint64_t min_setup;         // SDA 变化到 SCL 上升沿的最短时间
+    uint64_t min_free;          // STOP 到下一个 START 的最短时间
+} i2c_wire_t;
+
+static inline void i2c_wire_init(i2c_wire_t *w, uint8_t *out, uint32_t cap)
+{
+    *w = (i2c_wire_t){0};
+    w->scl = w->sda = 1;
+    w->out = out;
+    w->cap = cap;
+    w->min_high = w->min_low = w->min_setup = w->min_free = UINT64_MAX;
+}
+
+static inline void i2c_wire_min(uint64_t *m, uint64_t v)
+{
+    if (v < *m) *m = v;
+}
+
+static inline void i2c_wire_step(i2c_wire_t *w, uint8_t scl, uint8_t sda, uint64_t t)
+{
+    scl = !!scl;
+    sda = !!sda;
+    if (scl == w->scl && sda == w->sda) {
+        return;
+    }
+    if (scl != w->scl && sda != w->sda) {
+        w->errors++;
+    }
+
+    if (w->scl && scl) {
+        // SCL 高电平期间 SDA 变化：下降 = START，上升 = STOP，只允许出现在字节边界。
+        // 这个时钟的上升沿已经被当成下一个字节的第 1 位采样了，撤销掉
+        if (w->in_frame && w->bit == 1) {
+            w->bit = 0;
+            w->byte = 0;
+        }
+        if (!sda) {
+            if (w->in_frame && w->bit != 0) w->errors++;
+            if (!w->in_frame && w->stops) i2c_wire_min(&w->min_free, t - w->t_stop);
+            w->starts++;
+            w->in_frame = 1;
+            w->bit = 0;
+            w->byte = 0;
+        } else {
+            if (!w->in_frame || w->bit != 0) w->errors++;
+            w->stops++;
+            w->in_frame = 0;
+            w->t_stop = t;
+        }
+    }
+
+    if (scl != w->scl) {
+        if (w->in_frame) {
+            i2c_wire_min(w->scl ? &w->min_high : &w->min_low, t - w->t_scl);
+        }
+        w->t_scl = t;
+    }
+
+    if (!w->scl && scl && w->in_frame) {
+        // 上升沿采样
+        i2c_wire_min(&w->min_setup, t - w->t_sda);
+        if (w->bit < 8) {
+            w->byte = (uint8_t)(w->byte << 1 | sda);
+            w->bit++;
+        } else {
+            if (!sda) w->errors++;
+            if (w->n < w->cap) w->out[w->n++] = w->byte;
+            else w->errors++;
+            w->bit = 0;
+            w->byte = 0;
+        }
+    }
+
+    if (sda != w->sda) {
+        w->t_sda = t;
+    }
+    w->scl = scl;
+    w->sda = sda;
+}
+
+#endif /* __I2C_WIRE_H__ */
@@ -0,0 +1,297 @@
+/**
+ * @file img2c.c
+ * @brief 主机端工具：PBM 图片 -> oled_image 压缩格式的 C 数组，并可测试解码速度
+ * @note  纯 C99，直接链接 MCU 端的 oled_image.c，保证两边解码逻辑一致。用法:
+ *          gcc -O2 -I.. -o img2c img2c.c ../oled_image.c
+ *          ./img2c [-n 数组名] [-i] [-b] logo.pbm > logo_img.h
+ *        -i 反色 (默认 PBM 中的黑色像素 = 点亮)
+ *        -b 在本机上对比解压 / 直接 memcpy 原始数据的速度，结果输出到 stderr
+ *        PNG/BMP 等先转换成 PBM，例如 ImageMagick:
+ *          convert logo.png -resize 128x64 -monochrome logo.pbm
+ */
+
+#define _POSIX_C_SOURCE 199309L   /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "oled_image.h"
+
+#define MAX_W   255
+#define MAX_H   255
+
+/* ================= PBM 读取 ================= */
+
+static int pbm_skip_space(FILE *f)
+{
+    int c;
+    for (;;) {
+        c = fgetc(f);
+        if (c == '#') {
+            while (c != '\n' && c != EOF) c = fgetc(f);
+        } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            return c;
+        }
+    }
+}
+
+static int pbm_read_int(FILE *f, int *out)
+{
+    int c = pbm_skip_space(f);
+    int v = 0;
+
+    if (c < '0' || c > '9') return -1;
+    while (c >= '0' && c <= '9') {
+        v = v * 10 + (c - '0');
+        c = fgetc(f);
+    }
+    *out = v;
+    return 0;
+}
+
+/**
+ * @brief 读取 P1 (ASCII) 或 P4 (二进制) PBM，像素存为 0/1
+ */
+static uint8_t *pbm_load(FILE *f, int *w, int *h)
+{
+    char magic[3] = {0};
+    if (fread(magic, 1, 2, f) != 2 || magic[0] != 'P' || (magic[1] != '1' && magic[1] != '4')) {
+        fprintf(stderr, "img2c: only PBM (P1/P4) is supported\n");
+        return NULL;
+    }
+    if (pbm_read_int(f, w) || pbm_read_int(f, h) || *w <= 0 || *h <= 0) {
+        fprintf(stderr, "img2c: bad PBM header\n");
+        return NULL;
+    }
+    if (*w > MAX_W || *h > MAX_H) {
+        fprintf(stderr, "img2c: image too large (%dx%d, max %dx%d)\n", *w, *h, MAX_W, MAX_H);
+        return NULL;
+    }
+
+    uint8_t *px = calloc((size_t)*w * *h, 1);
+    if (!px) return NULL;
+
+    if (magic[1] == '1') {
+        for (int i = 0; i < *w * *h; i++) {
+            int c = pbm_skip_space(f);
+            if (c != '0' && c != '1') {
+                fprintf(stderr, "img2c: truncated PBM\n");
+                free(px);
+                return NULL;
+            }
+            px[i] = (uint8_t)(c == '1');
+        }
+    } else {
+        int stride = (*w + 7) / 8;
+        for (int y = 0; y < *h; y++) {
+            for (int b = 0; b < stride; b++) {
+                int c = fgetc(f);
+                if (c == EOF) {
+                    fprintf(stderr, "img2c: truncated PBM\n");
+                    free(px);
+                    return NULL;
+                }
+                for (int bit = 0; bit < 8 && b * 8 + bit < *w; bit++) {
+                    px[y * *w + b * 8 + bit] = (uint8_t)((c >> (7 - bit)) & 1);
+                }
+            }
+        }
+    }
+    return px;
+}
+
+/* ================= 页格式 + PackBits ================= */
+
+/**
+ * @brief 转成 font.h 同样的页格式：每页 w 字节，bit0 在上
+ */
+static size_t to_pages(const uint8_t *px, int w, int h, int invert, uint8_t *out)
+{
+    int pages = (h + 7) / 8;
+    for (int p = 0; p < pages; p++) {
+        for (int x = 0; x < w; x++) {
+            uint8_t v = 0;
+            for (int bit = 0; bit < 8; bit++) {
+                int y = p * 8 + bit;
+                if (y < h && (px[y * w + x] ^ (uint8_t)invert)) {
+                    v |= (uint8_t)(1u << bit);
+                }
+            }
+            out[p * w + x] = v;
+        }
+    }
+    return (size_t)pages * w;
+}
+
+static size_t run_length(const uint8_t *in, size_t n, size_t i)
+{
+    size_t r = 1;
+    while (i + r < n && r < 128 && in[i + r] == in[i]) r++;
+    return r;
+}
+
+/**
+ * @brief PackBits 编码：3 个及以上相同字节用重复包，其余攒成字面量包
+ */
+static size_t packbits(const uint8_t *in, size_t n, uint8_t *out)
+{
+    size_t i = 0, o = 0;
+
+    while (i < n) {
+        size_t r = run_length(in, n, i);
+        if (r >= 3) {
+            out[o++] = (uint8_t)(257 - r);
+            out[o++] = in[i];
+            i += r;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < n && i - start < 128) {
+            if (run_length(in, n, i) >= 3) break;
+            i++;
+        }
+        out[o++] = (uint8_t)(i - start - 1);
+        memcpy(&out[o], &in[start], i - start);
+        o += i - start;
+    }
+    return o;
+}
+
+/* ================= 速度测试 ================= */
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench(const uint8_t *img, const uint8_t *raw, size_t raw_len)
+{
+    static uint8_t dst[MAX_W * ((MAX_H + 7) / 8)];
+    volatile uint8_t sink = 0;
+    long iters = 0;
+    double t0, t;
+
+    /* 1. 整幅解压 */
+    t0 = now_sec();
+    do {
+        for (int k = 0; k < 1000; k++) {
+            oled_img_decode(img, dst, sizeof(dst));
+            sink ^= dst[k % raw_len];
+        }
+        iters += 1000;
+        t = now_sec() - t0;
+    } while (t < 0.5);
+    fprintf(stderr, "decode:      %8.1f ns/image  %8.1f MB/s\n", t / iters * 1e9, raw_len * iters / t / 1e6);
+
+    if (memcmp(dst, raw, raw_len) != 0) {
+        fprintf(stderr, "img2c: round-trip mismatch!\n");
+        exit(1);
+    }
+
+    /* 2. 与 OLED_DrawImage 相同的分段解码 (32 字节一段) */
+    iters = 0;
+    t0 = now_sec();
+    do {
+        for (int k = 0; k < 1000; k++) {
+            oled_img_dec_t dec;
+            uint8_t chunk[32];
+            size_t left = raw_len;
+            oled_img_begin(&dec, img);
+            while (left) {
+                uint16_t n = (uint16_t)(left > sizeof(chunk) ? sizeof(chunk) : left);
+                oled_img_read(&dec, chunk, n);
+                sink ^= chunk[0];
+                left -= n;
+            }
+        }
+        iters += 1000;
+        t = now_sec() - t0;
+    } while (t < 0.5);
+    fprintf(stderr, "chunked(32): %8.1f ns/image  %8.1f MB/s\n", t / iters * 1e9, raw_len * iters / t / 1e6);
+
+    /* 3. 逐字节 (显示列表合成路径) */
+    iters = 0;
+    t0 = now_sec();
+    do {
+        for (int k = 0; k < 1000; k++) {
+            oled_img_dec_t dec;
+            oled_img_begin(&dec, img);
+            for (size_t i = 0; i < raw_len; i++) sink ^= oled_img_next(&dec);
+        }
+        iters += 1000;
+        t = now_sec() - t0;
+    } while (t < 0.5);
+    fprintf(stderr, "per-byte:    %8.1f ns/image  %8.1f MB/s\n", t / iters * 1e9, raw_len * iters / t / 1e6);
+
+    /* 4. 基准：未压缩数据直接 memcpy */
+    iters = 0;
+    t0 = now_sec();
+    do {
+        for (int k = 0; k < 1000; k++) {
+            memcpy(dst, raw, raw_len);
+            sink ^= dst[k % raw_len];
+        }
+        iters += 1000;
+        t = now_sec() - t0;
+    } while (t < 0.5);
+    fprintf(stderr, "raw memcpy:  %8.1f ns/image  %8.1f MB/s\n", t / iters * 1e9, raw_len * iters / t / 1e6);
+    (void)sink;
+}
+
+/* ================= 输出 ================= */
+
+int main(int argc, char **argv)
+{
+    const char *name = "image";
+    const char *path = NULL;
+    int invert = 0, do_bench = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0) {
+            invert = 1;
+        } else if (strcmp(argv[i], "-b") == 0) {
+            do_bench = 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    FILE *f = path ? fopen(path, "rb") : stdin;
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+
+    int w, h;
+    uint8_t *px = pbm_load(f, &w, &h);
+    if (f != stdin) fclose(f);
+    if (!px) return 1;
+
+    static uint8_t raw[MAX_W * ((MAX_H + 7) / 8)];
+    static uint8_t img[OLED_IMG_HDR_LEN + sizeof(raw) + sizeof(raw) / 128 + 2];
+    size_t raw_len = to_pages(px, w, h, invert, raw);
+    img[0] = (uint8_t)w;
+    img[1] = (uint8_t)h;
+    size_t img_len = OLED_IMG_HDR_LEN + packbits(raw, raw_len, &img[OLED_IMG_HDR_LEN]);
+    free(px);
+
+    printf("/* %s: %dx%d, raw %zu bytes -> %zu bytes (%.1f%%), generated by img2c */\n",
+           name, w, h, raw_len, img_len, 100.0 * img_len / raw_len);
+    printf("static const uint8_t %s[%zu] = {", name, img_len);
+    for (size_t i = 0; i < img_len; i++) {
+        printf("%s0x%02X,", (i % 16) ? " " : "\n    ", img[i]);
+    }
+    printf("\n};\n");
+
+    fprintf(stderr, "%s: %dx%d, raw %zu -> %zu bytes (%.1f%%)\n", name, w, h, raw_len, img_len, 100.0 * img_len / raw_len);
+    if (do_bench) {
+        bench(img, raw, raw_len);
+    }
+    return 0;
+}
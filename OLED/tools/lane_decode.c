@@ -0,0 +1,235 @@
+/**
+ * @file lane_decode.c
+ * @brief 主机端工具：多屏并行软件 I2C (SOFT_I2C_LANES) 的逐路协议解码校验
+ * @note  纯 C99，直接 #include MCU 端的 soft_oled.c (4 路，引脚在下面定义)，HAL 换成 host/ 下的替身。用法:
+ *          gcc -O2 -Ihost -I.. -o lane_decode lane_decode.c
+ *          ./lane_decode [轮数]
+ *        每次 HAL_GPIO_WritePin / delay_us 时把驱动直接写进 BSRR 的值折算进 ODR，
+ *        每一路 (共用 SCL + 自己的 SDA) 各挂一个 i2c_wire.h 解码器，时间单位是 I2C_DELAY() 的次数。校验：
+ *        1. SoftOLED_Init / ShowString 等普通接口：每一路收到完全相同的事务 (镜像)；
+ *        2. SoftOLED_WriteLanes：每一路收到 地址 | 0x40 | 自己的数据，随机长度、随机内容；
+ *        3. SoftOLED_ShowStrings：每一路的数据等于按自己的字符串逐字查字模的结果 (短的补空格，到右边界截断)；
+ *        4. 没有协议错误，SCL 高/低电平和 SDA 建立时间都至少一个半周期。
+ */
+
+#define SOFT_I2C_LANES          4
+#define SOFT_I2C_LANE_SDA_PINS  { GPIO_PIN_7, GPIO_PIN_8, GPIO_PIN_9, GPIO_PIN_10 }
+#define OLED_USE_IMAGE          0
+#define OLED_USE_SCALE          0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../soft_oled.c"
+#include "i2c_wire.h"
+
+#define LANES   SOFT_I2C_LANES
+
+/* ================= 模拟硬件 ================= */
+
+uint32_t host_primask;
+GPIO_TypeDef host_gpioa, host_gpiob;
+
+uint32_t HAL_GetTick(void) { return 1000; }     // 上电等待早已过去
+
+#define MAX_BYTES   200000u
+
+static const uint16_t sda_pin[LANES] = SOFT_I2C_LANE_SDA_PINS;
+static i2c_wire_t lane[LANES];
+static uint8_t got[LANES][MAX_BYTES];
+static uint64_t sim_time;               // I2C_DELAY() 次数
+
+static void sim_sample(void)
+{
+    uint32_t odr = OLED_SCL_PORT->ODR;
+    for (int l = 0; l < LANES; l++) {
+        i2c_wire_step(&lane[l], !!(odr & OLED_SCL_PIN), !!(odr & sda_pin[l]), sim_time);
+    }
+}
+
+/* 直接写 BSRR 的值折算进 ODR (同一引脚同时置位和复位时置位优先，与硬件一致) */
+static void sim_latch(void)
+{
+    uint32_t b = OLED_SCL_PORT->BSRR;
+    if (b) {
+        OLED_SCL_PORT->ODR = (OLED_SCL_PORT->ODR & ~(b >> 16)) | (b & 0xFFFFu);
+        OLED_SCL_PORT->BSRR = 0;
+        sim_sample();
+    }
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    sim_latch();
+    if (state) port->ODR |= pin;
+    else       port->ODR &= ~(uint32_t)pin;
+    sim_sample();
+}
+
+void delay_init(void) {}
+
+void delay_us(uint32_t us)
+{
+    sim_latch();
+    sim_time += us;
+}
+
+/* ================= 期望值 ================= */
+
+static uint8_t expect[LANES][MAX_BYTES];
+static uint32_t n_expect[LANES];
+static uint32_t n_tx_expect;
+
+static void clear_log(void)
+{
+    for (int l = 0; l < LANES; l++) {
+        lane[l].n = 0;
+        lane[l].starts = lane[l].stops = 0;
+        n_expect[l] = 0;
+    }
+    n_tx_expect = 0;
+}
+
+static void expect_tx(int l, uint8_t ctrl, const uint8_t *data, uint16_t len)
+{
+    expect[l][n_expect[l]++] = OLED_ADDR;
+    expect[l][n_expect[l]++] = ctrl;
+    memcpy(&expect[l][n_expect[l]], data, len);
+    n_expect[l] += len;
+}
+
+static int check(const char *what, int mirrored)
+{
+    int bad = 0;
+    uint32_t errors = 0;
+
+    for (int l = 0; l < LANES; l++) {
+        const uint8_t *want = mirrored ? got[0] : expect[l];
+        uint32_t n_want = mirrored ? lane[0].n : n_expect[l];
+        uint32_t n_tx = mirrored ? lane[0].starts : n_tx_expect;
+
+        errors += lane[l].errors;
+        if (lane[l].n != n_want || memcmp(got[l], want, n_want) != 0 ||
+            lane[l].starts != n_tx || lane[l].stops != n_tx || lane[l].errors) {
+            bad = 1;
+            printf("  lane %d: %u/%u bytes, %u starts, %u stops, %u errors\n", l, (unsigned)lane[l].n,
+                   (unsigned)n_want, (unsigned)lane[l].starts, (unsigned)lane[l].stops, (unsigned)lane[l].errors);
+        }
+    }
+    printf("%-30s %s (%u transactions, %u bytes per lane, %u protocol errors)\n", what, bad ? "FAIL" : "ok",
+           (unsigned)lane[0].starts, (unsigned)lane[0].n, (unsigned)errors);
+    return bad;
+}
+
+/* ================= 用例 ================= */
+
+static int test_mirror(void)
+{
+    int bad = 0;
+
+    clear_log();
+    SoftOLED_Init();
+    bad |= check("SoftOLED_Init mirrored", 1);
+
+    clear_log();
+    SoftOLED_ShowString(0, 2, "Hello lanes 0123", OLED_FONT_8X16);
+    SoftOLED_Printf(0, 6, OLED_FONT_6X8, "n=%d", 42);
+    bad |= check("ShowString/Printf mirrored", 1);
+    return bad;
+}
+
+static int test_write_lanes(int rounds)
+{
+    static uint8_t buf[LANES][300];
+    const uint8_t *data[LANES];
+
+    clear_log();
+    for (int r = 0; r < rounds; r++) {
+        uint16_t len = (uint16_t)(1 + rand() % 300);
+        for (int l = 0; l < LANES; l++) {
+            for (uint16_t i = 0; i < len; i++) buf[l][i] = (uint8_t)rand();
+            data[l] = buf[l];
+            expect_tx(l, OLED_DATA_MODE, buf[l], len);
+        }
+        n_tx_expect++;
+        SoftOLED_WriteLanes(data, len);
+    }
+    return check("SoftOLED_WriteLanes", 0);
+}
+
+/**
+ * @brief 参考实现：每一路按自己的字符串逐字查字模，同一列的所有页写完再换下一列
+ */
+static void expect_strings(uint8_t x, uint8_t page, const char *const str[LANES], OLED_FontSize font)
+{
+    const char *s[LANES];
+    for (int l = 0; l < LANES; l++) s[l] = str[l] ? str[l] : "";
+
+    for (;;) {
+        const uint8_t *glyph[LANES];
+        uint8_t width = 0, pages = 0, any = 0;
+
+        for (int l = 0; l < LANES; l++) {
+            char c = *s[l] ? (any = 1, *s[l]++) : ' ';
+            SoftOLED_GetGlyph(c, font, &glyph[l], &width, &pages);
+        }
+        if (!any || x + width > OLED_PANEL_WIDTH || page + pages > OLED_PANEL_PAGES) return;
+
+        for (uint8_t p = 0; p < pages; p++) {
+            uint8_t cx = (uint8_t)(x + OLED_PANEL_COL_OFFSET);
+            uint8_t cmds[3] = { (uint8_t)(0xB0 | (page + p)), (uint8_t)(cx & 0x0F), (uint8_t)(0x10 | (cx >> 4)) };
+            for (int l = 0; l < LANES; l++) {
+                expect_tx(l, OLED_CMD_MODE, cmds, 3);
+                expect_tx(l, OLED_DATA_MODE, glyph[l] + p * width, width);
+            }
+            n_tx_expect += 2;
+        }
+        x = (uint8_t)(x + width);
+    }
+}
+
+static int test_strings(void)
+{
+    static const char *const sets[][LANES] = {
+        { "Temp 25.1C", "Hum 48%", NULL, "Lane three" },
+        { "", "a", "abcdefghijklmnopqrstuvwxyz", "~!@#$%^&*()" },
+        { "same", "same", "same", "same" },
+    };
+    static const OLED_FontSize fonts[] = { OLED_FONT_6X8, OLED_FONT_6X12, OLED_FONT_8X16, OLED_FONT_12X24 };
+
+    clear_log();
+    for (unsigned i = 0; i < sizeof(sets) / sizeof(sets[0]); i++) {
+        for (unsigned f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++) {
+            uint8_t x = (uint8_t)(i * 5), page = (uint8_t)(f % 2);
+            expect_strings(x, page, sets[i], fonts[f]);
+            SoftOLED_ShowStrings(x, page, sets[i], fonts[f]);
+        }
+    }
+    return check("SoftOLED_ShowStrings", 0);
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = argc > 1 ? atoi(argv[1]) : 200;
+    int bad = 0;
+
+    OLED_SCL_PORT->ODR = 0xFFFFu;
+    for (int l = 0; l < LANES; l++) {
+        i2c_wire_init(&lane[l], got[l], MAX_BYTES);
+    }
+    srand(5);
+
+    printf("soft_oled with %d lanes on one SCL\n", LANES);
+    bad |= test_mirror();
+    bad |= test_write_lanes(rounds);
+    bad |= test_strings();
+
+    int timing_ok = 1;
+    for (int l = 0; l < LANES; l++) {
+        timing_ok &= lane[l].min_high >= 1 && lane[l].min_low >= 1 && lane[l].min_setup >= 1;
+    }
+    printf("%-30s %s (SCL high %llu, low %llu, SDA setup %llu half periods)\n", "timing", timing_ok ? "ok" : "FAIL",
+           (unsigned long long)lane[0].min_high, (unsigned long long)lane[0].min_low,
+           (unsigned long long)lane[0].min_setup);
+    return (bad || !timing_ok) ? 1 : 0;
+}
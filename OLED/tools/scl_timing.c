@@ -0,0 +1,184 @@
+/**
+ * @file scl_timing.c
+ * @brief 主机端工具：按 CPU 周期模拟编译期时序 (SOFT_I2C_CPU_HZ) 的软件 I2C，量出真实的 SCL 频率
+ * @note  纯 C99，直接 #include MCU 端的 soft_oled.c (单路、编译期模式)，HAL 换成 host/ 下的替身。用法:
+ *          gcc -O2 -Ihost -I.. -o scl_timing scl_timing.c
+ *          gcc -O2 -Ihost -I.. -DSOFT_I2C_CPU_HZ=168000000u -o scl_timing scl_timing.c
+ *          ./scl_timing
+ *        DWT 和 GPIOB 换成函数调用：每写一次 BSRR、每读一次 CYCCNT 按下面的指令开销推进周期计数，
+ *        自旋循环因此真的按 "读 CYCCNT -> 比较 -> 跳转" 的粒度转圈，时间单位就是 CPU 周期。
+ *        引脚电平交给 i2c_wire.h 解码，统计事务内每个 SCL 周期的长度。校验：
+ *        1. SoftOLED_Init / Clear / ShowString 解码无协议错误，START/STOP 成对；
+ *        2. 最快的一个 SCL 周期也不超过 SOFT_I2C_SCL_HZ；
+ *        并打印平均 SCL 频率、最短高/低电平，以及和编译期估算 SOFT_I2C_SCL_ACTUAL_HZ 的偏差。
+ *        开销按 Cortex-M3/M4 零等待 Flash 估计，Flash 等待周期多的芯片实际还会更慢。
+ */
+
+#ifndef SOFT_I2C_CPU_HZ
+#define SOFT_I2C_CPU_HZ     72000000u
+#endif
+#define OLED_USE_IMAGE      0
+#define OLED_USE_SCALE      0
+
+/* 指令开销 (周期) */
+#ifndef CYC_GPIO_STORE
+#define CYC_GPIO_STORE      3   /* 准备写入值 + STR 到 BSRR */
+#endif
+#ifndef CYC_DWT_LOAD
+#define CYC_DWT_LOAD        2   /* LDR CYCCNT */
+#endif
+#ifndef CYC_SPIN_LOOP
+#define CYC_SPIN_LOOP       4   /* SUB + CMP + 跳转 (流水线重填) */
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+
+/* ================= 周期计数 ================= */
+
+typedef struct {
+    __IO uint32_t CTRL, CYCCNT;
+} DWT_Type;
+
+#define DWT_BASE            0xE0001000UL
+#define __STATIC_INLINE     static inline
+
+static DWT_Type *sim_dwt(void);
+static GPIO_TypeDef *sim_gpio(GPIO_TypeDef *port);
+
+#define DWT                 sim_dwt()
+#undef GPIOB
+#define GPIOB               sim_gpio(&host_gpiob)
+
+#include "../soft_oled.c"
+#include "i2c_wire.h"
+
+/* ================= 模拟硬件 ================= */
+
+uint32_t host_primask;
+GPIO_TypeDef host_gpioa, host_gpiob;
+
+uint32_t HAL_GetTick(void) { return 1000; }     // 上电等待早已过去
+
+#define MAX_BYTES   8192u
+
+static i2c_wire_t wire;
+static uint8_t got[MAX_BYTES];
+static DWT_Type sim_dwt_regs;
+static uint64_t sim_cycles;
+static uint64_t t_store;                // 最近一次 BSRR 写入生效的时刻
+
+/* 事务内相邻两个 SCL 上升沿的间隔 */
+static uint64_t last_rise, period_sum, period_min = UINT64_MAX;
+static uint32_t periods;
+static uint8_t have_rise;
+
+static void sim_sample(uint64_t t)
+{
+    uint32_t odr = host_gpiob.ODR;
+    uint8_t rise = !wire.scl && (odr & OLED_SCL_PIN);
+
+    i2c_wire_step(&wire, !!(odr & OLED_SCL_PIN), !!(odr & OLED_SDA_PIN), t);
+    if (!wire.in_frame) {
+        have_rise = 0;
+    } else if (rise) {
+        if (have_rise) {
+            period_sum += t - last_rise;
+            if (t - last_rise < period_min) period_min = t - last_rise;
+            periods++;
+        }
+        last_rise = t;
+        have_rise = 1;
+    }
+}
+
+/* 上一次直接写 BSRR 的值折算进 ODR (驱动每次都是取到端口指针后立刻写一个字) */
+static void sim_latch(void)
+{
+    uint32_t b = host_gpiob.BSRR;
+    if (b) {
+        host_gpiob.ODR = (host_gpiob.ODR & ~(b >> 16)) | (b & 0xFFFFu);
+        host_gpiob.BSRR = 0;
+        sim_sample(t_store);
+    }
+}
+
+static GPIO_TypeDef *sim_gpio(GPIO_TypeDef *port)
+{
+    sim_latch();
+    sim_cycles += CYC_GPIO_STORE;
+    t_store = sim_cycles;
+    return port;
+}
+
+static DWT_Type *sim_dwt(void)
+{
+    sim_latch();
+    sim_cycles += CYC_DWT_LOAD;
+    sim_dwt_regs.CYCCNT = (uint32_t)sim_cycles;
+    sim_cycles += CYC_SPIN_LOOP;
+    return &sim_dwt_regs;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    sim_latch();
+    if (state) port->ODR |= pin;
+    else       port->ODR &= ~(uint32_t)pin;
+    sim_sample(sim_cycles);
+}
+
+void delay_init(void) {}
+
+void delay_us(uint32_t us)
+{
+    sim_latch();
+    sim_cycles += (uint64_t)us * (SOFT_I2C_CPU_HZ / 1000000u);
+}
+
+/* ================= 主程序 ================= */
+
+static double khz(uint64_t cycles)
+{
+    return cycles ? (double)SOFT_I2C_CPU_HZ / (double)cycles / 1000.0 : 0.0;
+}
+
+int main(void)
+{
+    int bad = 0;
+
+    host_gpiob.ODR = 0xFFFFu;
+    i2c_wire_init(&wire, got, MAX_BYTES);
+
+    printf("soft_oled compile-time timing: CPU %u Hz, target SCL %u Hz, half period %u = spin %u + edge %u cycles\n",
+           (unsigned)SOFT_I2C_CPU_HZ, (unsigned)SOFT_I2C_SCL_HZ, (unsigned)SOFT_I2C_HALF_CYCLES,
+           (unsigned)SOFT_I2C_WAIT_CYCLES, (unsigned)SOFT_I2C_EDGE_CYCLES);
+
+    SoftOLED_Init();
+    SoftOLED_Clear();
+    SoftOLED_ShowString(0, 2, "SCL timing 0123", OLED_FONT_8X16);
+    sim_latch();
+
+    int proto_ok = wire.errors == 0 && wire.starts > 0 && wire.starts == wire.stops && wire.n > 0 &&
+                   got[0] == OLED_ADDR;
+    printf("%-30s %s (%u transactions, %u bytes, %u protocol errors)\n", "protocol", proto_ok ? "ok" : "FAIL",
+           (unsigned)wire.starts, (unsigned)wire.n, (unsigned)wire.errors);
+    bad |= !proto_ok;
+
+    uint64_t mean = periods ? (period_sum + periods / 2) / periods : 0;
+    int freq_ok = periods > 0 && khz(period_min) * 1000.0 <= (double)SOFT_I2C_SCL_HZ;
+    printf("%-30s %s (mean %.1f kHz = %llu cycles, fastest %.1f kHz, target %u kHz)\n", "SCL frequency",
+           freq_ok ? "ok" : "FAIL", khz(mean), (unsigned long long)mean, khz(period_min),
+           (unsigned)(SOFT_I2C_SCL_HZ / 1000u));
+    bad |= !freq_ok;
+
+    double est = (double)SOFT_I2C_SCL_ACTUAL_HZ / 1000.0;
+    printf("%-30s %.1f kHz estimated, %.1f kHz measured (%+.1f%%)\n", "SOFT_I2C_SCL_ACTUAL_HZ", est, khz(mean),
+           (khz(mean) - est) / est * 100.0);
+    printf("%-30s high %llu / low %llu cycles (%.0f / %.0f ns), SDA setup %llu cycles\n", "shortest SCL phase",
+           (unsigned long long)wire.min_high, (unsigned long long)wire.min_low,
+           wire.min_high * 1e9 / SOFT_I2C_CPU_HZ, wire.min_low * 1e9 / SOFT_I2C_CPU_HZ,
+           (unsigned long long)wire.min_setup);
+    return bad;
+}
@@ -0,0 +1,239 @@
+/**
+ * @file dht_capture.c
+ * @brief DHT11/DHT22 输入捕获驱动实现
+ */
+
+#include "dht_capture.h"
+#include <string.h>
+
+#if DHT_TIM_BITS == 32
+#define DHT_TIM_MASK    0xFFFFFFFFu
+#else
+#define DHT_TIM_MASK    0xFFFFu
+#endif
+
+/* 起始信号长度：DHT11 至少 18ms，DHT22 至少 1ms */
+#if DHT_TYPE == 11
+#define DHT_START_US    20000u
+#else
+#define DHT_START_US    2000u
+#endif
+
+/* 读取状态机 */
+enum {
+    DHT_IDLE = 0,
+    DHT_STARTING,       // 主机拉低总线中
+    DHT_CAPTURING,      // 等待 DMA 收齐边沿
+};
+
+static uint32_t dht_edges[DHT_EDGES];
+static volatile uint8_t dht_state = DHT_IDLE;
+static volatile uint32_t dht_seq = 0;   // 每次读取递增，用来识别过期的超时回调
+static dht_done_cb_t dht_cb;
+static void *dht_cb_arg;
+
+static void dht_pin_output(void)
+{
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Pin = DHT_GPIO_PIN;
+    gpio.Mode = GPIO_MODE_OUTPUT_OD;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(DHT_GPIO_PORT, &gpio);
+}
+
+static void dht_pin_capture(void)
+{
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Pin = DHT_GPIO_PIN;
+#if defined(DHT_GPIO_AF)
+    gpio.Mode = GPIO_MODE_AF_OD;
+    gpio.Alternate = DHT_GPIO_AF;
+#else
+    gpio.Mode = GPIO_MODE_INPUT;
+#endif
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(DHT_GPIO_PORT, &gpio);
+}
+
+/**
+ * @brief 结束本次读取：停捕获、释放总线、解码并回调
+ * @note  DMA 完成和超时都会走到这里，谁先到谁处理，另一个看到状态已变直接返回
+ */
+static void dht_finish(uint16_t captured)
+{
+    dht_reading_t reading;
+    dht_status_t status;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (dht_state != DHT_CAPTURING) {
+        __set_PRIMASK(primask);
+        return;
+    }
+    dht_state = DHT_IDLE;
+    dht_seq++;
+    __set_PRIMASK(primask);
+
+    HAL_TIM_IC_Stop_DMA(DHT_TIM_HANDLE, DHT_TIM_CHANNEL);
+    dht_pin_output();
+    HAL_GPIO_WritePin(DHT_GPIO_PORT, DHT_GPIO_PIN, GPIO_PIN_SET);
+
+    memset(&reading, 0, sizeof(reading));
+    status = dht_decode(dht_edges, captured, &reading);
+
+    if (dht_cb) {
+        dht_cb(status, &reading, dht_cb_arg);
+    }
+}
+
+static void dht_timeout(void *arg)
+{
+    if ((uint32_t)(uintptr_t)arg != dht_seq) {
+        return;     // 早已正常结束，这是过期的超时
+    }
+
+    // 边沿没收齐：按已经收到的个数解码 (可能只是漏了应答沿)
+    DMA_HandleTypeDef *hdma = DHT_TIM_HANDLE->hdma[DHT_TIM_DMA_ID];
+    uint16_t remaining = (uint16_t)__HAL_DMA_GET_COUNTER(hdma);
+    dht_finish((uint16_t)(DHT_EDGES - remaining));
+}
+
+/**
+ * @brief 起始信号结束：释放总线，开始捕获
+ */
+static void dht_release(void *arg)
+{
+    (void)arg;
+
+    dht_state = DHT_CAPTURING;
+    memset(dht_edges, 0, sizeof(dht_edges));
+
+    // 先启动捕获再释放总线，传感器 20~40us 后的应答沿不会漏掉
+    HAL_TIM_IC_Start_DMA(DHT_TIM_HANDLE, DHT_TIM_CHANNEL, dht_edges, DHT_EDGES);
+    dht_pin_capture();
+
+    if (delay_async_us(DHT_TIMEOUT_US, dht_timeout, (void *)(uintptr_t)dht_seq) != 0) {
+        // 没法挂超时就没人兜底，直接放弃
+        dht_finish(0);
+    }
+}
+
+void dht_init(void)
+{
+    dht_pin_output();
+    HAL_GPIO_WritePin(DHT_GPIO_PORT, DHT_GPIO_PIN, GPIO_PIN_SET);
+    dht_state = DHT_IDLE;
+}
+
+int dht_read_async(dht_done_cb_t cb, void *arg)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (dht_state != DHT_IDLE) {
+        __set_PRIMASK(primask);
+        return -1;
+    }
+    dht_state = DHT_STARTING;
+    __set_PRIMASK(primask);
+
+    dht_cb = cb;
+    dht_cb_arg = arg;
+
+    // 拉低总线，起始信号的长度交给定时器，不再 HAL_Delay(18)
+    HAL_GPIO_WritePin(DHT_GPIO_PORT, DHT_GPIO_PIN, GPIO_PIN_RESET);
+    if (delay_async_us(DHT_START_US, dht_release, NULL) != 0) {
+        HAL_GPIO_WritePin(DHT_GPIO_PORT, DHT_GPIO_PIN, GPIO_PIN_SET);
+        dht_state = DHT_IDLE;
+        return -1;
+    }
+    return 0;
+}
+
+void dht_capture_irq_handler(TIM_HandleTypeDef *htim)
+{
+    if (htim == DHT_TIM_HANDLE && htim->Channel == DHT_TIM_ACTIVE_CH) {
+        dht_finish(DHT_EDGES);
+    }
+}
+
+dht_status_t dht_decode(const uint32_t *edges, uint16_t n, dht_reading_t *out)
+{
+    // 40 个数据位需要 41 个下降沿 (每位起点 + 结束沿)；应答沿可有可无
+    if (n < 41) {
+        return DHT_ERR_TIMEOUT;
+    }
+    edges += n - 41;
+
+    memset(out->raw, 0, sizeof(out->raw));
+    for (uint8_t i = 0; i < 40; i++) {
+        uint32_t width = (edges[i + 1] - edges[i]) & DHT_TIM_MASK;
+        if (width < DHT_BIT_MIN_US || width > DHT_BIT_MAX_US) {
+            return DHT_ERR_TIMING;
+        }
+        out->raw[i >> 3] = (uint8_t)((out->raw[i >> 3] << 1) | (width > DHT_BIT_THRESHOLD_US));
+    }
+
+    const uint8_t *r = out->raw;
+    if ((uint8_t)(r[0] + r[1] + r[2] + r[3]) != r[4]) {
+        return DHT_ERR_CHECKSUM;
+    }
+
+#if DHT_TYPE == 11
+    out->humidity_x10 = (uint16_t)(r[0] * 10u + r[1]);
+    out->temperature_x10 = (int16_t)(r[2] * 10 + (r[3] & 0x7F));
+    if (r[3] & 0x80) {
+        out->temperature_x10 = -out->temperature_x10;
+    }
+#else
+    out->humidity_x10 = (uint16_t)((r[0] << 8) | r[1]);
+    out->temperature_x10 = (int16_t)(((r[2] & 0x7F) << 8) | r[3]);
+    if (r[2] & 0x80) {
+        out->temperature_x10 = -out->temperature_x10;
+    }
+#endif
+    return DHT_OK;
+}
+
+#if defined(USE_FREERTOS)
+
+typedef struct {
+    TaskHandle_t task;
+    dht_reading_t *out;
+    dht_status_t status;
+    volatile uint8_t done;
+} dht_wait_t;
+
+static void dht_read_wakeup(dht_status_t status, const dht_reading_t *reading, void *arg)
+{
+    dht_wait_t *w = (dht_wait_t *)arg;
+    TaskHandle_t task = w->task;
+    BaseType_t woken = pdFALSE;
+
+    w->status = status;
+    *w->out = *reading;
+    w->done = 1;    // w 在等待方的栈上，置位之后不再访问
+    vTaskNotifyGiveIndexedFromISR(task, DELAY_ASYNC_NOTIFY_INDEX, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+dht_status_t dht_read(dht_reading_t *out)
+{
+    dht_wait_t w;
+    w.task = xTaskGetCurrentTaskHandle();
+    w.out = out;
+    w.status = DHT_ERR_TIMEOUT;
+    w.done = 0;
+
+    if (dht_read_async(dht_read_wakeup, &w) != 0) {
+        return DHT_ERR_BUSY;
+    }
+    // 与 delay_block_us 共用通知下标 (同一任务不会同时等两者)，以完成标志为准
+    while (!w.done) {
+        ulTaskNotifyTakeIndexed(DELAY_ASYNC_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+    }
+    return w.status;
+}
+
+#endif /* USE_FREERTOS */
@@ -0,0 +1,126 @@
+/**
+ * @file dht_capture.h
+ * @brief DHT11/DHT22 (AM2302) 非阻塞驱动：定时器输入捕获 + DMA 记录下降沿，事后解码
+ * @note  读取全程 (约 5ms 数据 + 1~18ms 起始信号) 不占用 CPU、不关中断：
+ *        起始信号的等待交给 delay_async，数据位的边沿由定时器硬件打时间戳、DMA 搬进数组，
+ *        收齐后在中断里一次性按脉宽解码，结果通过回调或 RTOS 任务通知送达。
+ */
+
+#ifndef __DHT_CAPTURE_H__
+#define __DHT_CAPTURE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "delay_async.h"   /* 起始信号与超时定时，同时带入 main.h 与 USE_FREERTOS 配置 */
+
+/* ================= 用户配置区 ================= */
+
+/* 传感器型号：11 = DHT11，22 = DHT22/AM2302 */
+#ifndef DHT_TYPE
+#define DHT_TYPE            22
+#endif
+
+/* 数据引脚 (需外接 4.7k~10k 上拉)：PA1 = TIM2_CH2 */
+#define DHT_GPIO_PORT       GPIOA
+#define DHT_GPIO_PIN        GPIO_PIN_1
+
+/* * 捕获定时器：计数频率 1MHz (1 tick = 1us)，Counter Period 拉满。
+ * 通道配置为 Input Capture direct mode，下降沿触发，并添加该通道的 DMA：
+ * Peripheral To Memory，Normal，Data Width = Word/Word，内存地址递增。
+ * 默认与 delay_async 共用 TIM2 (delay_async 占用 CH1 做比较，这里用 CH2 捕获)，
+ * 换成别的定时器时把 DHT_TIM_SHARED 置 0。
+ */
+extern TIM_HandleTypeDef htim2;
+#define DHT_TIM_HANDLE      (&htim2)
+#define DHT_TIM_CHANNEL     TIM_CHANNEL_2
+#define DHT_TIM_ACTIVE_CH   HAL_TIM_ACTIVE_CHANNEL_2
+#define DHT_TIM_DMA_ID      TIM_DMA_ID_CC2  /* 与通道对应：CC1~CC4 */
+#ifndef DHT_TIM_BITS
+#define DHT_TIM_BITS        32          /* 16 位定时器填 16 */
+#endif
+#define DHT_TIM_SHARED      1           /* 1 = DHT_TIM_HANDLE 就是 DELAY_ASYNC_TIM_HANDLE */
+
+/* 捕获时的引脚复用号 (F4/F7/H7/G0/L4 等需要)；F1 注释掉即可，输入模式就能驱动定时器 */
+#define DHT_GPIO_AF         GPIO_AF1_TIM2
+
+/* 判决门限：两次下降沿之间 = 50us 低 + 26us(0) 或 70us(1) 高 */
+#define DHT_BIT_THRESHOLD_US  100u
+#define DHT_BIT_MIN_US        40u
+#define DHT_BIT_MAX_US        200u
+
+/* 从释放总线到收齐 42 个边沿的超时 (正常约 4.2~5.5ms) */
+#define DHT_TIMEOUT_US        8000u
+
+/* 下降沿个数：1 个应答 + 40 个数据位 + 1 个结束 */
+#define DHT_EDGES             42u
+
+#if DHT_TIM_SHARED && (DHT_TIM_CHANNEL == DELAY_ASYNC_TIM_CHANNEL)
+#error "dht_capture 与 delay_async 共用定时器时必须用不同的通道"
+#endif
+#if DHT_TIM_SHARED && (DHT_TIM_BITS != DELAY_ASYNC_TIM_BITS)
+#error "共用定时器时 DHT_TIM_BITS 必须等于 DELAY_ASYNC_TIM_BITS"
+#endif
+
+/**
+ * @brief 读取结果
+ */
+typedef enum {
+    DHT_OK = 0,
+    DHT_ERR_BUSY,       // 上一次读取还没结束
+    DHT_ERR_TIMEOUT,    // 传感器没有应答或边沿不够
+    DHT_ERR_TIMING,     // 脉宽不在合理范围
+    DHT_ERR_CHECKSUM,   // 校验和错误
+} dht_status_t;
+
+typedef struct {
+    int16_t temperature_x10;    // 温度 x10 (0.1°C)
+    uint16_t humidity_x10;      // 湿度 x10 (0.1%RH)
+    uint8_t raw[5];             // 原始 40 位数据
+} dht_reading_t;
+
+/**
+ * @brief 读取完成回调 (在中断上下文中执行)
+ */
+typedef void (*dht_done_cb_t)(dht_status_t status, const dht_reading_t *reading, void *arg);
+
+/**
+ * @brief 初始化 (引脚置为开漏输出高电平)
+ * @note  在 MX_TIMx_Init 和 delay_async_init 之后调用
+ */
+void dht_init(void);
+
+/**
+ * @brief 启动一次读取，立即返回
+ * @note  DHT 两次读取间隔不要小于 1s (DHT22 为 2s)
+ * @return 0 已启动，-1 忙或定时器队列已满
+ */
+int dht_read_async(dht_done_cb_t cb, void *arg);
+
+/**
+ * @brief 捕获 DMA 完成处理
+ * @note  在 HAL_TIM_IC_CaptureCallback 中调用: dht_capture_irq_handler(htim);
+ */
+void dht_capture_irq_handler(TIM_HandleTypeDef *htim);
+
+/**
+ * @brief 由下降沿时间戳解码 (与硬件无关，可在 PC 上用录下的边沿验证)
+ * @param edges 下降沿时间戳 (us)，只使用最后 41 个
+ * @param n 边沿个数
+ */
+dht_status_t dht_decode(const uint32_t *edges, uint16_t n, dht_reading_t *out);
+
+#if defined(USE_FREERTOS)
+/**
+ * @brief 阻塞读取：挂起当前任务直到读取完成，等待期间不占 CPU
+ * @note  只能在任务中调用
+ */
+dht_status_t dht_read(dht_reading_t *out);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DHT_CAPTURE_H__ */
@@ -0,0 +1,387 @@
+/**
+ * @file dht_sim.c
+ * @brief 主机端工具：在模拟时钟上用逐边沿的传感器模型校验 dht_capture 的读取流程
+ * @note  纯 C99，直接链接 MCU 端的 dht_capture.c 与 delay_async.c (两者共用同一个模拟定时器)，
+ *        HAL 换成 host/ 下的替身，FreeRTOS 替身复用 Delay_us/tools/host。用法:
+ *          gcc -O2 -Ihost -I.. -I../../Delay_us -I../../Delay_us/tools/host -o dht_sim \
+ *              dht_sim.c ../dht_capture.c ../../Delay_us/delay_async.c
+ *          (16 位定时器再加 -DDHT_TIM_BITS=16 -DDELAY_ASYNC_TIM_BITS=16，DHT11 加 -DDHT_TYPE=11)
+ *          ./dht_sim [轮数]
+ *        模拟时钟每步计数器 +1 (1 tick = 1us)。传感器在主机释放总线后按协议拉出下降沿
+ *        (应答 80us 低 + 80us 高，每位 50us 低 + 26/70us 高，带随机抖动)，引脚处于捕获模式时
+ *        计数器值锁进 CH2 的 CCR 并由"DMA"搬进缓冲区，搬满后像 HAL 一样置 htim->Channel 调用
+ *        dht_capture_irq_handler。校验：
+ *        1. 随机数据 (含负温度、计数器回绕、丢失应答沿) 读出的原始字节与换算值都正确，回调恰好一次，
+ *           起始信号低电平不短于规定值，结束后总线回到开漏输出高电平；
+ *        2. 读取期间同一定时器 CH1 上的 delay_async 定时照常准点触发 (共用定时器互不干扰)；
+ *        3. 传感器不在、数据里有毛刺、校验和错误分别报 TIMEOUT / TIMING / CHECKSUM；
+ *        4. 读取中再次发起返回忙，过期的超时回调不会再触发一次完成；
+ *        5. dht_read 阻塞读取不被同一通知下标上残留的通知提前唤醒。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dht_capture.h"
+
+#if DHT_TIM_BITS >= 32
+#define SIM_MASK    0xFFFFFFFFu
+#else
+#define SIM_MASK    ((1u << DHT_TIM_BITS) - 1u)
+#endif
+
+#if DHT_TYPE == 11
+#define SIM_START_MIN   18000u     // 规格书要求的最短起始信号
+#define SIM_START_US    20000u     // 与驱动里的 DHT_START_US 一致
+#else
+#define SIM_START_MIN   1000u
+#define SIM_START_US    2000u
+#endif
+
+/* ================= 模拟硬件 ================= */
+
+uint32_t host_primask;
+uint32_t SystemCoreClock = 72000000u;
+GPIO_TypeDef host_gpioa;
+
+static TIM_TypeDef sim_tim;
+static DMA_HandleTypeDef sim_dma;
+TIM_HandleTypeDef htim2 = { &sim_tim, HAL_TIM_ACTIVE_CHANNEL_CLEARED, { NULL, &sim_dma, &sim_dma, &sim_dma, &sim_dma } };
+
+static uint64_t sim_time;       // 绝对时间 (us)，不回绕
+
+static uint32_t pin_mode = GPIO_MODE_OUTPUT_OD;
+static uint64_t pin_low_at;     // 主机拉低总线的时刻
+static uint64_t start_low_min = UINT64_MAX;
+
+static uint32_t *ic_buf;        // 捕获 DMA 目的地址，NULL = 未启动
+static uint32_t ic_channel;
+static int n_wrong_channel;
+
+/* 传感器：下一次读取要拉出的下降沿 (相对释放时刻的时间) */
+#define MAX_EDGES   64
+static uint32_t sensor_at[MAX_EDGES];
+static int sensor_n, sensor_pos;
+static uint64_t released_at;
+static int sensor_armed;
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init)
+{
+    (void)port;
+    if (init->Pin != DHT_GPIO_PIN) return;
+    if (pin_mode == GPIO_MODE_OUTPUT_OD && init->Mode != GPIO_MODE_OUTPUT_OD) {
+        // 释放总线：起始信号到此结束，传感器开始应答
+        if (!(host_gpioa.ODR & DHT_GPIO_PIN) && sim_time - pin_low_at < start_low_min) {
+            start_low_min = sim_time - pin_low_at;
+        }
+        released_at = sim_time;
+        sensor_pos = 0;
+        sensor_armed = 1;
+    }
+    pin_mode = init->Mode;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    if (state) {
+        port->ODR |= pin;
+    } else {
+        if (port->ODR & pin) pin_low_at = sim_time;
+        port->ODR &= ~(uint32_t)pin;
+    }
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_DMA(TIM_HandleTypeDef *h, uint32_t ch, uint32_t *data, uint16_t len)
+{
+    if (ch != DHT_TIM_CHANNEL || h != &htim2) n_wrong_channel++;
+    ic_channel = ch;
+    ic_buf = data;
+    sim_dma.NDTR = len;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Stop_DMA(TIM_HandleTypeDef *h, uint32_t ch)
+{
+    (void)h;
+    if (ch != ic_channel) n_wrong_channel++;
+    ic_buf = NULL;
+    return HAL_OK;
+}
+
+/**
+ * @brief 派发挂起的比较中断 (关中断期间不派发)
+ */
+static void sim_irq(void)
+{
+    while (!host_primask && (sim_tim.SR & sim_tim.DIER & TIM_IT_CC1)) {
+        sim_tim.SR &= ~TIM_FLAG_CC1;
+        delay_async_irq_handler();
+    }
+}
+
+/**
+ * @brief 下降沿：引脚处于捕获模式时锁存计数器，DMA 搬走，搬满时调用捕获完成回调
+ */
+static void sim_edge(void)
+{
+    if (pin_mode == GPIO_MODE_OUTPUT_OD || ic_buf == NULL || sim_dma.NDTR == 0) {
+        return;
+    }
+    sim_tim.CCR[ic_channel >> 2] = sim_tim.CNT;
+    ic_buf[DHT_EDGES - sim_dma.NDTR] = sim_tim.CCR[ic_channel >> 2];
+    if (--sim_dma.NDTR == 0) {
+        htim2.Channel = (HAL_TIM_ActiveChannel)(1u << (ic_channel >> 2));
+        dht_capture_irq_handler(&htim2);        // HAL_TIM_IC_CaptureCallback 里的转发
+        htim2.Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+    }
+}
+
+static void sim_tick(void)
+{
+    sim_time++;
+    sim_tim.CNT = (sim_tim.CNT + 1u) & SIM_MASK;
+    if (sim_tim.CNT == sim_tim.CCR[0]) {
+        sim_tim.SR |= TIM_FLAG_CC1;
+    }
+    while (sensor_armed && sensor_pos < sensor_n && sim_time == released_at + sensor_at[sensor_pos]) {
+        sensor_pos++;
+        sim_edge();
+    }
+    sim_irq();
+}
+
+static void sim_run(uint32_t us)
+{
+    while (us--) sim_tick();
+}
+
+/* ================= 单任务 FreeRTOS 替身 ================= */
+
+static uint32_t notify[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+static TaskHandle_t const sim_task = (TaskHandle_t)&notify;
+
+BaseType_t xTaskGetSchedulerState(void) { return taskSCHEDULER_RUNNING; }
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return sim_task; }
+
+uint32_t ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear, TickType_t wait)
+{
+    (void)wait;
+    while (notify[index] == 0) sim_tick();      // 任务挂起期间时间照走
+    uint32_t v = notify[index];
+    notify[index] = clear ? 0 : v - 1;
+    return v;
+}
+
+void vTaskNotifyGiveIndexedFromISR(TaskHandle_t task, UBaseType_t index, BaseType_t *woken)
+{
+    if (task == sim_task) notify[index]++;
+    *woken = pdTRUE;
+}
+
+/* delay_block_us 的退化路径 */
+void delay_us(uint32_t us) { sim_run(us); }
+void delay_smart_us(uint32_t us) { sim_run(us); }
+
+/* ================= 传感器模型 ================= */
+
+enum { FAULT_NONE = 0, FAULT_ABSENT, FAULT_GLITCH, FAULT_CHECKSUM };
+
+static uint32_t jitter(uint32_t us, uint32_t j)
+{
+    return us - j + (uint32_t)rand() % (2 * j + 1);
+}
+
+/**
+ * @brief 按协议生成一次应答的下降沿序列
+ * @param with_response 0 = 应答沿落在捕获启动之前 (只剩 41 个沿，靠超时兜底解码)
+ */
+static void sensor_prepare(uint8_t raw[5], int with_response, int fault)
+{
+    uint32_t t = jitter(30, 10);
+
+    raw[4] = (uint8_t)(raw[0] + raw[1] + raw[2] + raw[3]);
+    if (fault == FAULT_CHECKSUM) raw[4] ^= 0x10;
+
+    sensor_n = 0;
+    if (fault == FAULT_ABSENT) return;
+    if (with_response) sensor_at[sensor_n++] = t;
+    t += jitter(80, 5) + jitter(80, 5);
+    for (int i = 0; i < 40; i++) {
+        sensor_at[sensor_n++] = t;
+        uint32_t high = (raw[i >> 3] & (0x80u >> (i & 7))) ? jitter(70, 8) : jitter(26, 8);
+        if (fault == FAULT_GLITCH && i == 20) sensor_at[sensor_n++] = t + 50 + high / 2;
+        t += jitter(50, 5) + high;
+    }
+    sensor_at[sensor_n++] = t;
+}
+
+static void expect_values(const uint8_t r[5], int16_t *t_x10, uint16_t *h_x10)
+{
+#if DHT_TYPE == 11
+    *h_x10 = (uint16_t)(r[0] * 10u + r[1]);
+    *t_x10 = (int16_t)(r[2] * 10 + (r[3] & 0x7F));
+    if (r[3] & 0x80) *t_x10 = (int16_t)-*t_x10;
+#else
+    *h_x10 = (uint16_t)((r[0] << 8) | r[1]);
+    *t_x10 = (int16_t)(((r[2] & 0x7F) << 8) | r[3]);
+    if (r[2] & 0x80) *t_x10 = (int16_t)-*t_x10;
+#endif
+}
+
+/* ================= 记录 ================= */
+
+static int n_done;
+static dht_status_t last_status;
+static dht_reading_t last_reading;
+
+static void done_cb(dht_status_t status, const dht_reading_t *reading, void *arg)
+{
+    (void)arg;
+    n_done++;
+    last_status = status;
+    last_reading = *reading;
+}
+
+/* 同一定时器 CH1 上的旁路定时 */
+static int n_side, n_side_late;
+static uint64_t side_due[8];
+
+static void side_cb(void *arg)
+{
+    n_side++;
+    if (sim_time != side_due[(uintptr_t)arg]) n_side_late++;
+}
+
+static int bus_idle(void)
+{
+    return pin_mode == GPIO_MODE_OUTPUT_OD && (host_gpioa.ODR & DHT_GPIO_PIN) && ic_buf == NULL;
+}
+
+/**
+ * @brief 异步读一次，跑到结束后再多跑一个超时周期 (过期超时不能再回调)
+ */
+static dht_status_t read_once(uint8_t raw[5], int with_response, int fault)
+{
+    sensor_prepare(raw, with_response, fault);
+    sensor_armed = 0;
+    n_done = 0;
+    if (dht_read_async(done_cb, NULL) != 0) return DHT_ERR_BUSY;
+    sim_run(SIM_START_US + DHT_TIMEOUT_US + 10000u);
+    return n_done == 1 ? last_status : DHT_ERR_BUSY;
+}
+
+/* ================= 用例 ================= */
+
+static int test_random(int rounds)
+{
+    int n_bad = 0, n_neg = 0, n_noresp = 0, n_multi = 0, n_busy = 0;
+
+    n_side = n_side_late = 0;
+    for (int r = 0; r < rounds; r++) {
+        uint8_t raw[5];
+        int16_t t_x10;
+        uint16_t h_x10;
+        int with_response = rand() % 4 != 0;
+
+        for (int i = 0; i < 4; i++) raw[i] = (uint8_t)rand();
+        if (r % 8 == 0) sim_tim.CNT = (SIM_MASK - (uint32_t)rand() % 8000u) & SIM_MASK;    // 读取中途回绕
+
+        sensor_prepare(raw, with_response, FAULT_NONE);
+        sensor_armed = 0;
+        n_done = 0;
+        if (dht_read_async(done_cb, NULL) != 0) { n_bad++; continue; }
+        if (dht_read_async(done_cb, NULL) == 0) n_busy++;
+
+        // 读取期间在 CH1 上挂几个旁路定时
+        for (uintptr_t k = 0; k < 3; k++) {
+            uint32_t us = 1 + (uint32_t)rand() % 9000u;
+            side_due[k] = sim_time + us;
+            if (delay_async_us(us, side_cb, (void *)k) != 0) n_bad++;
+        }
+        sim_run(1 + (uint32_t)rand() % 2000u);
+        if (dht_read_async(done_cb, NULL) == 0) n_busy++;
+        sim_run(SIM_START_US + DHT_TIMEOUT_US + 10000u);
+
+        expect_values(raw, &t_x10, &h_x10);
+        if (n_done != 1) n_multi++;
+        if (n_done != 1 || last_status != DHT_OK || memcmp(last_reading.raw, raw, 5) != 0 ||
+            last_reading.temperature_x10 != t_x10 || last_reading.humidity_x10 != h_x10 || !bus_idle()) {
+            if (n_bad++ < 5) {
+                printf("  round %d: %d callbacks, status %d, raw %02X%02X%02X%02X%02X want %02X%02X%02X%02X%02X\n",
+                       r, n_done, (int)last_status, last_reading.raw[0], last_reading.raw[1], last_reading.raw[2],
+                       last_reading.raw[3], last_reading.raw[4], raw[0], raw[1], raw[2], raw[3], raw[4]);
+            }
+        }
+        if (t_x10 < 0) n_neg++;
+        if (!with_response) n_noresp++;
+    }
+
+    int bad = n_bad || n_multi || n_busy || n_side != 3 * rounds || n_side_late || n_wrong_channel ||
+              start_low_min < SIM_START_MIN;
+    printf("%-30s %s (%d reads, %d negative, %d without response edge, %d bad, %d busy accepted)\n",
+           "random readings", bad ? "FAIL" : "ok", rounds, n_neg, n_noresp, n_bad, n_busy);
+    printf("%-30s %s (%d/%d on time, %d late, start low >= %llu us)\n", "shared timer CH1 + CH2",
+           (n_side == 3 * rounds && !n_side_late && !n_wrong_channel) ? "ok" : "FAIL", n_side - n_side_late,
+           3 * rounds, n_side_late, (unsigned long long)start_low_min);
+    return bad;
+}
+
+static int test_faults(void)
+{
+    static const struct { const char *name; int fault; dht_status_t want; } cases[] = {
+        { "sensor absent -> TIMEOUT", FAULT_ABSENT, DHT_ERR_TIMEOUT },
+        { "glitch -> TIMING", FAULT_GLITCH, DHT_ERR_TIMING },
+        { "bad checksum -> CHECKSUM", FAULT_CHECKSUM, DHT_ERR_CHECKSUM },
+    };
+    int bad = 0;
+
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint8_t raw[5] = { 0x02, 0x8C, 0x80, 0x65, 0 };
+        dht_status_t st = read_once(raw, 1, cases[i].fault);
+        int ok = st == cases[i].want && bus_idle();
+        bad |= !ok;
+        printf("%-30s %s (status %d, %d callbacks)\n", cases[i].name, ok ? "ok" : "FAIL", (int)st, n_done);
+    }
+    return bad;
+}
+
+static int test_blocking(void)
+{
+    uint8_t raw[5] = { 0x01, 0xF4, 0x81, 0x2C, 0 };
+    dht_reading_t out;
+    int16_t t_x10;
+    uint16_t h_x10;
+
+    sensor_prepare(raw, 1, FAULT_NONE);
+    sensor_armed = 0;
+    notify[0] = 1;                              // 应用发到默认槽的通知
+    notify[DELAY_ASYNC_NOTIFY_INDEX] = 1;       // 同一下标上残留的通知
+    uint64_t t0 = sim_time;
+    dht_status_t st = dht_read(&out);
+    uint64_t took = sim_time - t0;
+
+    expect_values(raw, &t_x10, &h_x10);
+    int ok = st == DHT_OK && memcmp(out.raw, raw, 5) == 0 && out.temperature_x10 == t_x10 &&
+             out.humidity_x10 == h_x10 && took >= SIM_START_MIN + 4000u && bus_idle();
+    printf("%-30s %s (%.1f C, %.1f %%RH after %llu us)\n", "dht_read blocking", ok ? "ok" : "FAIL",
+           out.temperature_x10 / 10.0, out.humidity_x10 / 10.0, (unsigned long long)took);
+    notify[0] = 0;
+    sim_run(DHT_TIMEOUT_US + 1000u);
+    return !ok;
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = argc > 1 ? atoi(argv[1]) : 500;
+    int bad = 0;
+
+    srand(7);
+    delay_async_init();
+    dht_init();
+
+    printf("DHT%d, %d-bit timer shared with delay_async\n", DHT_TYPE, DHT_TIM_BITS);
+    bad |= test_random(rounds);
+    bad |= test_faults();
+    bad |= test_blocking();
+    return bad ? 1 : 0;
+}
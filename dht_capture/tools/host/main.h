@@ -0,0 +1,126 @@
+/**
+ * @file main.h
+ * @brief 主机端替身：只提供 dht_capture / delay_async 用到的 HAL 与 CMSIS 接口
+ * @note  定时器是一组普通变量，由测试程序的模拟时钟推进；两个驱动共用同一个定时器，
+ *        比较 (delay_async) 与捕获 (dht_capture) 各写各的 CCR。输入捕获 DMA 只保留剩余计数，
+ *        边沿由测试程序在模拟时钟里搬进缓冲区。GPIO 初始化与写引脚由测试程序实现 (要跟踪引脚模式)。
+ *        FreeRTOS.h / task.h 复用 Delay_us/tools/host 下的替身。
+ */
+
+#ifndef __HOST_MAIN_H__
+#define __HOST_MAIN_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+/* ================= 内核 ================= */
+
+extern uint32_t host_primask;
+
+static inline uint32_t __get_PRIMASK(void) { return host_primask; }
+static inline void __set_PRIMASK(uint32_t v) { host_primask = v; }
+static inline void __disable_irq(void) { host_primask = 1; }
+static inline void __enable_irq(void) { host_primask = 0; }
+
+extern uint32_t SystemCoreClock;
+
+/* ================= GPIO ================= */
+
+typedef struct {
+    __IO uint32_t IDR, ODR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef host_gpioa;
+#define GPIOA   (&host_gpioa)
+
+#define GPIO_PIN_0      ((uint16_t)0x0001)
+#define GPIO_PIN_1      ((uint16_t)0x0002)
+#define GPIO_PIN_2      ((uint16_t)0x0004)
+#define GPIO_PIN_3      ((uint16_t)0x0008)
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+typedef struct {
+    uint32_t Pin, Mode, Pull, Speed, Alternate;
+} GPIO_InitTypeDef;
+
+#define GPIO_MODE_INPUT         0x00u
+#define GPIO_MODE_OUTPUT_OD     0x11u
+#define GPIO_MODE_AF_OD         0x12u
+#define GPIO_NOPULL             0x0u
+#define GPIO_SPEED_FREQ_HIGH    0x2u
+#define GPIO_AF1_TIM2           0x1u
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+
+/* ================= 定时器 + DMA ================= */
+
+typedef struct {
+    __IO uint32_t NDTR;         // 剩余传输个数
+} DMA_HandleTypeDef;
+
+#define __HAL_DMA_GET_COUNTER(h)    ((h)->NDTR)
+
+typedef struct {
+    __IO uint32_t CR1, DIER, SR, EGR, CNT, ARR;
+    __IO uint32_t CCR[4];
+} TIM_TypeDef;
+
+typedef enum {
+    HAL_TIM_ACTIVE_CHANNEL_1 = 0x01,
+    HAL_TIM_ACTIVE_CHANNEL_2 = 0x02,
+    HAL_TIM_ACTIVE_CHANNEL_3 = 0x04,
+    HAL_TIM_ACTIVE_CHANNEL_4 = 0x08,
+    HAL_TIM_ACTIVE_CHANNEL_CLEARED = 0x00,
+} HAL_TIM_ActiveChannel;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+    HAL_TIM_ActiveChannel Channel;
+    DMA_HandleTypeDef *hdma[7];
+} TIM_HandleTypeDef;
+
+/* 与 HAL 相同的取值：通道号 = CCR 下标 * 4，CCx 的中断/标志/事件位一致 */
+#define TIM_CHANNEL_1           0x0u
+#define TIM_CHANNEL_2           0x4u
+#define TIM_CHANNEL_3           0x8u
+#define TIM_CHANNEL_4           0xCu
+#define TIM_IT_CC1              (1u << 1)
+#define TIM_IT_CC2              (1u << 2)
+#define TIM_FLAG_CC1            (1u << 1)
+#define TIM_FLAG_CC2            (1u << 2)
+#define TIM_EVENTSOURCE_CC1     (1u << 1)
+#define TIM_EVENTSOURCE_CC2     (1u << 2)
+#define TIM_DMA_ID_CC1          1u
+#define TIM_DMA_ID_CC2          2u
+#define TIM_DMA_ID_CC3          3u
+#define TIM_DMA_ID_CC4          4u
+
+#define __HAL_TIM_GET_COUNTER(h)            ((h)->Instance->CNT)
+#define __HAL_TIM_SET_COMPARE(h, ch, v)     ((h)->Instance->CCR[(ch) >> 2] = (v))
+#define __HAL_TIM_CLEAR_FLAG(h, f)          ((h)->Instance->SR &= ~(uint32_t)(f))
+#define __HAL_TIM_ENABLE_IT(h, it)          ((h)->Instance->DIER |= (it))
+#define __HAL_TIM_DISABLE_IT(h, it)         ((h)->Instance->DIER &= ~(uint32_t)(it))
+
+static inline HAL_StatusTypeDef HAL_TIM_GenerateEvent(TIM_HandleTypeDef *h, uint32_t ev)
+{
+    h->Instance->SR |= ev;
+    return HAL_OK;
+}
+
+static inline HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *h, uint32_t ch)
+{
+    h->Instance->DIER |= 2u << (ch >> 2);
+    h->Instance->CR1 |= 1u;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_DMA(TIM_HandleTypeDef *h, uint32_t ch, uint32_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_TIM_IC_Stop_DMA(TIM_HandleTypeDef *h, uint32_t ch);
+
+#endif /* __HOST_MAIN_H__ */
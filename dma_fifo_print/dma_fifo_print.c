@@ -5,36 +5,245 @@
 
 #include "dma_fifo_print.h"
 #include <string.h> // memcpy
+#include <stdarg.h>
+#if DMA_PRINT_USE_FAST_FMT
+#include "fast_fmt.h"
+#endif
+#if defined(USE_DWT_TRACE)
+#include "dwt_trace.h"
+#endif
+#if DMA_PRINT_COMPRESS
+static void DMA_LZ_Sink(void *ctx, const uint8_t *data, uint16_t len);
+#endif
+#if DMA_PRINT_RTOS
+static void DMA_Rtos_Init(DMA_Print_Handle_t *hprint);
+#endif
 
 /* 定义全局实例，方便 fputc/_write 调用 */
+#if DMA_PRINT_NOINIT
+DMA_Print_Handle_t g_dma_print_handle DMA_PRINT_NOINIT_ATTR;
+#else
 DMA_Print_Handle_t g_dma_print_handle;
+#endif
+
+#if defined(USE_DWT_TRACE)
+/**
+ * @brief 标记缓冲区里有追踪帧以外的数据
+ * @note  只装着 trace_drain() 输出的传输不记 DMA 事件，否则每次导出都会产生新的记录，追踪缓冲永远倒不空
+ */
+static inline void DMA_Trace_Mark(DMA_Print_Handle_t *hprint) {
+    hprint->trace_user = 1;
+}
+#else
+#define DMA_Trace_Mark(hprint)  ((void)0)
+#endif
+
+#if DMA_PRINT_NOINIT
+static inline uint32_t DMA_NoInit_Check(const DMA_Print_Handle_t *hprint) {
+    return DMA_PRINT_NOINIT_MAGIC ^ ((uint32_t)hprint->head << 16 | hprint->tail) ^ 0x5A5A5A5Au;
+}
+
+/**
+ * @brief head/tail 变化后更新校验字
+ * @note  主循环和 DMA 完成中断都会调用，关中断保证校验字和指针一致
+ */
+static inline void DMA_NoInit_Seal(DMA_Print_Handle_t *hprint) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    hprint->noinit_check = DMA_NoInit_Check(hprint);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 判断 .noinit 里是否是上次运行留下的有效数据 (上电时 RAM 是随机值)
+ */
+static uint8_t DMA_NoInit_Valid(const DMA_Print_Handle_t *hprint) {
+    return hprint->noinit_magic == DMA_PRINT_NOINIT_MAGIC &&
+           hprint->head < TX_RING_BUFFER_SIZE &&
+           hprint->tail < TX_RING_BUFFER_SIZE &&
+           hprint->noinit_check == DMA_NoInit_Check(hprint);
+}
+#else
+#define DMA_NoInit_Seal(hprint)   ((void)0)
+#endif
 
 /**
  * @brief 初始化
  */
 void DMA_Printf_Init(DMA_Print_Handle_t *hprint, UART_HandleTypeDef *huart) {
     hprint->huart = huart;
+#if DMA_PRINT_NOINIT
+    // 上次复位前没发完的数据 [tail, head) 原样保留，DMA 的进度不算数，从 tail 重新发
+    if (DMA_NoInit_Valid(hprint)) {
+        hprint->noinit_recovered = (hprint->head - hprint->tail + TX_RING_BUFFER_SIZE) % TX_RING_BUFFER_SIZE;
+    } else {
+        hprint->head = 0;
+        hprint->tail = 0;
+        hprint->noinit_recovered = 0;
+    }
+    hprint->noinit_magic = DMA_PRINT_NOINIT_MAGIC;
+    DMA_NoInit_Seal(hprint);
+#else
     hprint->head = 0;
     hprint->tail = 0;
+#endif
     hprint->dma_is_busy = 0;
+    hprint->tx_len = 0;
+    hprint->last_push_tick = HAL_GetTick();
+#if defined(USE_DWT_TRACE)
+    hprint->trace_user = 1;     // .noinit 保留下来的内容当作普通数据
+    hprint->tx_traced = 0;
+#endif
+#if defined(USE_DRV_STATS)
+    memset(&hprint->stats, 0, sizeof(hprint->stats));
+#endif
+
+#if DMA_PRINT_TELEMETRY && DMA_TELEM_HW_CRC && defined(CRC)
+    __HAL_RCC_CRC_CLK_ENABLE();
+#endif
+
+#if DMA_PRINT_COMPRESS
+    // 流头直接进环形缓冲区，主机端解压工具靠它找到码流起点
+    hprint->lz_busy = 0;
+    dma_lz_init(&hprint->lz, DMA_LZ_Sink, hprint);
+#endif
+
+#if DMA_PRINT_RTOS
+    DMA_Rtos_Init(hprint);
+#endif
+
+#if DMA_PRINT_NOINIT
+    if (hprint->noinit_recovered) {
+        // 旧数据后面加一个分隔行，区分复位前后的日志；换行会立刻触发发送
+        static const char banner[] = "\r\n--- reset, above is unsent log from last run ---\r\n";
+        DMA_Printf_Push(hprint, (uint8_t *)banner, sizeof(banner) - 1);
+    }
+#endif
+}
+
+#if DMA_PRINT_USE_LL
+/* * ============================================================
+ * 寄存器级 (LL) 后端
+ * 复用 CubeMX 生成的 hdmatx 句柄拿到 DMA 流/通道地址，但不再调用任何 HAL 函数。
+ * 两种 DMA 架构：
+ *   - F2/F4/F7/H7: DMA Stream (SxCR/SxNDTR/SxPAR/SxM0AR，标志在 LISR/HISR)
+ *   - F0/F1/F3/G0/G4/L4: DMA Channel (CCR/CNDTR/CPAR/CMAR，标志在 ISR)
+ * ============================================================
+ */
+
+/* F1/F4 等老 USART 用 DR，新 IP (F0/F7/G0/H7/L4) 拆成了 TDR/RDR */
+#if defined(USART_TDR_TDR)
+#define DMA_LL_UART_TX_REG(inst)  (&(inst)->TDR)
+#else
+#define DMA_LL_UART_TX_REG(inst)  (&(inst)->DR)
+#endif
+
+#if defined(DMA_SxCR_EN)
+
+/* 与 HAL 内部的 DMA_Base_Registers 相同布局：StreamBaseAddress 指向 LISR 或 HISR */
+typedef struct {
+    __IO uint32_t ISR;
+    __IO uint32_t Reserved;
+    __IO uint32_t IFCR;
+} DMA_LL_Base_t;
+
+static void DMA_LL_Start(DMA_Print_Handle_t *hprint, uint8_t *src, uint16_t len) {
+    DMA_HandleTypeDef *hdma = hprint->huart->hdmatx;
+    DMA_Stream_TypeDef *stream = (DMA_Stream_TypeDef *)hdma->Instance;
+    DMA_LL_Base_t *base = (DMA_LL_Base_t *)hdma->StreamBaseAddress;
+
+    // Normal 模式下传输完成后 EN 自动清零，这里只是兜底
+    stream->CR &= ~DMA_SxCR_EN;
+    while (stream->CR & DMA_SxCR_EN) {
+    }
+
+    // 清掉该流的全部标志 (每个流 6 位)，否则 EN 会被拒绝
+    base->IFCR = 0x3FU << hdma->StreamIndex;
+
+    stream->PAR = (uint32_t)DMA_LL_UART_TX_REG(hprint->huart->Instance);
+    stream->M0AR = (uint32_t)src;
+    stream->NDTR = len;
+    stream->CR |= DMA_SxCR_TCIE | DMA_SxCR_TEIE | DMA_SxCR_EN;
+
+    hprint->huart->Instance->CR3 |= USART_CR3_DMAT;
+}
+
+/* @return 1 表示本次中断是传输结束 (完成或出错) */
+static uint8_t DMA_LL_Ack(DMA_Print_Handle_t *hprint) {
+    DMA_HandleTypeDef *hdma = hprint->huart->hdmatx;
+    DMA_LL_Base_t *base = (DMA_LL_Base_t *)hdma->StreamBaseAddress;
+    uint32_t done_mask = (DMA_FLAG_TCIF0_4 | DMA_FLAG_TEIF0_4) << hdma->StreamIndex;
+
+    if ((base->ISR & done_mask) == 0) {
+        return 0;
+    }
+    base->IFCR = 0x3FU << hdma->StreamIndex;
+    return 1;
+}
+
+#else /* DMA Channel 架构 */
+
+static void DMA_LL_Start(DMA_Print_Handle_t *hprint, uint8_t *src, uint16_t len) {
+    DMA_HandleTypeDef *hdma = hprint->huart->hdmatx;
+    DMA_Channel_TypeDef *ch = hdma->Instance;
+
+    // 通道必须先关闭才能改 CNDTR
+    ch->CCR &= ~DMA_CCR_EN;
+    hdma->DmaBaseAddress->IFCR = DMA_IFCR_CGIF1 << (hdma->ChannelIndex & 0x1CU);
+
+    ch->CPAR = (uint32_t)DMA_LL_UART_TX_REG(hprint->huart->Instance);
+    ch->CMAR = (uint32_t)src;
+    ch->CNDTR = len;
+    ch->CCR |= DMA_CCR_TCIE | DMA_CCR_TEIE | DMA_CCR_EN;
+
+    hprint->huart->Instance->CR3 |= USART_CR3_DMAT;
 }
 
+static uint8_t DMA_LL_Ack(DMA_Print_Handle_t *hprint) {
+    DMA_HandleTypeDef *hdma = hprint->huart->hdmatx;
+    uint32_t shift = hdma->ChannelIndex & 0x1CU;
+    uint32_t done_mask = (DMA_ISR_TCIF1 | DMA_ISR_TEIF1) << shift;
+
+    if ((hdma->DmaBaseAddress->ISR & done_mask) == 0) {
+        return 0;
+    }
+    hdma->DmaBaseAddress->IFCR = DMA_IFCR_CGIF1 << shift;
+    hdma->Instance->CCR &= ~DMA_CCR_EN;
+    return 1;
+}
+
+#endif /* DMA_SxCR_EN */
+
+/**
+ * @brief DMA 流/通道中断处理 (LL 后端)
+ * @note  传输出错时同样按“已发送”处理，丢掉这一段，避免环形缓冲区卡死
+ */
+void DMA_Printf_DMA_IRQHandler(DMA_Print_Handle_t *hprint) {
+    if (DMA_LL_Ack(hprint)) {
+        DMA_Printf_TxCpltCallback(hprint);
+    }
+}
+
+#endif /* DMA_PRINT_USE_LL */
+
+#if !DMA_PRINT_RTOS
 /**
  * @brief 内部函数：尝试启动 DMA 传输
  * @note 这是一个非阻塞函数，只计算长度并告诉 DMA 搬运工干活
  */
 static void DMA_Try_Transmit(DMA_Print_Handle_t *hprint) {
-    // 1. 如果 DMA 正在忙，直接退出，让它干完手里的活再说
-    if (hprint->dma_is_busy) {
-        return;
-    }
-
-    // 2. 如果头尾重合，说明没数据，收工
-    if (hprint->head == hprint->tail) {
+    // 1. DMA 正在忙或者没数据就退出；检查和占用要在同一个临界区里，
+    //    否则线程里的 Flush 和中断里的 Poll / 完成回调可能都看到空闲，各启动一次 DMA
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (hprint->dma_is_busy || hprint->head == hprint->tail) {
+        __set_PRIMASK(primask);
         return;
     }
+    hprint->dma_is_busy = 1;
+    __set_PRIMASK(primask);
 
-    // 3. 计算这次能搬运多长的数据
+    // 2. 计算这次能搬运多长的数据 (占用之后 tail 只有本次传输完成才会动)
     uint16_t length_to_send;
     
     if (hprint->head > hprint->tail) {
@@ -46,9 +255,23 @@ static void DMA_Try_Transmit(DMA_Print_Handle_t *hprint) {
         length_to_send = TX_RING_BUFFER_SIZE - hprint->tail;
     }
 
-    // 4. 标记忙碌，启动 DMA
-    hprint->dma_is_busy = 1;
+    // 3. 启动 DMA
+    hprint->tx_len = length_to_send;
+#if defined(USE_DWT_TRACE)
+    // 只装着追踪帧的传输不埋点；没发完的部分可能还有普通数据，标记留给下一次
+    hprint->tx_traced = hprint->trace_user;
+    if ((hprint->tail + length_to_send) % TX_RING_BUFFER_SIZE == hprint->head) {
+        hprint->trace_user = 0;
+    }
+    if (hprint->tx_traced) {
+        TRACE_BEGIN(TRACE_TRACK_DMA_PRINT, TRACE_EVT_DMA_TX, length_to_send);
+    }
+#endif
     
+#if DMA_PRINT_USE_LL
+    // 寄存器直写：跳过 HAL 的句柄锁、状态机和回调注册
+    DMA_LL_Start(hprint, &hprint->buffer[hprint->tail], length_to_send);
+#else
     // 注意：这里使用 HAL_UART_Transmit_DMA
     if (HAL_UART_Transmit_DMA(hprint->huart, 
                              (uint8_t *)&hprint->buffer[hprint->tail], 
@@ -56,13 +279,16 @@ static void DMA_Try_Transmit(DMA_Print_Handle_t *hprint) {
         // 如果启动失败（极其罕见），清除忙碌标志，防止死锁
         hprint->dma_is_busy = 0;
     }
+#endif
 }
 
 /**
- * @brief 将数据推入环形缓冲区
+ * @brief 内部函数：把数据拷进环形缓冲区 (不启动 DMA)
+ * @return 1 表示遇到换行或缓冲区已满，需要立即发送
  */
-void DMA_Printf_Push(DMA_Print_Handle_t *hprint, uint8_t *data, uint16_t len) {
+static uint8_t DMA_Ring_Write(DMA_Print_Handle_t *hprint, const uint8_t *data, uint16_t len) {
     uint16_t i;
+    uint8_t flush_now = 0;   // 遇到换行或缓冲区满时立即发送
     
     for (i = 0; i < len; i++) {
         uint16_t next_head = (hprint->head + 1) % TX_RING_BUFFER_SIZE;
@@ -71,26 +297,794 @@ void DMA_Printf_Push(DMA_Print_Handle_t *hprint, uint8_t *data, uint16_t len) {
         if (next_head != hprint->tail) {
             hprint->buffer[hprint->head] = data[i];
             hprint->head = next_head;
+            flush_now |= (data[i] == '\n');
         } else {
-            // 缓冲区溢出策略：丢弃数据
+            // 缓冲区溢出策略：丢弃数据，同时立刻发送腾出空间
+            flush_now = 1;
             break; 
         }
     }
-    
+    DMA_NoInit_Seal(hprint);
+#if defined(USE_DRV_STATS)
+    hprint->stats.bytes_in += i;
+    if (i < len) {
+        hprint->stats.dropped += len - i;
+        hprint->stats.overflows++;
+    }
+#endif
+    return flush_now;
+}
+
+#if DMA_PRINT_COMPRESS
+/**
+ * @brief 压缩器输出回调：压缩后的字节写进环形缓冲区
+ * @note  压缩码流里的 0x0A 不是换行，这里只关心缓冲区是否写满
+ */
+static void DMA_LZ_Sink(void *ctx, const uint8_t *data, uint16_t len) {
+    DMA_Print_Handle_t *hprint = (DMA_Print_Handle_t *)ctx;
+    hprint->lz_ring_full |= DMA_Ring_Write(hprint, data, len);
+}
+
+/**
+ * @brief 占用压缩器 (压缩器状态不可重入)
+ * @note  只在检查和置位时短暂关中断，编码本身不关中断
+ * @return 1: 占用成功; 0: 压缩器正被打断的线程 (或低优先级中断) 使用
+ */
+static uint8_t DMA_Compress_Lock(DMA_Print_Handle_t *hprint) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8_t ok = !hprint->lz_busy;
+    hprint->lz_busy = 1;
+    __set_PRIMASK(primask);
+    return ok;
+}
+
+/**
+ * @brief 内部函数：原始数据经压缩后写入环形缓冲区
+ * @note  中断打断了正在进行的编码时，这次输出整段丢弃并计入统计 (不能插进半个码字)
+ * @return 1 表示原始数据中有换行或缓冲区已满，需要立即发送
+ */
+static uint8_t DMA_Compress_Write(DMA_Print_Handle_t *hprint, const uint8_t *data, uint16_t len) {
+    if (!DMA_Compress_Lock(hprint)) {
+#if defined(USE_DRV_STATS)
+        hprint->stats.dropped += len;
+        hprint->stats.overflows++;
+#endif
+        return 0;
+    }
+
+    // 先刷新写入时刻：压缩期间空闲超时不会到期，Poll 不会去冲刷一个正在编码的压缩器
+    hprint->last_push_tick = HAL_GetTick();
+    hprint->lz_ring_full = 0;
+    dma_lz_feed(&hprint->lz, data, len, DMA_LZ_Sink, hprint);
+
+    // 行尾：把这一行全部编码完并插入同步点，主机端才能立刻显示
+    uint8_t flush_now = hprint->lz_ring_full;
+    if (memchr(data, '\n', len) != NULL) {
+        dma_lz_flush(&hprint->lz, DMA_LZ_Sink, hprint);
+        flush_now = 1;
+    }
+    hprint->lz_busy = 0;
+    return flush_now;
+}
+
+/**
+ * @brief 把压缩器里攒着的半行编码输出 (空闲超时 / 手动 Flush)
+ * @note  在中断里一律跳过，留给线程里的下一次 Poll 或 Push：中断里冲刷会打断线程里的一行
+ */
+static void DMA_Compress_Drain(DMA_Print_Handle_t *hprint) {
+    if (__get_IPSR() != 0 || !DMA_Compress_Lock(hprint)) {
+        return;
+    }
+    if (dma_lz_pending(&hprint->lz)) {
+        dma_lz_flush(&hprint->lz, DMA_LZ_Sink, hprint);
+    }
+    hprint->lz_busy = 0;
+}
+#endif
+
+/**
+ * @brief 内部函数：写入完成后决定是否启动 DMA
+ */
+static void DMA_Push_Commit(DMA_Print_Handle_t *hprint, uint8_t flush_now) {
+#if DMA_PRINT_COALESCE || DMA_PRINT_COMPRESS
+    hprint->last_push_tick = HAL_GetTick();
+#endif
+
+#if DMA_PRINT_COALESCE || defined(USE_DRV_STATS)
+    uint16_t pending = (hprint->head - hprint->tail + TX_RING_BUFFER_SIZE) % TX_RING_BUFFER_SIZE;
+#endif
+#if defined(USE_DRV_STATS)
+    if (pending > hprint->stats.level_max) {
+        hprint->stats.level_max = pending;
+    }
+#endif
+
+#if DMA_PRINT_COALESCE
+    // 凑够一批、遇到行尾或缓冲区已满才启动 DMA，其余留给空闲超时
+    if (!flush_now && pending < DMA_PRINT_COALESCE_BYTES) {
+        return;
+    }
+#else
+    (void)flush_now;
+#endif
+
     // 尝试触发发送
     DMA_Try_Transmit(hprint);
 }
 
+#else /* DMA_PRINT_RTOS */
+/* * ============================================================
+ * RTOS 模式：生产者写 MessageBuffer，drainer 任务批量交给 DMA
+ * ============================================================
+ */
+
+#define DMA_RTOS_EVT_DATA    (1u << 0)  // 生产者写入了新数据
+#define DMA_RTOS_EVT_TXDONE  (1u << 1)  // DMA 发送完成
+#define DMA_RTOS_BATCH       (TX_RING_BUFFER_SIZE / 2)  // buffer[] 两半轮流作为批次
+
+/**
+ * @brief 一次写入 (一次 Push / 一条 DMA_Printf / 一帧) 期间的目标缓冲区和暂存区
+ * @note  输出先在栈上攒成一条消息，再整条写进 MessageBuffer：要么整条进去，要么整条丢弃，
+ *        drainer 也按整条取出，所以不同生产者的行不会互相插断
+ */
+typedef struct {
+    MessageBufferHandle_t mb;         // NULL: 拿不到共用锁或已经丢过一段，其余全部丢弃
+    TickType_t block;                 // 缓冲区满时最长阻塞
+    volatile uint32_t *dropped;
+    UBaseType_t isr_mask;
+    uint8_t in_isr;
+    uint8_t locked;                   // 持有共用缓冲区互斥量
+#if defined(USE_DRV_STATS)
+    DMA_Print_Stats_t *stats;
+#endif
+#if defined(USE_DWT_TRACE)
+    uint8_t user;                     // 不是追踪帧：发送后要给 drainer 留埋点标记
+#endif
+    uint16_t len;
+    uint8_t msg[DMA_PRINT_RTOS_MSG_MAX];
+} DMA_Rtos_Writer_t;
+
+/**
+ * @brief 选定写入目标：中断 -> 中断缓冲区；已注册任务 -> 自己的缓冲区；其余任务 -> 共用缓冲区
+ */
+static void DMA_Rtos_Begin(DMA_Print_Handle_t *hprint, DMA_Rtos_Writer_t *w) {
+    w->dropped = &hprint->rtos_dropped;
+#if defined(USE_DRV_STATS)
+    w->stats = &hprint->stats;
+#endif
+#if defined(USE_DWT_TRACE)
+    w->user = 1;
+#endif
+    w->block = 0;
+    w->in_isr = 0;
+    w->locked = 0;
+    w->len = 0;
+
+    if (__get_IPSR() != 0) {
+        // 中断可能嵌套，多个中断共用一个缓冲区，写的时候关 (可屏蔽的) 中断
+        w->in_isr = 1;
+        w->mb = hprint->isr_mb;
+        return;
+    }
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        // 调度器启动前只有一个执行流，直接写共用缓冲区，等 drainer 第一次运行时发出
+        w->mb = hprint->shared_mb;
+        return;
+    }
+
+    DMA_Print_Producer_t *prod =
+        (DMA_Print_Producer_t *)pvTaskGetThreadLocalStoragePointer(NULL, DMA_PRINT_RTOS_TLS_INDEX);
+    if (prod != NULL) {
+        w->mb = prod->mb;
+        w->block = prod->block_ticks;
+        w->dropped = &prod->dropped;
+        return;
+    }
+
+    w->block = pdMS_TO_TICKS(DMA_PRINT_RTOS_BLOCK_MS);
+    if (xSemaphoreTake(hprint->shared_lock, w->block) == pdTRUE) {
+        w->mb = hprint->shared_mb;
+        w->locked = 1;
+    } else {
+        w->mb = NULL;
+    }
+}
+
+static void DMA_Rtos_Drop(DMA_Rtos_Writer_t *w, uint16_t len) {
+    w->mb = NULL;   // 一条输出丢了一段，后面的段也不再写 (也不再阻塞)，免得拼出残缺的行
+    if (w->in_isr) {
+        *w->dropped += len;
+#if defined(USE_DRV_STATS)
+        w->stats->overflows++;
+#endif
+    } else {
+        // rtos_dropped 中断里也会改
+        taskENTER_CRITICAL();
+        *w->dropped += len;
+#if defined(USE_DRV_STATS)
+        w->stats->overflows++;
+#endif
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief 写一条消息：任务在缓冲区满时阻塞等 drainer 腾空间 (背压)，中断不等待
+ * @return 1: 写入; 0: 丢弃
+ */
+static uint8_t DMA_Rtos_Send(DMA_Rtos_Writer_t *w, const uint8_t *data, uint16_t len) {
+    size_t sent = 0;
+
+    if (len == 0) {
+        return 1;
+    }
+    if (w->mb != NULL) {
+        if (w->in_isr) {
+            UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+            sent = xMessageBufferSendFromISR(w->mb, data, len, NULL);
+            taskEXIT_CRITICAL_FROM_ISR(mask);
+        } else {
+            sent = xMessageBufferSend(w->mb, data, len, w->block);
+        }
+    }
+    if (sent == 0) {
+        DMA_Rtos_Drop(w, len);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 追加到暂存区，攒满一条就写出去
+ */
+static void DMA_Rtos_Put(DMA_Rtos_Writer_t *w, const uint8_t *data, uint16_t len) {
+    while (len > 0) {
+        uint16_t n = DMA_PRINT_RTOS_MSG_MAX - w->len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&w->msg[w->len], data, n);
+        w->len += n;
+        data += n;
+        len -= n;
+        if (w->len == DMA_PRINT_RTOS_MSG_MAX) {
+            DMA_Rtos_Send(w, w->msg, w->len);
+            w->len = 0;
+        }
+    }
+}
+
+/**
+ * @brief 结束写入：写出暂存区，释放锁并唤醒 drainer
+ */
+static void DMA_Rtos_End(DMA_Print_Handle_t *hprint, DMA_Rtos_Writer_t *w) {
+    DMA_Rtos_Send(w, w->msg, w->len);
+#if defined(USE_DWT_TRACE)
+    if (w->user) {
+        hprint->trace_user = 1;
+    }
+#endif
+
+    if (w->in_isr) {
+        BaseType_t woken = pdFALSE;
+        xTaskNotifyFromISR(hprint->drainer, DMA_RTOS_EVT_DATA, eSetBits, &woken);
+        portYIELD_FROM_ISR(woken);
+        return;
+    }
+    if (w->locked) {
+        xSemaphoreGive(hprint->shared_lock);
+    }
+    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+        xTaskNotify(hprint->drainer, DMA_RTOS_EVT_DATA, eSetBits);
+    }
+}
+
+static void DMA_Rtos_Write(DMA_Print_Handle_t *hprint, const uint8_t *data, uint16_t len) {
+    DMA_Rtos_Writer_t w;
+    DMA_Rtos_Begin(hprint, &w);
+    DMA_Rtos_Put(&w, data, len);
+    DMA_Rtos_End(hprint, &w);
+}
+
+/**
+ * @brief 从一个缓冲区整条整条地取消息，直到取空或批次放不下下一条
+ */
+static uint16_t DMA_Rtos_Take(MessageBufferHandle_t mb, uint8_t *dst, uint16_t cap) {
+    uint16_t n = 0;
+    size_t got;
+
+    while (n < cap && (got = xMessageBufferReceive(mb, dst + n, cap - n, 0)) > 0) {
+        n += (uint16_t)got;
+    }
+    return n;
+}
+
+/**
+ * @brief 按 "中断 > 已注册任务 (优先级从高到低) > 共用" 的顺序填一个批次
+ * @note  高优先级的缓冲区先被腾空，串口饱和时排队变长的是低优先级的生产者
+ */
+static uint16_t DMA_Rtos_Collect(DMA_Print_Handle_t *hprint, uint8_t *dst, uint16_t cap) {
+    uint16_t n = DMA_Rtos_Take(hprint->isr_mb, dst, cap);
+
+    for (uint8_t i = 0; i < hprint->n_producers && n < cap; i++) {
+        n += DMA_Rtos_Take(hprint->producers[hprint->producer_order[i]].mb, dst + n, cap - n);
+    }
+    n += DMA_Rtos_Take(hprint->shared_mb, dst + n, cap - n);
+    return n;
+}
+
+#if defined(USE_DRV_STATS)
+/**
+ * @brief 所有缓冲区中待收取的字节数 (含每条消息的长度字段)
+ */
+static uint16_t DMA_Rtos_Pending(DMA_Print_Handle_t *hprint) {
+    uint32_t n = (DMA_PRINT_RTOS_ISR_SIZE - xMessageBufferSpacesAvailable(hprint->isr_mb)) +
+                 (DMA_PRINT_RTOS_SHARED_SIZE - xMessageBufferSpacesAvailable(hprint->shared_mb));
+
+    for (uint8_t i = 0; i < hprint->n_producers; i++) {
+        n += hprint->producers[i].size - xMessageBufferSpacesAvailable(hprint->producers[i].mb);
+    }
+    return (n > 0xFFFFu) ? 0xFFFFu : (uint16_t)n;
+}
+#endif
+
+/**
+ * @brief 启动一批 DMA 发送
+ */
+static void DMA_Rtos_Start(DMA_Print_Handle_t *hprint, uint8_t *src, uint16_t len, uint8_t traced) {
+    hprint->dma_is_busy = 1;
+    hprint->tx_len = len;
+#if defined(USE_DWT_TRACE)
+    hprint->tx_traced = traced;
+    if (traced) {
+        TRACE_BEGIN(TRACE_TRACK_DMA_PRINT, TRACE_EVT_DMA_TX, len);
+    }
+#else
+    (void)traced;
+#endif
+#if DMA_PRINT_USE_LL
+    DMA_LL_Start(hprint, src, len);
+#else
+    if (HAL_UART_Transmit_DMA(hprint->huart, src, len) != HAL_OK) {
+        hprint->dma_is_busy = 0;
+    }
+#endif
+}
+
+/**
+ * @brief drainer 任务：收集 -> 等上一批发完 -> 补收 -> 发送，两个批次轮流使用
+ * @note  DMA 在发一半时，另一半正在收集，串口两批之间几乎没有空档
+ */
+static void DMA_Rtos_Task(void *arg) {
+    DMA_Print_Handle_t *hprint = (DMA_Print_Handle_t *)arg;
+    uint8_t half = 0;
+    uint32_t evt;
+
+    for (;;) {
+        uint8_t *batch = &hprint->buffer[half * DMA_RTOS_BATCH];
+        uint8_t traced = 0;
+#if defined(USE_DRV_STATS)
+        uint16_t pending = DMA_Rtos_Pending(hprint);
+        if (pending > hprint->stats.level_max) {
+            hprint->stats.level_max = pending;
+        }
+#endif
+#if defined(USE_DWT_TRACE)
+        // 先取走标记再收集：标记是消息写完后才置的，对应的消息一定能被这次或之后的收集拿到
+        traced = hprint->trace_user;
+        hprint->trace_user = 0;
+#endif
+        uint16_t n = DMA_Rtos_Collect(hprint, batch, DMA_RTOS_BATCH);
+        if (n == 0) {
+            xTaskNotifyWait(0, DMA_RTOS_EVT_DATA, &evt, portMAX_DELAY);
+            continue;
+        }
+
+#if DMA_PRINT_COALESCE
+        // 串口空闲时，不满一批又没到行尾的数据 (如 Keil 逐字节 fputc) 再等一个空闲超时
+        while (!hprint->dma_is_busy && n < DMA_PRINT_COALESCE_BYTES && batch[n - 1] != '\n') {
+            if (xTaskNotifyWait(0, DMA_RTOS_EVT_DATA, &evt, pdMS_TO_TICKS(DMA_PRINT_IDLE_MS)) != pdTRUE) {
+                break;
+            }
+            n += DMA_Rtos_Collect(hprint, batch + n, DMA_RTOS_BATCH - n);
+        }
+#endif
+
+        // 上一批还在发：等它发完，顺便把这段时间新来的数据补进本批
+        while (hprint->dma_is_busy) {
+            xTaskNotifyWait(0, DMA_RTOS_EVT_TXDONE, &evt, portMAX_DELAY);
+        }
+#if defined(USE_DWT_TRACE)
+        traced |= hprint->trace_user;
+        hprint->trace_user = 0;
+#endif
+        n += DMA_Rtos_Collect(hprint, batch + n, DMA_RTOS_BATCH - n);
+
+#if defined(USE_DRV_STATS)
+        hprint->stats.bytes_in += n;
+#endif
+        DMA_Rtos_Start(hprint, batch, n, traced);
+        half ^= 1u;
+    }
+}
+
+static void DMA_Rtos_Init(DMA_Print_Handle_t *hprint) {
+    hprint->isr_mb = xMessageBufferCreate(DMA_PRINT_RTOS_ISR_SIZE);
+    hprint->shared_mb = xMessageBufferCreate(DMA_PRINT_RTOS_SHARED_SIZE);
+    hprint->shared_lock = xSemaphoreCreateMutex();
+    hprint->n_producers = 0;
+    hprint->rtos_dropped = 0;
+    xTaskCreate(DMA_Rtos_Task, "dma_print", DMA_PRINT_RTOS_STACK, hprint,
+                DMA_PRINT_RTOS_PRIORITY, &hprint->drainer);
+}
+
+int DMA_Printf_RegisterTask(DMA_Print_Handle_t *hprint, uint16_t size, uint32_t block_ms) {
+    if (hprint->n_producers >= DMA_PRINT_RTOS_MAX_PRODUCERS) {
+        return -1;
+    }
+    MessageBufferHandle_t mb = xMessageBufferCreate(size);
+    if (mb == NULL) {
+        return -1;
+    }
+    UBaseType_t prio = uxTaskPriorityGet(NULL);
+
+    taskENTER_CRITICAL();
+    uint8_t idx = hprint->n_producers;
+    if (idx >= DMA_PRINT_RTOS_MAX_PRODUCERS) {
+        taskEXIT_CRITICAL();
+        vMessageBufferDelete(mb);
+        return -1;
+    }
+    DMA_Print_Producer_t *prod = &hprint->producers[idx];
+    prod->mb = mb;
+    prod->task = xTaskGetCurrentTaskHandle();
+    prod->priority = prio;
+    prod->block_ticks = pdMS_TO_TICKS(block_ms);
+    prod->dropped = 0;
+    prod->size = size;
+
+    // 插入排序：drainer 按 producer_order 从高优先级往低收取
+    uint8_t i = idx;
+    while (i > 0 && hprint->producers[hprint->producer_order[i - 1]].priority < prio) {
+        hprint->producer_order[i] = hprint->producer_order[i - 1];
+        i--;
+    }
+    hprint->producer_order[i] = idx;
+    hprint->n_producers = idx + 1u;
+    taskEXIT_CRITICAL();
+
+    vTaskSetThreadLocalStoragePointer(NULL, DMA_PRINT_RTOS_TLS_INDEX, prod);
+    return 0;
+}
+#endif /* DMA_PRINT_RTOS */
+
+/**
+ * @brief 将数据推入环形缓冲区
+ */
+void DMA_Printf_Push(DMA_Print_Handle_t *hprint, uint8_t *data, uint16_t len) {
+#if DMA_PRINT_RTOS
+    DMA_Rtos_Write(hprint, data, len);
+#else
+#if DMA_PRINT_COMPRESS
+    uint8_t flush_now = DMA_Compress_Write(hprint, data, len);
+#else
+    uint8_t flush_now = DMA_Ring_Write(hprint, data, len);
+#endif
+    DMA_Trace_Mark(hprint);
+    DMA_Push_Commit(hprint, flush_now);
+#endif
+}
+
+#if DMA_PRINT_USE_FAST_FMT
+/**
+ * @brief fast_fmt 输出回调上下文：格式化结果直接写进环形缓冲区
+ */
+typedef struct {
+    DMA_Print_Handle_t *hprint;
+    uint8_t flush_now;
+#if DMA_PRINT_RTOS
+    DMA_Rtos_Writer_t w;
+#endif
+} DMA_Printf_Sink_t;
+
+static void DMA_Printf_Sink(void *ctx, const char *s, uint16_t len) {
+    DMA_Printf_Sink_t *sink = (DMA_Printf_Sink_t *)ctx;
+#if DMA_PRINT_RTOS
+    DMA_Rtos_Put(&sink->w, (const uint8_t *)s, len);
+#elif DMA_PRINT_COMPRESS
+    sink->flush_now |= DMA_Compress_Write(sink->hprint, (const uint8_t *)s, len);
+#else
+    sink->flush_now |= DMA_Ring_Write(sink->hprint, (const uint8_t *)s, len);
+#endif
+}
+
+/**
+ * @brief 格式化打印，跳过 newlib 的 printf 和中间缓冲区
+ */
+int DMA_Printf(DMA_Print_Handle_t *hprint, const char *format, ...) {
+    DMA_Printf_Sink_t sink;
+    va_list args;
+
+    sink.hprint = hprint;
+    sink.flush_now = 0;
+#if DMA_PRINT_RTOS
+    DMA_Rtos_Begin(hprint, &sink.w);
+#endif
+
+    va_start(args, format);
+    int n = fmt_vformat(DMA_Printf_Sink, &sink, format, args);
+    va_end(args);
+
+#if DMA_PRINT_RTOS
+    DMA_Rtos_End(hprint, &sink.w);
+#else
+    DMA_Trace_Mark(hprint);
+    DMA_Push_Commit(hprint, sink.flush_now);
+#endif
+    return n;
+}
+#endif
+
+#if DMA_PRINT_TELEMETRY
+/* * ============================================================
+ * 二进制遥测帧
+ * ============================================================
+ */
+
+#if !(DMA_TELEM_HW_CRC && defined(CRC))
+/* CRC-32/MPEG-2 半字节查表 (多项式 0x04C11DB7)，只占 64 字节 Flash */
+static const uint32_t s_crc32_nibble[16] = {
+    0x00000000u, 0x04C11DB7u, 0x09823B6Eu, 0x0D4326D9u,
+    0x130476DCu, 0x17C56B6Bu, 0x1A864DB2u, 0x1E475005u,
+    0x2608EDB8u, 0x22C9F00Fu, 0x2F8AD6D6u, 0x2B4BCB61u,
+    0x350C9B64u, 0x31CD86D3u, 0x3C8EA00Au, 0x384FBDBDu,
+};
+#endif
+
+/**
+ * @brief 计算 type + 负载的 CRC (按小端 32 位字输入，末尾不足 4 字节补 0)
+ * @note  与 CRC 外设复位后的默认配置完全一致，所以软硬件实现结果相同
+ */
+static uint32_t DMA_Telem_CRC(uint8_t type, const uint8_t *data, uint16_t len) {
+    uint32_t word = type;
+    uint8_t shift = 8;
+    uint16_t i = 0;
+
+#if DMA_TELEM_HW_CRC && defined(CRC)
+    // CRC 外设只有一个：一帧算完之前关中断，别的任务 / 中断的帧不会把字混进同一个 DR
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    CRC->CR = CRC_CR_RESET;
+#define DMA_TELEM_CRC_WORD(w)  (CRC->DR = (w))
+#else
+    uint32_t crc = 0xFFFFFFFFu;
+#define DMA_TELEM_CRC_WORD(w)  do {                                   \
+        crc ^= (w);                                                   \
+        for (uint8_t n = 0; n < 8; n++) {                             \
+            crc = (crc << 4) ^ s_crc32_nibble[crc >> 28];             \
+        }                                                             \
+    } while (0)
+#endif
+
+    for (;;) {
+        while (shift < 32 && i < len) {
+            word |= (uint32_t)data[i++] << shift;
+            shift += 8;
+        }
+        DMA_TELEM_CRC_WORD(word);
+        if (i >= len) {
+            break;
+        }
+        word = 0;
+        shift = 0;
+    }
+#undef DMA_TELEM_CRC_WORD
+
+#if DMA_TELEM_HW_CRC && defined(CRC)
+    uint32_t crc = CRC->DR;
+    __set_PRIMASK(primask);
+    return crc;
+#else
+    return crc;
+#endif
+}
+
+/**
+ * @brief COBS 编码状态：直接写在环形缓冲区里，code 字节回填
+ * @note  RTOS 模式下写在栈上的帧缓冲里 (从 0 开始，长度远小于 TX_RING_BUFFER_SIZE，不会回绕)
+ */
+typedef struct {
+    uint8_t *buf;
+    uint16_t pos;       // 下一个写入位置
+    uint16_t code_pos;  // 当前 code 字节的位置
+    uint8_t code;       // 当前块已有的字节数 + 1
+} DMA_Cobs_t;
+
+static inline uint16_t DMA_Ring_Next(uint16_t pos) {
+    return (uint16_t)((pos + 1) % TX_RING_BUFFER_SIZE);
+}
+
+static inline void DMA_Cobs_Put(DMA_Cobs_t *c, uint8_t b) {
+    if (b == 0) {
+        c->buf[c->code_pos] = c->code;
+        c->code_pos = c->pos;
+        c->pos = DMA_Ring_Next(c->pos);
+        c->code = 1;
+    } else {
+        c->buf[c->pos] = b;
+        c->pos = DMA_Ring_Next(c->pos);
+        c->code++;
+    }
+}
+
+/**
+ * @brief 发送一帧二进制遥测数据
+ */
+int DMA_Printf_Frame(DMA_Print_Handle_t *hprint, uint8_t type, const void *data, uint16_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    if (len > DMA_TELEM_MAX_PAYLOAD) {
+        return -1;
+    }
+
+#if DMA_PRINT_RTOS
+    uint8_t frame[DMA_TELEM_MAX_PAYLOAD + 8u];
+    uint16_t head = 0;
+#else
+    // 编码后长度是确定的：前后分隔符 2 + code 1 + type 1 + 负载 + CRC 4
+    uint16_t need = len + 8u;
+    uint16_t head = hprint->head;
+    uint16_t space = (hprint->tail + TX_RING_BUFFER_SIZE - head - 1) % TX_RING_BUFFER_SIZE;
+    if (space < need) {
+        // 整帧丢弃，同时立刻发送腾出空间
+#if defined(USE_DRV_STATS)
+        hprint->stats.dropped += need;
+        hprint->stats.overflows++;
+#endif
+        DMA_Push_Commit(hprint, 1);
+        return -1;
+    }
+#endif
+
+    uint32_t crc = DMA_Telem_CRC(type, p, len);
+
+    DMA_Cobs_t c;
+#if DMA_PRINT_RTOS
+    c.buf = frame;
+#else
+    c.buf = hprint->buffer;
+#endif
+    c.buf[head] = 0x00;
+    c.code_pos = DMA_Ring_Next(head);
+    c.pos = DMA_Ring_Next(c.code_pos);
+    c.code = 1;
+
+    DMA_Cobs_Put(&c, type);
+    for (uint16_t i = 0; i < len; i++) {
+        DMA_Cobs_Put(&c, p[i]);
+    }
+    DMA_Cobs_Put(&c, (uint8_t)crc);
+    DMA_Cobs_Put(&c, (uint8_t)(crc >> 8));
+    DMA_Cobs_Put(&c, (uint8_t)(crc >> 16));
+    DMA_Cobs_Put(&c, (uint8_t)(crc >> 24));
+
+    c.buf[c.code_pos] = c.code;
+    c.buf[c.pos] = 0x00;
+
+#if DMA_PRINT_RTOS
+    // 整帧作为一条消息写入，和 ring 模式一样不会发出半帧
+    DMA_Rtos_Writer_t w;
+    DMA_Rtos_Begin(hprint, &w);
+#if defined(USE_DWT_TRACE)
+    w.user = (type != TRACE_FRAME_TYPE);
+#endif
+    uint8_t ok = DMA_Rtos_Send(&w, frame, (uint16_t)(c.pos + 1u));
+    DMA_Rtos_End(hprint, &w);
+    return ok ? 0 : -1;
+#else
+    // 整帧写完才移动 Head，DMA 永远看不到半帧
+    hprint->head = DMA_Ring_Next(c.pos);
+    DMA_NoInit_Seal(hprint);
+#if defined(USE_DRV_STATS)
+    hprint->stats.bytes_in += need;
+#endif
+#if defined(USE_DWT_TRACE)
+    if (type != TRACE_FRAME_TYPE) {
+        DMA_Trace_Mark(hprint);
+    }
+#endif
+
+    DMA_Push_Commit(hprint, 0);
+    return 0;
+#endif
+}
+#endif
+
+/**
+ * @brief 立即发送缓冲区中的全部数据
+ */
+void DMA_Printf_Flush(DMA_Print_Handle_t *hprint) {
+#if DMA_PRINT_RTOS
+    // 只唤醒 drainer，不等待发送完成；中断里只能用 FromISR 版本
+    if (__get_IPSR() != 0) {
+        BaseType_t woken = pdFALSE;
+        xTaskNotifyFromISR(hprint->drainer, DMA_RTOS_EVT_DATA, eSetBits, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+        xTaskNotify(hprint->drainer, DMA_RTOS_EVT_DATA, eSetBits);
+    }
+#else
+#if DMA_PRINT_COMPRESS
+    DMA_Compress_Drain(hprint);
+#endif
+    DMA_Try_Transmit(hprint);
+#endif
+}
+
+/**
+ * @brief 空闲超时检查
+ * @note DMA 忙时不需要处理：传输完成回调会把积压的数据接着发出去
+ */
+void DMA_Printf_Poll(DMA_Print_Handle_t *hprint) {
+#if DMA_PRINT_RTOS
+    (void)hprint;   // 空闲超时由 drainer 任务处理
+#elif DMA_PRINT_COALESCE || DMA_PRINT_COMPRESS
+    if ((HAL_GetTick() - hprint->last_push_tick) < DMA_PRINT_IDLE_MS) {
+        return;
+    }
+
+#if DMA_PRINT_COMPRESS
+    // 压缩器里攒着半行数据：空闲了就编码输出，哪怕这一行还没结束
+    DMA_Compress_Drain(hprint);
+#endif
+
+    if (hprint->dma_is_busy || hprint->head == hprint->tail) {
+        return;
+    }
+    DMA_Try_Transmit(hprint);
+#else
+    (void)hprint;
+#endif
+}
+
 /**
  * @brief 用户需要在 HAL_UART_TxCpltCallback 中调用此函数
  */
 void DMA_Printf_TxCpltCallback(DMA_Print_Handle_t *hprint) {
+#if DMA_PRINT_RTOS
     if (hprint->dma_is_busy) {
-        // 利用 HAL 库记录的本次传输长度来更新尾指针
-        uint16_t sent_len = hprint->huart->TxXferSize; 
+        BaseType_t woken = pdFALSE;
+#if defined(USE_DWT_TRACE)
+        if (hprint->tx_traced) {
+            TRACE_END(TRACE_TRACK_DMA_PRINT, TRACE_EVT_DMA_TX, hprint->tx_len);
+        }
+#endif
+#if defined(USE_DRV_STATS)
+        hprint->stats.bytes_tx += hprint->tx_len;
+        hprint->stats.dma_xfers++;
+#endif
+        hprint->dma_is_busy = 0;
+        xTaskNotifyFromISR(hprint->drainer, DMA_RTOS_EVT_TXDONE, eSetBits, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+#else
+    if (hprint->dma_is_busy) {
+        // 用启动传输时记下的长度更新尾指针 (不再依赖 HAL 的 TxXferSize，LL 后端同样适用)
+        uint16_t sent_len = hprint->tx_len; 
+#if defined(USE_DWT_TRACE)
+        if (hprint->tx_traced) {
+            TRACE_END(TRACE_TRACK_DMA_PRINT, TRACE_EVT_DMA_TX, sent_len);
+        }
+#endif
+#if defined(USE_DRV_STATS)
+        hprint->stats.bytes_tx += sent_len;
+        hprint->stats.dma_xfers++;
+#endif
         
         // 更新 Tail
         hprint->tail = (hprint->tail + sent_len) % TX_RING_BUFFER_SIZE;
+        DMA_NoInit_Seal(hprint);
         
         // 标记空闲
         hprint->dma_is_busy = 0;
@@ -98,7 +1092,47 @@ void DMA_Printf_TxCpltCallback(DMA_Print_Handle_t *hprint) {
         // 看看还有没有剩下的数据需要发
         DMA_Try_Transmit(hprint);
     }
+#endif
+}
+
+#if defined(USE_DRV_STATS)
+/**
+ * @brief 统计快照
+ * @note  关中断拷贝，避免和发送完成中断交错
+ */
+void DMA_Printf_GetStats(DMA_Print_Handle_t *hprint, DMA_Print_Stats_t *out) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out = hprint->stats;
+#if DMA_PRINT_RTOS
+    uint32_t dropped = hprint->rtos_dropped;
+    for (uint8_t i = 0; i < hprint->n_producers; i++) {
+        dropped += hprint->producers[i].dropped;
+    }
+    out->dropped = dropped;
+#else
+    out->level = (hprint->head - hprint->tail + TX_RING_BUFFER_SIZE) % TX_RING_BUFFER_SIZE;
+#endif
+    __set_PRIMASK(primask);
+
+#if DMA_PRINT_RTOS
+    out->level = DMA_Rtos_Pending(hprint);
+#endif
+}
+
+void DMA_Printf_ResetStats(DMA_Print_Handle_t *hprint) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(&hprint->stats, 0, sizeof(hprint->stats));
+#if DMA_PRINT_RTOS
+    hprint->rtos_dropped = 0;
+    for (uint8_t i = 0; i < hprint->n_producers; i++) {
+        hprint->producers[i].dropped = 0;
+    }
+#endif
+    __set_PRIMASK(primask);
 }
+#endif
 
 /* * ============================================================
  * printf 重定向接口
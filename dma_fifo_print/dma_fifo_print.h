@@ -18,6 +18,152 @@ extern "C" {
 /* 定义缓冲区大小，必须是 2 的幂次方便位运算，或者根据内存调整 */
 #define TX_RING_BUFFER_SIZE 1024 
 
+/* * 写合并 (Coalescing)：
+ * Keil 的 fputc 每次只推 1 个字节，GCC 的 _write 也经常是几个字节，
+ * 如果每次 Push 都立刻启动 DMA，一行日志的第一个字符就会单独占用一次传输和一次中断。
+ * 开启后只有满足以下任一条件才启动 DMA：
+ *   1. 待发送字节数达到 DMA_PRINT_COALESCE_BYTES
+ *   2. 写入的数据里包含换行符 '\n'
+ *   3. 距离最后一次写入超过 DMA_PRINT_IDLE_MS (需要周期性调用 DMA_Printf_Poll)
+ * 默认关闭：不带换行的输出 (提示符、进度点) 在没人调用 Poll 时会一直攒着不发。
+ */
+#define DMA_PRINT_COALESCE        0
+#define DMA_PRINT_COALESCE_BYTES  64
+#define DMA_PRINT_IDLE_MS         2
+
+/* * 寄存器级 (LL) 后端：
+ * 置 1 后不再调用 HAL_UART_Transmit_DMA，直接写 DMA 流/通道寄存器并自己处理 TC 中断，
+ * 省掉 HAL 的句柄锁、状态检查和通用中断分发。
+ * 需要在 DMA 中断函数里调用 DMA_Printf_DMA_IRQHandler 代替 HAL_DMA_IRQHandler，
+ * 并且不能再对同一个 UART 使用 HAL 的 DMA 发送函数。
+ */
+#ifndef DMA_PRINT_USE_LL
+#define DMA_PRINT_USE_LL          0
+#endif
+
+/* * 日志压缩 (可选)：
+ * 置 1 后 Push 的数据先经过小窗口 LZSS 压缩 (dma_lz.c，RAM 约 1.6KB) 再进环形缓冲区，
+ * 换行或空闲超时时插入同步点。串口另一端用 tools/lz_decode.c 实时解压。
+ * 对重复度高的文本日志，同样的波特率下有效带宽约为 2~4 倍。
+ * 压缩器不可重入：中断里的输出如果正好打断了线程里的编码，这条输出整段丢弃 (计入统计)。
+ */
+#define DMA_PRINT_COMPRESS        0
+
+/* 提供 DMA_Printf：用 fast_fmt 边格式化边写入环形缓冲区 (需要把 fast_fmt/ 加入工程和头文件路径)
+ * 默认 0：本库保持零依赖，只通过 printf 重定向使用 */
+#ifndef DMA_PRINT_USE_FAST_FMT
+#define DMA_PRINT_USE_FAST_FMT    0
+#endif
+
+/* * 二进制遥测帧 (DMA_Printf_Frame)：
+ * 帧格式: 0x00 | COBS( type | payload | CRC32 小端 ) | 0x00
+ * 帧内不含 0x00，可以和文本日志混在同一个串口里，主机端用 tools/telem_host.c 分离。
+ * CRC 与 STM32 CRC 外设默认配置一致 (CRC-32/MPEG-2，按 32 位字输入，不足补 0)。
+ */
+#ifndef DMA_PRINT_TELEMETRY
+#define DMA_PRINT_TELEMETRY       0   /* 默认关闭，需要时置 1 */
+#endif
+/* 单帧最大负载：type + 负载 + CRC 不超过 253 字节时 COBS 固定只多 1 个字节 */
+#define DMA_TELEM_MAX_PAYLOAD     248
+/* 使用片上 CRC 外设 (芯片没有 CRC 外设时自动退回 64 字节查表的软件实现)
+ * 默认 0 (软件查表)：每帧都会写 CRC->CR 复位外设，F0/F3/G0/L4 等型号上同一个寄存器里还有
+ * POLYSIZE / REV_IN / REV_OUT，应用自己配置过的 CRC 会被清掉。确认没有别的代码用 CRC 外设时再置 1 */
+#ifndef DMA_TELEM_HW_CRC
+#define DMA_TELEM_HW_CRC          0
+#endif
+
+/* * 崩溃日志保留 (可选)：
+ * 置 1 后 g_dma_print_handle 放进不初始化的 .noinit 段，复位 (HardFault、看门狗、软复位) 后 RAM 内容还在。
+ * 每次移动 head/tail 时顺手更新一个校验字，下次 DMA_Printf_Init 校验通过就保留上次没发完的数据，
+ * 先把它们发出去再输出新日志。环形缓冲区本身就在 .noinit 里，不需要额外的镜像拷贝。
+ * 需要在链接脚本里加一个 NOLOAD 的 .noinit 段，见 README。
+ */
+#define DMA_PRINT_NOINIT          0
+
+/* * RTOS 模式 (可选，需要 FreeRTOS)：
+ * 置 1 后生产者不再直接写环形缓冲区，也不在中断里启动 DMA：
+ *   - 调用过 DMA_Printf_RegisterTask 的任务各有一个 MessageBuffer (单写单读，无锁)；
+ *   - 其余任务共用一个带互斥量的 MessageBuffer，中断共用一个临界区保护的 MessageBuffer；
+ *   - 每次 printf / DMA_Printf / 遥测帧在栈上攒成一条消息整条写入，要么全进要么全丢，行不会被插断；
+ *   - 一个低优先级的 drainer 任务按 "中断 > 已注册任务 (按优先级) > 共用" 的顺序把消息收进批次，
+ *     交给 DMA 发送；TX 完成中断只通知 drainer。
+ * 串口饱和时，写满的缓冲区让对应的生产者阻塞等待 (背压)，不会空转，也不挤占别人的缓冲区；
+ * 高优先级任务注册独立缓冲区后，只要它自己的平均速率不超过波特率就不会丢数据。
+ * 环形缓冲区 buffer[] 一分为二，作为 drainer 的双缓冲批次使用。
+ */
+#ifndef DMA_PRINT_RTOS
+#define DMA_PRINT_RTOS            0
+#endif
+#define DMA_PRINT_RTOS_MSG_MAX        128   /* 单条消息上限 (栈上暂存)，更长的输出拆成多条 */
+#define DMA_PRINT_RTOS_ISR_SIZE       256   /* 中断共用缓冲区 (字节，每条消息另占 4 字节长度) */
+#define DMA_PRINT_RTOS_SHARED_SIZE    512   /* 未注册任务共用缓冲区 (字节) */
+#define DMA_PRINT_RTOS_MAX_PRODUCERS  4     /* 可注册独立缓冲区的任务数 */
+#define DMA_PRINT_RTOS_BLOCK_MS       20    /* 共用缓冲区满时最长阻塞时间，超时丢弃并计数 */
+#define DMA_PRINT_RTOS_PRIORITY       1     /* drainer 任务优先级 (低于所有要打日志的实时任务) */
+#define DMA_PRINT_RTOS_STACK          256   /* drainer 任务栈 (字) */
+#define DMA_PRINT_RTOS_TLS_INDEX      0     /* 线程本地存储下标，需要 configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 */
+
+#ifndef DMA_PRINT_NOINIT_ATTR
+#if defined(__CC_ARM) || defined(__ARMCC_VERSION)
+#define DMA_PRINT_NOINIT_ATTR     __attribute__((section(".bss.noinit")))
+#else
+#define DMA_PRINT_NOINIT_ATTR     __attribute__((section(".noinit")))
+#endif
+#endif
+
+#define DMA_PRINT_NOINIT_MAGIC    0x44504C47u   /* "DPLG" */
+
+#if DMA_PRINT_TELEMETRY && DMA_PRINT_COMPRESS
+#error "DMA_PRINT_TELEMETRY 与 DMA_PRINT_COMPRESS 不能同时开启：二进制帧会破坏压缩码流"
+#endif
+
+#if DMA_PRINT_RTOS && DMA_PRINT_COMPRESS
+#error "DMA_PRINT_RTOS 暂不支持 DMA_PRINT_COMPRESS：压缩器状态只能单线程访问"
+#endif
+#if DMA_PRINT_RTOS && DMA_PRINT_NOINIT
+#error "DMA_PRINT_RTOS 不使用环形缓冲区，DMA_PRINT_NOINIT 无效"
+#endif
+
+#if DMA_PRINT_COMPRESS
+#include "dma_lz.h"
+#endif
+
+#if DMA_PRINT_RTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "message_buffer.h"
+
+/**
+ * @brief 注册了独立缓冲区的生产者任务
+ */
+typedef struct {
+    MessageBufferHandle_t mb;
+    TaskHandle_t task;
+    UBaseType_t priority;             // 注册时的任务优先级，drainer 按此排序收取
+    TickType_t block_ticks;           // 缓冲区满时最长阻塞时间
+    volatile uint32_t dropped;        // 阻塞超时后丢弃的字节数
+    uint16_t size;                    // 缓冲区大小 (统计待发送量用)
+} DMA_Print_Producer_t;
+#endif
+
+#if defined(USE_DRV_STATS)
+/**
+ * @brief 运行统计 (需要全局定义 USE_DRV_STATS)
+ * @note  "缓冲区" 在普通模式下是环形缓冲区；RTOS 模式下是所有 MessageBuffer 的总和
+ *        (每条消息另占 4 字节长度)，待发送量由 drainer 每轮收集前采样
+ */
+typedef struct {
+    uint32_t bytes_in;        // 进入缓冲区的字节数 (压缩模式下是压缩后的字节；RTOS 模式下是 drainer 收走的字节)
+    uint32_t bytes_tx;        // DMA 发送完成的字节数
+    uint32_t dma_xfers;       // DMA 传输次数
+    uint32_t dropped;         // 缓冲区满丢弃的字节数 (RTOS 模式下 = rtos_dropped + 各生产者的 dropped)
+    uint32_t overflows;       // 发生丢弃的次数 (遥测帧整帧丢弃算一次)
+    uint16_t level;           // 快照时缓冲区中待发送的字节数
+    uint16_t level_max;       // 待发送字节数的峰值
+} DMA_Print_Stats_t;
+#endif
+
 /**
  * @brief 环形缓冲区管理结构体
  */
@@ -27,10 +173,41 @@ typedef struct {
     volatile uint16_t head;           // 写指针 (Head)
     volatile uint16_t tail;           // 读/DMA指针 (Tail)
     volatile uint8_t dma_is_busy;     // DMA 忙碌标志位
+    volatile uint16_t tx_len;         // 当前 DMA 传输的长度，完成后据此推进 Tail
+    volatile uint32_t last_push_tick; // 最后一次写入的时刻 (HAL_GetTick)，用于空闲超时
+#if DMA_PRINT_NOINIT
+    uint32_t noinit_magic;            // DMA_PRINT_NOINIT_MAGIC 表示 .noinit 内容有效
+    uint32_t noinit_check;            // head/tail 的校验字，复位时正在修改指针则校验失败
+    uint16_t noinit_recovered;        // 本次上电从上次运行保留下来的字节数
+#endif
+#if DMA_PRINT_COMPRESS
+    dma_lz_t lz;                      // 流式压缩器状态
+    uint8_t lz_ring_full;             // 压缩输出时环形缓冲区已满
+    volatile uint8_t lz_busy;         // 压缩器正在编码 (中断打断时不能再进)
+#endif
+#if DMA_PRINT_RTOS
+    TaskHandle_t drainer;             // 收集并发送日志的低优先级任务
+    MessageBufferHandle_t isr_mb;     // 中断共用 (临界区保护)
+    MessageBufferHandle_t shared_mb;  // 未注册任务共用 (互斥量保护)
+    SemaphoreHandle_t shared_lock;
+    DMA_Print_Producer_t producers[DMA_PRINT_RTOS_MAX_PRODUCERS]; // 注册顺序 (线程本地存储指向这里)
+    uint8_t producer_order[DMA_PRINT_RTOS_MAX_PRODUCERS];      // 按优先级从高到低的下标
+    volatile uint8_t n_producers;
+    volatile uint32_t rtos_dropped;   // 中断缓冲区满、共用缓冲区阻塞超时丢弃的字节数
+#endif
+#if defined(USE_DWT_TRACE)
+    volatile uint8_t trace_user;      // 上次启动 DMA 后写入过追踪帧以外的数据
+    uint8_t tx_traced;                // 当前传输记录了 BEGIN，完成时才记 END
+#endif
+#if defined(USE_DRV_STATS)
+    DMA_Print_Stats_t stats;          // 写入方和发送完成中断各改各的字段，不需要加锁
+#endif
 } DMA_Print_Handle_t;
 
 /**
  * @brief 初始化打印服务
+ * @note  开启 DMA_PRINT_NOINIT 时，如果上次运行还有没发完的数据，会保留下来最先发送，
+ *        数量记在 hprint->noinit_recovered 中
  * @param hprint 打印句柄指针
  * @param huart STM32 HAL UART 句柄指针
  */
@@ -44,6 +221,45 @@ void DMA_Printf_Init(DMA_Print_Handle_t *hprint, UART_HandleTypeDef *huart);
  */
 void DMA_Printf_Push(DMA_Print_Handle_t *hprint, uint8_t *data, uint16_t len);
 
+#if DMA_PRINT_USE_FAST_FMT
+/**
+ * @brief 格式化打印 (不经过 newlib 的 printf，没有中间缓冲区)
+ * @note  格式语法见 fast_fmt.h；比 printf 省掉 vfprintf 的栈和 Flash 占用
+ * @param hprint 打印句柄
+ * @param format 格式串
+ * @return 格式化输出的字符数 (缓冲区满时实际写入可能更少)
+ */
+int DMA_Printf(DMA_Print_Handle_t *hprint, const char *format, ...);
+#endif
+
+#if DMA_PRINT_TELEMETRY
+/**
+ * @brief 发送一帧二进制遥测数据 (COBS 分帧 + CRC32)
+ * @note  整帧一次性编码进环形缓冲区的预留空间，空间不够时整帧丢弃，不会发出半帧；
+ *        一帧只经过一次拷贝，比 "%04X" 打印十六进制少 2/3 以上的字节
+ * @param hprint 打印句柄
+ * @param type 帧类型，主机端据此区分不同的结构体
+ * @param data 负载 (一般是一个结构体)
+ * @param len 负载长度，不超过 DMA_TELEM_MAX_PAYLOAD
+ * @return 0: 成功; -1: 负载过长或缓冲区空间不足
+ */
+int DMA_Printf_Frame(DMA_Print_Handle_t *hprint, uint8_t type, const void *data, uint16_t len);
+#endif
+
+/**
+ * @brief 立即启动发送 (忽略写合并条件)
+ * @param hprint 打印句柄
+ */
+void DMA_Printf_Flush(DMA_Print_Handle_t *hprint);
+
+/**
+ * @brief 空闲超时检查，把攒着但没凑够阈值的数据发出去
+ * @note  开启 DMA_PRINT_COALESCE 时需要周期调用，放在主循环或低优先级任务中；
+ *        开启 DMA_PRINT_COMPRESS 时在中断里调用只会启动 DMA，不会冲刷压缩器 (半行留给线程里的下一次 Poll)
+ * @param hprint 打印句柄
+ */
+void DMA_Printf_Poll(DMA_Print_Handle_t *hprint);
+
 /**
  * @brief DMA 发送完成回调
  * @note 必须在 main.c 或 stm32xx_it.c 的 HAL_UART_TxCpltCallback 中调用此函数
@@ -51,6 +267,44 @@ void DMA_Printf_Push(DMA_Print_Handle_t *hprint, uint8_t *data, uint16_t len);
  */
 void DMA_Printf_TxCpltCallback(DMA_Print_Handle_t *hprint);
 
+#if DMA_PRINT_RTOS
+/**
+ * @brief 为当前任务创建独立的日志缓冲区 (在任务函数开头调用一次)
+ * @note  之后该任务的 printf / DMA_Printf / DMA_Printf_Push 都写进自己的缓冲区，
+ *        与其他任务互不影响；drainer 优先收取优先级高的任务
+ * @param hprint 打印句柄
+ * @param size 缓冲区大小 (字节)，按该任务最大突发量 + 每条消息 4 字节估算
+ * @param block_ms 缓冲区满时最长阻塞时间 (0 = 不等待，直接丢弃并计数)
+ * @return 0: 成功; -1: 名额已满或内存不足
+ */
+int DMA_Printf_RegisterTask(DMA_Print_Handle_t *hprint, uint16_t size, uint32_t block_ms);
+#endif
+
+#if defined(USE_DRV_STATS)
+/**
+ * @brief 读取统计快照 (level 在此刻计算)
+ * @param hprint 打印句柄
+ * @param out 输出
+ */
+void DMA_Printf_GetStats(DMA_Print_Handle_t *hprint, DMA_Print_Stats_t *out);
+
+/**
+ * @brief 清零统计 (RTOS 模式下同时清零 rtos_dropped 和各生产者的 dropped)
+ * @param hprint 打印句柄
+ */
+void DMA_Printf_ResetStats(DMA_Print_Handle_t *hprint);
+#endif
+
+#if DMA_PRINT_USE_LL
+/**
+ * @brief DMA 中断处理 (LL 后端)
+ * @note  在 stm32xx_it.c 的 DMAx_Streamy_IRQHandler / DMAx_Channely_IRQHandler 中
+ *        调用此函数代替 HAL_DMA_IRQHandler，此时不再需要 HAL_UART_TxCpltCallback
+ * @param hprint 打印句柄
+ */
+void DMA_Printf_DMA_IRQHandler(DMA_Print_Handle_t *hprint);
+#endif
+
 /* * 全局单例句柄声明 
  * 为了方便 printf 重定向，我们需要一个全局的默认实例
  */
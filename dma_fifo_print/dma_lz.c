@@ -0,0 +1,164 @@
+/**
+ * @file dma_lz.c
+ * @brief 流式 LZSS 压缩实现
+ * @note  贪心匹配 + 2 路哈希桶，每个输入字节最多比较 2 个候选位置，
+ *        对日志这类高重复文本通常有 2~4 倍压缩比
+ */
+
+#include "dma_lz.h"
+#include <string.h>
+
+/* ================= 位输出 ================= */
+
+static void lz_emit(dma_lz_t *lz, dma_lz_out_t out, void *ctx)
+{
+    if (lz->out_len) {
+        out(ctx, lz->out, lz->out_len);
+        lz->out_len = 0;
+    }
+}
+
+static void lz_put_bits(dma_lz_t *lz, uint32_t value, uint8_t n, dma_lz_out_t out, void *ctx)
+{
+    lz->bit_buf = (lz->bit_buf << n) | value;
+    lz->bit_cnt += n;
+
+    while (lz->bit_cnt >= 8) {
+        lz->bit_cnt -= 8;
+        lz->out[lz->out_len++] = (uint8_t)(lz->bit_buf >> lz->bit_cnt);
+        if (lz->out_len == sizeof(lz->out)) {
+            lz_emit(lz, out, ctx);
+        }
+    }
+    lz->bit_buf &= (1u << lz->bit_cnt) - 1u;
+}
+
+/* ================= 匹配查找 ================= */
+
+static inline uint8_t lz_at(const dma_lz_t *lz, uint16_t pos)
+{
+    return lz->window[pos & DMA_LZ_WINDOW_MASK];
+}
+
+static inline uint16_t lz_hash(const dma_lz_t *lz, uint16_t pos)
+{
+    uint32_t v = ((uint32_t)lz_at(lz, pos) << 16) |
+                 ((uint32_t)lz_at(lz, pos + 1) << 8) |
+                 lz_at(lz, pos + 2);
+    return (uint16_t)((v * 2654435761u) >> (32 - DMA_LZ_HASH_BITS));
+}
+
+static void lz_insert(dma_lz_t *lz, uint16_t pos)
+{
+    /* 需要 3 个已输入的字节才能算哈希 */
+    if ((uint16_t)(lz->in_pos - pos) < DMA_LZ_MIN_MATCH) {
+        return;
+    }
+
+    uint16_t *bucket = lz->hash[lz_hash(lz, pos)];
+    for (uint8_t w = DMA_LZ_HASH_WAYS - 1; w > 0; w--) {
+        bucket[w] = bucket[w - 1];
+    }
+    bucket[0] = pos;
+}
+
+/**
+ * @brief 编码 enc_pos 处的一个记号 (字面量或回指)
+ */
+static void lz_encode_one(dma_lz_t *lz, dma_lz_out_t out, void *ctx)
+{
+    uint16_t pos = lz->enc_pos;
+    uint16_t avail = (uint16_t)(lz->in_pos - pos);
+    uint16_t best_len = 0;
+    uint16_t best_dist = 0;
+
+    if (avail >= DMA_LZ_MIN_MATCH) {
+        /* 可引用的最远距离：不能超过已有历史，也不能碰到正在被新输入覆盖的槽位 */
+        uint16_t max_dist = DMA_LZ_WINDOW_SIZE - avail;
+        if (max_dist > lz->hist_len) max_dist = lz->hist_len;
+        if (max_dist > DMA_LZ_WINDOW_SIZE - 1) max_dist = DMA_LZ_WINDOW_SIZE - 1;
+
+        uint16_t limit = (avail < DMA_LZ_MAX_MATCH) ? avail : DMA_LZ_MAX_MATCH;
+        const uint16_t *bucket = lz->hash[lz_hash(lz, pos)];
+
+        for (uint8_t w = 0; w < DMA_LZ_HASH_WAYS; w++) {
+            uint16_t dist = (uint16_t)(pos - bucket[w]);
+            if (dist == 0 || dist > max_dist) continue;
+
+            /* 哈希可能碰撞或过期，逐字节比较为准；允许与待编码区重叠 (dist < len) */
+            uint16_t cand = bucket[w];
+            uint16_t len = 0;
+            while (len < limit && lz_at(lz, cand + len) == lz_at(lz, pos + len)) {
+                len++;
+            }
+            if (len > best_len) {
+                best_len = len;
+                best_dist = dist;
+                if (len == limit) break;
+            }
+        }
+    }
+
+    lz_insert(lz, pos);
+
+    if (best_len >= DMA_LZ_MIN_MATCH) {
+        lz_put_bits(lz, ((uint32_t)best_dist << DMA_LZ_LEN_BITS) | (best_len - DMA_LZ_MIN_MATCH),
+                    1 + DMA_LZ_WINDOW_BITS + DMA_LZ_LEN_BITS, out, ctx);
+        for (uint16_t i = 1; i < best_len; i++) {
+            lz_insert(lz, pos + i);
+        }
+    } else {
+        best_len = 1;
+        lz_put_bits(lz, 0x100u | lz_at(lz, pos), 9, out, ctx);
+    }
+
+    lz->enc_pos = pos + best_len;
+    lz->hist_len = (lz->hist_len + best_len > DMA_LZ_WINDOW_SIZE) ?
+                   DMA_LZ_WINDOW_SIZE : (uint16_t)(lz->hist_len + best_len);
+}
+
+/* ================= 对外接口 ================= */
+
+void dma_lz_init(dma_lz_t *lz, dma_lz_out_t out, void *ctx)
+{
+    memset(lz, 0, sizeof(dma_lz_t));
+
+    lz->out[0] = DMA_LZ_MAGIC0;
+    lz->out[1] = DMA_LZ_MAGIC1;
+    lz->out[2] = (DMA_LZ_WINDOW_BITS << 4) | DMA_LZ_LEN_BITS;
+    lz->out_len = 3;
+    lz_emit(lz, out, ctx);
+}
+
+void dma_lz_feed(dma_lz_t *lz, const uint8_t *data, uint16_t len, dma_lz_out_t out, void *ctx)
+{
+    for (uint16_t i = 0; i < len; i++) {
+        lz->window[lz->in_pos & DMA_LZ_WINDOW_MASK] = data[i];
+        lz->in_pos++;
+
+        /* 攒够一个最长匹配再编码，保证贪心匹配看得到完整的前瞻 */
+        if ((uint16_t)(lz->in_pos - lz->enc_pos) >= DMA_LZ_MAX_MATCH) {
+            lz_encode_one(lz, out, ctx);
+        }
+    }
+    lz_emit(lz, out, ctx);
+}
+
+void dma_lz_flush(dma_lz_t *lz, dma_lz_out_t out, void *ctx)
+{
+    while (lz->enc_pos != lz->in_pos) {
+        lz_encode_one(lz, out, ctx);
+    }
+
+    /* 同步点：距离 0，然后补齐到字节边界 */
+    lz_put_bits(lz, 0, 1 + DMA_LZ_WINDOW_BITS, out, ctx);
+    if (lz->bit_cnt) {
+        lz_put_bits(lz, 0, 8 - lz->bit_cnt, out, ctx);
+    }
+    lz_emit(lz, out, ctx);
+}
+
+uint8_t dma_lz_pending(const dma_lz_t *lz)
+{
+    return (lz->enc_pos != lz->in_pos) || (lz->bit_cnt != 0);
+}
@@ -0,0 +1,86 @@
+/**
+ * @file dma_lz.h
+ * @brief 小窗口流式 LZSS 压缩器 (heatshrink 风格)，用于压缩串口日志
+ * @note  与硬件无关，RAM 占用 = 窗口 + 哈希表，默认配置约 1.6KB
+ */
+
+#ifndef __DMA_LZ_H__
+#define __DMA_LZ_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* ================= 参数配置 (编码端和解码端必须一致，会写进流头) ================= */
+
+/* 历史窗口 2^9 = 512 字节：日志里重复的前缀、单位、关键字基本都在这个距离内 */
+#define DMA_LZ_WINDOW_BITS  9
+/* 匹配长度字段位数：4 位 -> 匹配长度 3~18 */
+#define DMA_LZ_LEN_BITS     4
+/* 哈希表：2^8 个桶，每桶记最近 2 个位置 */
+#define DMA_LZ_HASH_BITS    8
+#define DMA_LZ_HASH_WAYS    2
+
+#define DMA_LZ_WINDOW_SIZE  (1u << DMA_LZ_WINDOW_BITS)
+#define DMA_LZ_WINDOW_MASK  (DMA_LZ_WINDOW_SIZE - 1u)
+#define DMA_LZ_HASH_SIZE    (1u << DMA_LZ_HASH_BITS)
+#define DMA_LZ_MIN_MATCH    3u
+#define DMA_LZ_MAX_MATCH    (DMA_LZ_MIN_MATCH + (1u << DMA_LZ_LEN_BITS) - 1u)
+
+/* * 码流格式 (MSB first)：
+ *   流头:   'L' 'Z' (WINDOW_BITS << 4 | LEN_BITS)
+ *   字面量: 1 + 8 位原始字节
+ *   回指:   0 + 距离 (WINDOW_BITS 位，1 ~ 窗口-1) + (长度 - 3) (LEN_BITS 位)
+ *   同步点: 0 + 距离 0，随后补 0 对齐到字节边界 (每次 flush 产生一个，解码端可以立刻输出)
+ */
+#define DMA_LZ_MAGIC0       'L'
+#define DMA_LZ_MAGIC1       'Z'
+
+/**
+ * @brief 压缩结果输出回调
+ */
+typedef void (*dma_lz_out_t)(void *ctx, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief 压缩器状态 (可静态分配，不使用堆)
+ */
+typedef struct {
+    uint8_t  window[DMA_LZ_WINDOW_SIZE];                  // 历史 + 待编码数据 (环形)
+    uint16_t hash[DMA_LZ_HASH_SIZE][DMA_LZ_HASH_WAYS];    // 3 字节哈希 -> 最近出现的位置
+    uint16_t in_pos;        // 下一个输入字节写入的位置 (绝对位置，16 位回绕)
+    uint16_t enc_pos;       // 下一个待编码的位置
+    uint16_t hist_len;      // enc_pos 之前有效历史的长度 (上限为窗口大小)
+    uint32_t bit_buf;       // 尚未凑满一个字节的输出位
+    uint8_t  bit_cnt;
+    uint8_t  out[16];       // 小输出缓冲，攒一批再交给回调
+    uint8_t  out_len;
+} dma_lz_t;
+
+/**
+ * @brief 初始化压缩器，并输出 3 字节流头
+ */
+void dma_lz_init(dma_lz_t *lz, dma_lz_out_t out, void *ctx);
+
+/**
+ * @brief 输入原始数据 (只在攒够最大匹配长度时才编码，剩余部分留到下次或 flush)
+ */
+void dma_lz_feed(dma_lz_t *lz, const uint8_t *data, uint16_t len, dma_lz_out_t out, void *ctx);
+
+/**
+ * @brief 编码全部待处理数据并插入同步点，保证解码端能输出到当前为止的全部内容
+ * @note  历史窗口保留，后续数据仍可引用之前的内容
+ */
+void dma_lz_flush(dma_lz_t *lz, dma_lz_out_t out, void *ctx);
+
+/**
+ * @brief 是否有尚未输出的数据 (待编码字节或未对齐的位)
+ */
+uint8_t dma_lz_pending(const dma_lz_t *lz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DMA_LZ_H__ */
@@ -0,0 +1,25 @@
+/**
+ * @file FreeRTOS.h
+ * @brief 主机端替身：dma_fifo_print 的 RTOS 模式用到的类型与宏
+ * @note  任务、通知、互斥量和 MessageBuffer 由 tools/rtos_shim.c 用 POSIX 线程实现，
+ *        节拍直接取 1ms (pdMS_TO_TICKS 不换算)。
+ */
+
+#ifndef __HOST_FREERTOS_H__
+#define __HOST_FREERTOS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  pdTRUE
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define portMAX_DELAY           0xFFFFFFFFu
+#define portYIELD_FROM_ISR(x)   ((void)(x))
+
+#endif /* __HOST_FREERTOS_H__ */
@@ -0,0 +1,131 @@
+/**
+ * @file main.h
+ * @brief 主机端替身：按 STM32F4 的寄存器布局模拟一路 USART + DMA Stream
+ * @note  只提供 dma_fifo_print.c 用到的 HAL 与 CMSIS 接口。寄存器是普通变量，
+ *        由测试程序扮演硬件 (搬数据、置标志、调中断函数)；关中断只是记录 PRIMASK。
+ *        没有定义 CRC，遥测帧走软件 CRC。RTOS 模式用到的 FreeRTOS 头文件也在这里，
+ *        实现见 tools/rtos_shim.c。
+ */
+
+#ifndef __HOST_MAIN_H__
+#define __HOST_MAIN_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef enum { HAL_UNLOCKED = 0, HAL_LOCKED } HAL_LockTypeDef;
+
+/* ================= 内核 ================= */
+
+extern uint32_t host_primask;
+
+static inline uint32_t __get_PRIMASK(void) { return host_primask; }
+static inline void __set_PRIMASK(uint32_t v) { host_primask = v; }
+static inline void __disable_irq(void) { host_primask = 1; }
+static inline void __enable_irq(void) { host_primask = 0; }
+
+/* 当前是否在中断里：RTOS 压力测试由 rtos_shim.c 按线程区分任务和 "中断" */
+uint32_t __get_IPSR(void);
+
+uint32_t HAL_GetTick(void);
+
+/* ================= DMA Stream (F4) ================= */
+
+typedef struct {
+    __IO uint32_t CR, NDTR, PAR, M0AR, M1AR, FCR;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+    __IO uint32_t LISR, HISR, LIFCR, HIFCR;
+} DMA_TypeDef;
+
+#define DMA_SxCR_EN             (1u << 0)
+#define DMA_SxCR_DMEIE          (1u << 1)
+#define DMA_SxCR_TEIE           (1u << 2)
+#define DMA_SxCR_HTIE           (1u << 3)
+#define DMA_SxCR_TCIE           (1u << 4)
+#define DMA_SxCR_CIRC           (1u << 8)
+#define DMA_SxCR_DBM            (1u << 18)
+#define DMA_SxFCR_FEIE          (1u << 7)
+
+/* 流 0/4 的标志位，其余流按 StreamIndex 左移 */
+#define DMA_FLAG_FEIF0_4        0x01u
+#define DMA_FLAG_DMEIF0_4       0x04u
+#define DMA_FLAG_TEIF0_4        0x08u
+#define DMA_FLAG_HTIF0_4        0x10u
+#define DMA_FLAG_TCIF0_4        0x20u
+
+#define DMA_NORMAL              0x0u
+#define DMA_CIRCULAR            DMA_SxCR_CIRC
+
+typedef enum {
+    HAL_DMA_STATE_RESET = 0,
+    HAL_DMA_STATE_READY,
+    HAL_DMA_STATE_BUSY,
+    HAL_DMA_STATE_ABORT
+} HAL_DMA_StateTypeDef;
+
+typedef struct {
+    uint32_t Mode;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+    DMA_Stream_TypeDef *Instance;
+    DMA_InitTypeDef Init;
+    HAL_LockTypeDef Lock;
+    __IO HAL_DMA_StateTypeDef State;
+    void *Parent;
+    void (*XferCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+    void (*XferHalfCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+    void (*XferErrorCallback)(struct __DMA_HandleTypeDef *hdma);
+    void (*XferAbortCallback)(struct __DMA_HandleTypeDef *hdma);
+    __IO uint32_t ErrorCode;
+    uintptr_t StreamBaseAddress;    // 真机上是 uint32_t，主机上要装得下指针
+    uint32_t StreamIndex;
+} DMA_HandleTypeDef;
+
+/* ================= USART (F4) ================= */
+
+typedef struct {
+    __IO uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR;
+} USART_TypeDef;
+
+#define USART_SR_PE             (1u << 0)
+#define USART_SR_FE             (1u << 1)
+#define USART_SR_NE             (1u << 2)
+#define USART_SR_ORE            (1u << 3)
+#define USART_SR_RXNE           (1u << 5)
+#define USART_SR_TC             (1u << 6)
+#define USART_SR_TXE            (1u << 7)
+#define USART_CR1_RXNEIE        (1u << 5)
+#define USART_CR1_TCIE          (1u << 6)
+#define USART_CR1_TXEIE         (1u << 7)
+#define USART_CR1_PEIE          (1u << 8)
+#define USART_CR3_EIE           (1u << 0)
+#define USART_CR3_DMAT          (1u << 7)
+
+typedef enum {
+    HAL_UART_STATE_RESET = 0,
+    HAL_UART_STATE_READY,
+    HAL_UART_STATE_BUSY_TX
+} HAL_UART_StateTypeDef;
+
+typedef struct __UART_HandleTypeDef {
+    USART_TypeDef *Instance;
+    const uint8_t *pTxBuffPtr;
+    uint16_t TxXferSize;
+    __IO uint16_t TxXferCount;
+    DMA_HandleTypeDef *hdmatx;
+    HAL_LockTypeDef Lock;
+    __IO HAL_UART_StateTypeDef gState;
+    __IO uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+#endif /* __HOST_MAIN_H__ */
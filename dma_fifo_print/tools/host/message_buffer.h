@@ -0,0 +1,21 @@
+/**
+ * @file message_buffer.h
+ * @brief 主机端替身：MessageBuffer，每条消息前面带 4 字节长度 (与 FreeRTOS 的 32 位平台一致)
+ * @note  发送方缓冲区满时阻塞等待，整条放得下才写入；接收方取不下下一条时返回 0
+ */
+
+#ifndef __HOST_MESSAGE_BUFFER_H__
+#define __HOST_MESSAGE_BUFFER_H__
+
+#include "FreeRTOS.h"
+
+typedef struct rtos_shim_mb *MessageBufferHandle_t;
+
+MessageBufferHandle_t xMessageBufferCreate(size_t size);
+void vMessageBufferDelete(MessageBufferHandle_t mb);
+size_t xMessageBufferSend(MessageBufferHandle_t mb, const void *data, size_t len, TickType_t wait);
+size_t xMessageBufferSendFromISR(MessageBufferHandle_t mb, const void *data, size_t len, BaseType_t *woken);
+size_t xMessageBufferReceive(MessageBufferHandle_t mb, void *data, size_t cap, TickType_t wait);
+size_t xMessageBufferSpacesAvailable(MessageBufferHandle_t mb);
+
+#endif /* __HOST_MESSAGE_BUFFER_H__ */
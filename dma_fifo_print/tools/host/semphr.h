@@ -0,0 +1,17 @@
+/**
+ * @file semphr.h
+ * @brief 主机端替身：只有互斥量
+ */
+
+#ifndef __HOST_SEMPHR_H__
+#define __HOST_SEMPHR_H__
+
+#include "FreeRTOS.h"
+
+typedef struct rtos_shim_mutex *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+
+#endif /* __HOST_SEMPHR_H__ */
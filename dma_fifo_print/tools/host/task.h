@@ -0,0 +1,45 @@
+/**
+ * @file task.h
+ * @brief 主机端替身：每个任务是一个线程，通知和临界区由 tools/rtos_shim.c 实现
+ * @note  临界区是一把递归锁，任务和 "中断" 线程 (rtos_shim_set_isr) 都要拿它，
+ *        等效于真机上关中断：临界区里不会被中断打断。线程真正并行，不按优先级调度，
+ *        优先级只影响 drainer 的收取顺序。
+ */
+
+#ifndef __HOST_TASK_H__
+#define __HOST_TASK_H__
+
+#include "FreeRTOS.h"
+
+typedef struct rtos_shim_task *TaskHandle_t;
+
+typedef enum { eNoAction = 0, eSetBits, eIncrement, eSetValueWithOverwrite } eNotifyAction;
+
+#define taskSCHEDULER_NOT_STARTED   1
+#define taskSCHEDULER_RUNNING       2
+
+BaseType_t xTaskCreate(void (*fn)(void *), const char *name, uint16_t stack, void *arg, UBaseType_t prio,
+                       TaskHandle_t *out);
+BaseType_t xTaskGetSchedulerState(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+void *pvTaskGetThreadLocalStoragePointer(TaskHandle_t task, BaseType_t index);
+void vTaskSetThreadLocalStoragePointer(TaskHandle_t task, BaseType_t index, void *value);
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *woken);
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t wait);
+
+void rtos_shim_enter_critical(void);
+void rtos_shim_exit_critical(void);
+
+#define taskENTER_CRITICAL()            rtos_shim_enter_critical()
+#define taskEXIT_CRITICAL()             rtos_shim_exit_critical()
+#define taskENTER_CRITICAL_FROM_ISR()   (rtos_shim_enter_critical(), 0u)
+#define taskEXIT_CRITICAL_FROM_ISR(x)   ((void)(x), rtos_shim_exit_critical())
+
+/* 以下不是 FreeRTOS 接口：启动调度器 (不阻塞，任务线程开始运行) 与标记当前线程为中断上下文 */
+void rtos_shim_start(void);
+void rtos_shim_set_isr(int in_isr);
+
+#endif /* __HOST_TASK_H__ */
@@ -0,0 +1,404 @@
+/**
+ * @file ll_bench.c
+ * @brief 主机端工具：在模拟的 F4 USART + DMA Stream 寄存器上，测每次 DMA 传输的 CPU 开销 (HAL 与 LL 后端)
+ * @note  纯 C99，直接链接 MCU 端的 dma_fifo_print.c，HAL 换成 host/ 下的寄存器替身。用法:
+ *          gcc -O2 -Ihost -I.. -Wno-pointer-to-int-cast -DDMA_PRINT_USE_LL=0 -o ll_bench_hal ll_bench.c ../dma_fifo_print.c
+ *          gcc -O2 -Ihost -I.. -Wno-pointer-to-int-cast -DDMA_PRINT_USE_LL=1 -o ll_bench_ll  ll_bench.c ../dma_fifo_print.c
+ *          ./ll_bench_hal [传输次数]; ./ll_bench_ll [传输次数]
+ *        HAL 后端用的是 F4 HAL 里 HAL_UART_Transmit_DMA / HAL_DMA_Start_IT / HAL_DMA_IRQHandler /
+ *        HAL_UART_IRQHandler 的精简模型 (锁、状态机、回调指针、寄存器读写的顺序与原版一致，去掉了用不到的分支)。
+ *        测试程序扮演硬件：按 NDTR/M0AR 把数据"发"出去并逐字节核对，再依次置半传输、传输完成、USART TC 标志并调用中断函数。
+ *        每次传输 = Push 一行 (20 字节，带换行) + 全部中断，两种后端的硬件模拟开销相同。
+ *        主机上的绝对耗时只能参考，主要看两者的比例和每次传输进了几次中断。
+ */
+
+#define _POSIX_C_SOURCE 199309L   /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dma_fifo_print.h"
+
+/* ================= 模拟硬件 ================= */
+
+uint32_t host_primask;
+
+uint32_t HAL_GetTick(void) { return 0; }
+
+static DMA_TypeDef sim_dma2;
+static DMA_Stream_TypeDef sim_stream7;      // USART1_TX: DMA2 Stream7 Channel4
+static USART_TypeDef sim_usart1;
+
+/* StreamIndex 与 HAL 的换算表一致：流 4~7 用 HISR/HIFCR，流 7 的标志从第 22 位开始 */
+static DMA_HandleTypeDef hdma_usart1_tx = {
+    .Instance = &sim_stream7,
+    .Init = { DMA_NORMAL },
+    .State = HAL_DMA_STATE_READY,
+    .StreamIndex = 22,
+};
+static UART_HandleTypeDef huart1 = {
+    .Instance = &sim_usart1,
+    .hdmatx = &hdma_usart1_tx,
+    .gState = HAL_UART_STATE_READY,
+};
+
+static long n_irq;
+
+/* ================= F4 HAL 的精简模型 ================= */
+
+#define __HAL_LOCK(h)       do { if ((h)->Lock == HAL_LOCKED) return HAL_BUSY; (h)->Lock = HAL_LOCKED; } while (0)
+#define __HAL_UNLOCK(h)     ((h)->Lock = HAL_UNLOCKED)
+
+typedef struct {
+    __IO uint32_t ISR;
+    __IO uint32_t Reserved0;
+    __IO uint32_t IFCR;
+} DMA_Base_Registers;
+
+static HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t len)
+{
+    DMA_Base_Registers *regs = (DMA_Base_Registers *)hdma->StreamBaseAddress;
+    HAL_StatusTypeDef status = HAL_OK;
+
+    __HAL_LOCK(hdma);
+    if (hdma->State == HAL_DMA_STATE_READY) {
+        hdma->State = HAL_DMA_STATE_BUSY;
+        hdma->ErrorCode = 0;
+        /* DMA_SetConfig (存储器到外设) */
+        hdma->Instance->CR &= ~DMA_SxCR_DBM;
+        hdma->Instance->NDTR = len;
+        hdma->Instance->PAR = dst;
+        hdma->Instance->M0AR = src;
+
+        regs->IFCR = 0x3FU << hdma->StreamIndex;
+        hdma->Instance->CR |= DMA_SxCR_TCIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE;
+        if (hdma->XferHalfCpltCallback != NULL) {
+            hdma->Instance->CR |= DMA_SxCR_HTIE;
+        }
+        hdma->Instance->CR |= DMA_SxCR_EN;
+    } else {
+        __HAL_UNLOCK(hdma);
+        status = HAL_BUSY;
+    }
+    return status;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    DMA_Base_Registers *regs = (DMA_Base_Registers *)hdma->StreamBaseAddress;
+    uint32_t tmpisr = regs->ISR;
+
+    if ((tmpisr & (DMA_FLAG_TEIF0_4 << hdma->StreamIndex)) && (hdma->Instance->CR & DMA_SxCR_TEIE)) {
+        hdma->Instance->CR &= ~DMA_SxCR_TEIE;
+        regs->IFCR = DMA_FLAG_TEIF0_4 << hdma->StreamIndex;
+        hdma->ErrorCode |= 1u;
+    }
+    if ((tmpisr & (DMA_FLAG_FEIF0_4 << hdma->StreamIndex)) && (hdma->Instance->FCR & DMA_SxFCR_FEIE)) {
+        regs->IFCR = DMA_FLAG_FEIF0_4 << hdma->StreamIndex;
+        hdma->ErrorCode |= 2u;
+    }
+    if ((tmpisr & (DMA_FLAG_DMEIF0_4 << hdma->StreamIndex)) && (hdma->Instance->CR & DMA_SxCR_DMEIE)) {
+        regs->IFCR = DMA_FLAG_DMEIF0_4 << hdma->StreamIndex;
+        hdma->ErrorCode |= 4u;
+    }
+    if ((tmpisr & (DMA_FLAG_HTIF0_4 << hdma->StreamIndex)) && (hdma->Instance->CR & DMA_SxCR_HTIE)) {
+        regs->IFCR = DMA_FLAG_HTIF0_4 << hdma->StreamIndex;
+        if ((hdma->Instance->CR & DMA_SxCR_CIRC) == 0) {
+            hdma->Instance->CR &= ~DMA_SxCR_HTIE;
+        }
+        if (hdma->XferHalfCpltCallback != NULL) {
+            hdma->XferHalfCpltCallback(hdma);
+        }
+    }
+    if ((tmpisr & (DMA_FLAG_TCIF0_4 << hdma->StreamIndex)) && (hdma->Instance->CR & DMA_SxCR_TCIE)) {
+        regs->IFCR = DMA_FLAG_TCIF0_4 << hdma->StreamIndex;
+        if ((hdma->Instance->CR & DMA_SxCR_CIRC) == 0) {
+            hdma->Instance->CR &= ~DMA_SxCR_TCIE;
+            hdma->State = HAL_DMA_STATE_READY;
+            __HAL_UNLOCK(hdma);
+        }
+        if (hdma->XferCpltCallback != NULL) {
+            hdma->XferCpltCallback(hdma);
+        }
+    }
+    if (hdma->ErrorCode != 0 && hdma->XferErrorCallback != NULL) {
+        hdma->XferErrorCallback(hdma);
+    }
+}
+
+void HAL_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart) { (void)huart; }
+
+/* 用户代码：本库要求在 TX 完成回调里调用 DMA_Printf_TxCpltCallback */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == g_dma_print_handle.huart) {
+        DMA_Printf_TxCpltCallback(&g_dma_print_handle);
+    }
+}
+
+static void UART_DMATransmitCplt(DMA_HandleTypeDef *hdma)
+{
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+
+    if ((hdma->Instance->CR & DMA_SxCR_CIRC) == 0) {
+        huart->TxXferCount = 0;
+        huart->Instance->CR3 &= ~USART_CR3_DMAT;
+        huart->Instance->CR1 |= USART_CR1_TCIE;     // 等最后一个字节移出移位寄存器
+    } else {
+        HAL_UART_TxCpltCallback(huart);
+    }
+}
+
+static void UART_DMATxHalfCplt(DMA_HandleTypeDef *hdma)
+{
+    HAL_UART_TxHalfCpltCallback((UART_HandleTypeDef *)hdma->Parent);
+}
+
+static void UART_DMAError(DMA_HandleTypeDef *hdma)
+{
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+    huart->ErrorCode |= 0x10u;
+    huart->gState = HAL_UART_STATE_READY;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pData == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+    __HAL_LOCK(huart);
+    huart->pTxBuffPtr = pData;
+    huart->TxXferSize = Size;
+    huart->TxXferCount = Size;
+    huart->ErrorCode = 0;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+
+    huart->hdmatx->XferCpltCallback = UART_DMATransmitCplt;
+    huart->hdmatx->XferHalfCpltCallback = UART_DMATxHalfCplt;
+    huart->hdmatx->XferErrorCallback = UART_DMAError;
+    huart->hdmatx->XferAbortCallback = NULL;
+    HAL_DMA_Start_IT(huart->hdmatx, (uint32_t)(uintptr_t)pData, (uint32_t)(uintptr_t)&huart->Instance->DR, Size);
+
+    huart->Instance->SR = ~USART_SR_TC;             // rc_w0：写 0 清 TC
+    __HAL_UNLOCK(huart);
+    huart->Instance->CR3 |= USART_CR3_DMAT;
+    return HAL_OK;
+}
+
+static void UART_EndTransmit_IT(UART_HandleTypeDef *huart)
+{
+    huart->Instance->CR1 &= ~USART_CR1_TCIE;
+    huart->gState = HAL_UART_STATE_READY;
+    HAL_UART_TxCpltCallback(huart);
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
+{
+    uint32_t isrflags = huart->Instance->SR;
+    uint32_t cr1its = huart->Instance->CR1;
+    uint32_t cr3its = huart->Instance->CR3;
+    uint32_t errorflags = isrflags & (USART_SR_PE | USART_SR_FE | USART_SR_ORE | USART_SR_NE);
+
+    if (errorflags == 0 && (isrflags & USART_SR_RXNE) && (cr1its & USART_CR1_RXNEIE)) {
+        return;                                     // 接收路径，本工具不用
+    }
+    if (errorflags != 0 && ((cr3its & USART_CR3_EIE) || (cr1its & (USART_CR1_RXNEIE | USART_CR1_PEIE)))) {
+        huart->ErrorCode |= errorflags;
+    }
+    if ((isrflags & USART_SR_TXE) && (cr1its & USART_CR1_TXEIE)) {
+        return;                                     // 中断发送路径，本工具不用
+    }
+    if ((isrflags & USART_SR_TC) && (cr1its & USART_CR1_TCIE)) {
+        UART_EndTransmit_IT(huart);
+    }
+}
+
+/* ================= 硬件行为 ================= */
+
+#define EXPECT_SIZE 4096u
+
+static uint8_t expect_buf[EXPECT_SIZE];     // 已 Push、还没在线路上出现的字节
+static uint32_t expect_head, expect_tail;
+static long n_xfer, n_bytes, n_bad;
+static int verify = 1;                      // 计时时关掉逐字节核对
+
+static void expect_push(const uint8_t *p, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++) {
+        expect_buf[expect_head++ % EXPECT_SIZE] = p[i];
+    }
+}
+
+/* IFCR 写 1 清 ISR 对应位 (替身里 IFCR 是普通变量，只保留最后一次写入) */
+static void hw_ifcr(void)
+{
+    sim_dma2.HISR &= ~sim_dma2.HIFCR;
+    sim_dma2.HIFCR = 0;
+}
+
+static void hw_dma_irq(void)
+{
+    n_irq++;
+#if DMA_PRINT_USE_LL
+    DMA_Printf_DMA_IRQHandler(&g_dma_print_handle);
+#else
+    HAL_DMA_IRQHandler(&hdma_usart1_tx);
+#endif
+    hw_ifcr();
+}
+
+/**
+ * @brief 把当前 DMA 传输的数据"发"出去并核对，然后依次产生 HT、TC、USART TC
+ */
+static void hw_finish(void)
+{
+    const uint32_t idx = hdma_usart1_tx.StreamIndex;
+    const uint8_t *ring = g_dma_print_handle.buffer;
+
+    hw_ifcr();
+    if (!(sim_stream7.CR & DMA_SxCR_EN)) {
+        return;
+    }
+
+    // 主机指针是 64 位，寄存器只存了低 32 位：换算回环形缓冲区里的偏移
+    uint32_t off = sim_stream7.M0AR - (uint32_t)(uintptr_t)ring;
+    uint32_t len = sim_stream7.NDTR;
+    if (off + len > TX_RING_BUFFER_SIZE || len == 0 ||
+        sim_stream7.PAR != (uint32_t)(uintptr_t)&sim_usart1.DR || !(sim_usart1.CR3 & USART_CR3_DMAT)) {
+        n_bad++;
+    }
+    for (uint32_t i = 0; verify && i < len && off + i < TX_RING_BUFFER_SIZE; i++) {
+        if (expect_tail == expect_head || ring[off + i] != expect_buf[expect_tail++ % EXPECT_SIZE]) {
+            n_bad++;
+        }
+    }
+    n_xfer++;
+    n_bytes += len;
+
+    sim_usart1.SR &= USART_SR_TC | USART_SR_TXE;    // 替身里 SR 会被写成 ~TC，只保留真实存在的位
+
+    sim_dma2.HISR |= DMA_FLAG_HTIF0_4 << idx;
+    if (sim_stream7.CR & DMA_SxCR_HTIE) {
+        hw_dma_irq();
+    }
+
+    sim_stream7.CR &= ~DMA_SxCR_EN;                 // Normal 模式：传完自动关流
+    sim_stream7.NDTR = 0;
+    sim_dma2.HISR |= DMA_FLAG_TCIF0_4 << idx;
+    if (sim_stream7.CR & DMA_SxCR_TCIE) {
+        hw_dma_irq();
+    }
+
+    sim_usart1.SR |= USART_SR_TC | USART_SR_TXE;
+    if (sim_usart1.CR1 & USART_CR1_TCIE) {
+        n_irq++;
+        HAL_UART_IRQHandler(&huart1);
+    }
+}
+
+static void sim_reset(void)
+{
+    memset(&sim_dma2, 0, sizeof(sim_dma2));
+    memset(&sim_stream7, 0, sizeof(sim_stream7));
+    memset(&sim_usart1, 0, sizeof(sim_usart1));
+    sim_usart1.SR = USART_SR_TC | USART_SR_TXE;
+    hdma_usart1_tx.StreamBaseAddress = (uintptr_t)&sim_dma2 + 4u;   // HISR
+    hdma_usart1_tx.Parent = &huart1;
+    DMA_Printf_Init(&g_dma_print_handle, &huart1);
+}
+
+/* ================= 用例 ================= */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void push_line(long k)
+{
+    char line[24];
+    int len = snprintf(line, sizeof(line), "line %08ld abcde\n", k % 100000000L);
+    expect_push((const uint8_t *)line, (uint16_t)len);
+    DMA_Printf_Push(&g_dma_print_handle, (uint8_t *)line, (uint16_t)len);
+}
+
+/**
+ * @brief 忙的时候连续写几行，核对合并发送和环形缓冲区回绕
+ */
+static int test_backlog(void)
+{
+    sim_reset();
+    n_xfer = n_bytes = n_bad = 0;
+    expect_head = expect_tail = 0;
+
+    for (long k = 0; k < 5000; k++) {
+        push_line(k);
+        if (k % 7 == 6) {
+            hw_finish();
+        }
+    }
+    while (sim_stream7.CR & DMA_SxCR_EN) {
+        hw_finish();
+    }
+    int bad = n_bad || expect_head != expect_tail;
+    printf("%-26s %s (%ld transfers, %ld bytes, %ld mismatches, %u bytes unsent)\n", "backlog + wrap",
+           bad ? "FAIL" : "ok", n_xfer, n_bytes, n_bad, (unsigned)(expect_head - expect_tail));
+    return bad;
+}
+
+/**
+ * @brief 每行单独一次传输：先核对一遍，再关掉核对计时 (行内容预先生成，不算格式化)
+ */
+static int bench(long n)
+{
+    static char lines[64][24];
+    static uint16_t lens[64];
+
+    sim_reset();
+    n_xfer = n_bytes = n_bad = 0;
+    expect_head = expect_tail = 0;
+    for (long k = 0; k < 5000; k++) {
+        push_line(k);
+        while (sim_stream7.CR & DMA_SxCR_EN) {
+            hw_finish();
+        }
+    }
+    int bad = n_bad || expect_head != expect_tail;
+    printf("%-26s %s (%ld transfers, %ld mismatches)\n", "one line per transfer", bad ? "FAIL" : "ok", n_xfer, n_bad);
+
+    for (int i = 0; i < 64; i++) {
+        lens[i] = (uint16_t)snprintf(lines[i], sizeof(lines[i]), "line %08d abcde\n", i);
+    }
+    verify = 0;
+    n_xfer = n_irq = 0;
+    double t0 = now_ns();
+    for (long k = 0; k < n; k++) {
+        DMA_Printf_Push(&g_dma_print_handle, (uint8_t *)lines[k & 63], lens[k & 63]);
+        while (sim_stream7.CR & DMA_SxCR_EN) {
+            hw_finish();
+        }
+    }
+    double t1 = now_ns();
+    verify = 1;
+
+    printf("per transfer: %.1f ns, %.2f interrupts (Push + completion, %d-byte lines)\n",
+           (t1 - t0) / n_xfer, (double)n_irq / n_xfer, lens[0]);
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    long n = argc > 1 ? atol(argv[1]) : 1000000L;
+    int bad = 0;
+
+    printf("dma_fifo_print %s backend, %d-byte ring\n", DMA_PRINT_USE_LL ? "LL" : "HAL", TX_RING_BUFFER_SIZE);
+    bad |= test_backlog();
+    bad |= bench(n);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file lz_decode.c
+ * @brief 主机端流式解压工具：把 DMA_PRINT_COMPRESS 输出的码流还原成文本
+ * @note  纯 C99，无第三方依赖。用法:
+ *          gcc -O2 -o lz_decode lz_decode.c
+ *          stty -F /dev/ttyUSB0 921600 raw && ./lz_decode < /dev/ttyUSB0
+ *        每遇到一个同步点就 fflush 一次，串口实时查看没有延迟。
+ *        码流格式见 dma_lz.h。
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LZ_MIN_MATCH 3u
+
+typedef struct {
+    FILE *in;
+    uint32_t bit_buf;
+    uint8_t bit_cnt;
+    int eof;
+} bit_reader_t;
+
+static uint32_t read_bits(bit_reader_t *br, uint8_t n)
+{
+    while (br->bit_cnt < n) {
+        int c = fgetc(br->in);
+        if (c == EOF) {
+            br->eof = 1;
+            return 0;
+        }
+        br->bit_buf = (br->bit_buf << 8) | (uint8_t)c;
+        br->bit_cnt += 8;
+    }
+    br->bit_cnt -= n;
+    uint32_t v = (br->bit_buf >> br->bit_cnt) & ((1u << n) - 1u);
+    br->bit_buf &= (1u << br->bit_cnt) - 1u;
+    return v;
+}
+
+/**
+ * @brief 在输入中寻找流头 'L' 'Z' 参数，返回参数字节，EOF 返回 -1
+ */
+static int find_header(FILE *in)
+{
+    int prev = -1, c;
+    while ((c = fgetc(in)) != EOF) {
+        if (prev == 'L' && c == 'Z') {
+            return fgetc(in);
+        }
+        prev = c;
+    }
+    return -1;
+}
+
+int main(void)
+{
+    static uint8_t window[1u << 15];
+    bit_reader_t br;
+
+    memset(&br, 0, sizeof(br));
+    br.in = stdin;
+
+    for (;;) {
+        int param = find_header(stdin);
+        if (param < 0) break;
+
+        uint8_t wbits = (uint8_t)(param >> 4);
+        uint8_t lbits = (uint8_t)(param & 0x0F);
+        if (wbits < 4 || wbits > 15 || lbits == 0 || lbits > 8) {
+            fprintf(stderr, "lz_decode: bad header 0x%02x, resyncing\n", param);
+            continue;
+        }
+
+        uint32_t mask = (1u << wbits) - 1u;
+        uint32_t produced = 0;
+        br.bit_buf = 0;
+        br.bit_cnt = 0;
+
+        for (;;) {
+            uint32_t flag = read_bits(&br, 1);
+            if (br.eof) break;
+
+            if (flag) {
+                uint8_t c = (uint8_t)read_bits(&br, 8);
+                if (br.eof) break;
+                window[produced++ & mask] = c;
+                putchar(c);
+                continue;
+            }
+
+            uint32_t dist = read_bits(&br, wbits);
+            if (br.eof) break;
+
+            if (dist == 0) {
+                /* 同步点：丢弃剩余的填充位，把已解出的内容推给终端 */
+                br.bit_cnt = 0;
+                br.bit_buf = 0;
+                fflush(stdout);
+                continue;
+            }
+
+            uint32_t len = read_bits(&br, lbits) + LZ_MIN_MATCH;
+            if (br.eof) break;
+
+            if (dist > produced) {
+                /* 从码流中间开始接收 (设备没复位) 或者丢了字节：重新找流头 */
+                fprintf(stderr, "\nlz_decode: invalid back-reference, resyncing\n");
+                break;
+            }
+
+            for (uint32_t i = 0; i < len; i++) {
+                uint8_t c = window[(produced - dist) & mask];
+                window[produced++ & mask] = c;
+                putchar(c);
+            }
+        }
+
+        fflush(stdout);
+        if (br.eof) break;
+    }
+
+    return 0;
+}
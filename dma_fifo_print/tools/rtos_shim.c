@@ -0,0 +1,363 @@
+/**
+ * @file rtos_shim.c
+ * @brief 主机端替身：用 POSIX 线程实现 dma_fifo_print RTOS 模式用到的 FreeRTOS 接口
+ * @note  C99 + POSIX 线程，和 rtos_stress.c 一起编译 (用法见那里)。
+ *        每个任务一个线程；通知、互斥量和 MessageBuffer 共用一把内核锁和一个条件变量，
+ *        每次操作都是原子的，阻塞等待用 pthread_cond_timedwait (1 节拍 = 1ms)。
+ *        临界区是另一把递归锁，被标记为中断的线程进 "中断临界区" 时也拿它。
+ *        线程真正并行运行，没有优先级抢占，比单核调度更容易暴露漏加锁的地方。
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "message_buffer.h"
+
+#define SHIM_TLS_MAX    4
+
+struct rtos_shim_task {
+    pthread_t thread;
+    void (*fn)(void *);
+    void *arg;
+    UBaseType_t prio;
+    uint32_t value;             // 通知值
+    uint8_t pending;            // 有没取走的通知
+    void *tls[SHIM_TLS_MAX];
+};
+
+struct rtos_shim_mutex {
+    uint8_t taken;
+};
+
+struct rtos_shim_mb {
+    uint8_t *buf;
+    size_t size, head, count;
+};
+
+static pthread_mutex_t kernel_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t kernel_cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t crit_lock;
+static pthread_once_t crit_once = PTHREAD_ONCE_INIT;
+static int sched_running;
+
+static __thread struct rtos_shim_task *cur_task;
+static __thread int cur_isr;
+
+/* ================= 内部 ================= */
+
+static void crit_init(void)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&crit_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+static void deadline_after(struct timespec *ts, TickType_t wait)
+{
+    clock_gettime(CLOCK_REALTIME, ts);
+    if (wait == portMAX_DELAY) return;
+    ts->tv_sec += wait / 1000u;
+    ts->tv_nsec += (long)(wait % 1000u) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * @brief 持有内核锁时等一次状态变化
+ * @return 0: 已到期 (wait == 0 时立刻到期)
+ */
+static int kernel_wait(TickType_t wait, const struct timespec *deadline)
+{
+    if (wait == 0) return 0;
+    if (wait == portMAX_DELAY) {
+        pthread_cond_wait(&kernel_cond, &kernel_lock);
+        return 1;
+    }
+    return pthread_cond_timedwait(&kernel_cond, &kernel_lock, deadline) != ETIMEDOUT;
+}
+
+static void *task_entry(void *arg)
+{
+    struct rtos_shim_task *t = (struct rtos_shim_task *)arg;
+
+    cur_task = t;
+    pthread_mutex_lock(&kernel_lock);
+    while (!sched_running) {
+        pthread_cond_wait(&kernel_cond, &kernel_lock);
+    }
+    pthread_mutex_unlock(&kernel_lock);
+    t->fn(t->arg);
+    return NULL;
+}
+
+/* ================= 任务与调度器 ================= */
+
+BaseType_t xTaskCreate(void (*fn)(void *), const char *name, uint16_t stack, void *arg, UBaseType_t prio,
+                       TaskHandle_t *out)
+{
+    (void)name;
+    (void)stack;
+    pthread_once(&crit_once, crit_init);
+
+    struct rtos_shim_task *t = (struct rtos_shim_task *)calloc(1, sizeof(*t));
+    if (t == NULL) return pdFALSE;
+    t->fn = fn;
+    t->arg = arg;
+    t->prio = prio;
+    if (out != NULL) *out = t;
+    if (pthread_create(&t->thread, NULL, task_entry, t) != 0) return pdFALSE;
+    pthread_detach(t->thread);
+    return pdPASS;
+}
+
+void rtos_shim_start(void)
+{
+    pthread_once(&crit_once, crit_init);
+    pthread_mutex_lock(&kernel_lock);
+    sched_running = 1;
+    pthread_cond_broadcast(&kernel_cond);
+    pthread_mutex_unlock(&kernel_lock);
+}
+
+void rtos_shim_set_isr(int in_isr)
+{
+    cur_isr = in_isr;
+}
+
+uint32_t __get_IPSR(void)
+{
+    return cur_isr ? 16u + 37u : 0u;    // 随便一个外设中断号 (USART1)
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+    pthread_mutex_lock(&kernel_lock);
+    BaseType_t state = sched_running ? taskSCHEDULER_RUNNING : taskSCHEDULER_NOT_STARTED;
+    pthread_mutex_unlock(&kernel_lock);
+    return state;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return cur_task;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+    return (task != NULL ? task : cur_task)->prio;
+}
+
+void *pvTaskGetThreadLocalStoragePointer(TaskHandle_t task, BaseType_t index)
+{
+    task = (task != NULL) ? task : cur_task;
+    return (task != NULL && index < SHIM_TLS_MAX) ? task->tls[index] : NULL;
+}
+
+void vTaskSetThreadLocalStoragePointer(TaskHandle_t task, BaseType_t index, void *value)
+{
+    task = (task != NULL) ? task : cur_task;
+    if (task != NULL && index < SHIM_TLS_MAX) task->tls[index] = value;
+}
+
+/* ================= 通知 ================= */
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    pthread_mutex_lock(&kernel_lock);
+    switch (action) {
+    case eSetBits:               task->value |= value; break;
+    case eIncrement:             task->value++; break;
+    case eSetValueWithOverwrite: task->value = value; break;
+    default: break;
+    }
+    task->pending = 1;
+    pthread_cond_broadcast(&kernel_cond);
+    pthread_mutex_unlock(&kernel_lock);
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *woken)
+{
+    if (woken != NULL) *woken = pdFALSE;
+    return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t wait)
+{
+    struct rtos_shim_task *t = cur_task;
+    struct timespec deadline;
+    BaseType_t got;
+
+    deadline_after(&deadline, wait);
+    pthread_mutex_lock(&kernel_lock);
+    if (!t->pending) {
+        t->value &= ~clear_on_entry;
+        while (!t->pending && kernel_wait(wait, &deadline)) {
+        }
+    }
+    got = t->pending ? pdTRUE : pdFALSE;
+    if (value != NULL) *value = t->value;
+    if (got) {
+        t->value &= ~clear_on_exit;
+        t->pending = 0;
+    }
+    pthread_mutex_unlock(&kernel_lock);
+    return got;
+}
+
+/* ================= 临界区 ================= */
+
+void rtos_shim_enter_critical(void)
+{
+    pthread_mutex_lock(&crit_lock);
+}
+
+void rtos_shim_exit_critical(void)
+{
+    pthread_mutex_unlock(&crit_lock);
+}
+
+/* ================= 互斥量 ================= */
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return (SemaphoreHandle_t)calloc(1, sizeof(struct rtos_shim_mutex));
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait)
+{
+    struct timespec deadline;
+    BaseType_t got;
+
+    deadline_after(&deadline, wait);
+    pthread_mutex_lock(&kernel_lock);
+    while (sem->taken && kernel_wait(wait, &deadline)) {
+    }
+    got = sem->taken ? pdFALSE : pdTRUE;
+    if (got) sem->taken = 1;
+    pthread_mutex_unlock(&kernel_lock);
+    return got;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&kernel_lock);
+    sem->taken = 0;
+    pthread_cond_broadcast(&kernel_cond);
+    pthread_mutex_unlock(&kernel_lock);
+    return pdTRUE;
+}
+
+/* ================= MessageBuffer ================= */
+
+static void mb_put(struct rtos_shim_mb *mb, const void *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        mb->buf[(mb->head + mb->count) % mb->size] = ((const uint8_t *)data)[i];
+        mb->count++;
+    }
+}
+
+static void mb_peek(const struct rtos_shim_mb *mb, void *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        ((uint8_t *)data)[i] = mb->buf[(mb->head + i) % mb->size];
+    }
+}
+
+static void mb_get(struct rtos_shim_mb *mb, void *data, size_t len)
+{
+    mb_peek(mb, data, len);
+    mb->head = (mb->head + len) % mb->size;
+    mb->count -= len;
+}
+
+MessageBufferHandle_t xMessageBufferCreate(size_t size)
+{
+    struct rtos_shim_mb *mb = (struct rtos_shim_mb *)calloc(1, sizeof(*mb));
+    if (mb == NULL) return NULL;
+    mb->buf = (uint8_t *)malloc(size);
+    if (mb->buf == NULL) {
+        free(mb);
+        return NULL;
+    }
+    mb->size = size;
+    return mb;
+}
+
+void vMessageBufferDelete(MessageBufferHandle_t mb)
+{
+    free(mb->buf);
+    free(mb);
+}
+
+size_t xMessageBufferSend(MessageBufferHandle_t mb, const void *data, size_t len, TickType_t wait)
+{
+    struct timespec deadline;
+    size_t need = len + sizeof(uint32_t);
+    size_t sent = 0;
+
+    if (need > mb->size) return 0;
+    deadline_after(&deadline, wait);
+    pthread_mutex_lock(&kernel_lock);
+    while (mb->size - mb->count < need && kernel_wait(wait, &deadline)) {
+    }
+    if (mb->size - mb->count >= need) {
+        uint32_t hdr = (uint32_t)len;
+        mb_put(mb, &hdr, sizeof(hdr));
+        mb_put(mb, data, len);
+        sent = len;
+        pthread_cond_broadcast(&kernel_cond);
+    }
+    pthread_mutex_unlock(&kernel_lock);
+    return sent;
+}
+
+size_t xMessageBufferSendFromISR(MessageBufferHandle_t mb, const void *data, size_t len, BaseType_t *woken)
+{
+    if (woken != NULL) *woken = pdFALSE;
+    return xMessageBufferSend(mb, data, len, 0);
+}
+
+size_t xMessageBufferReceive(MessageBufferHandle_t mb, void *data, size_t cap, TickType_t wait)
+{
+    struct timespec deadline;
+    size_t got = 0;
+
+    deadline_after(&deadline, wait);
+    pthread_mutex_lock(&kernel_lock);
+    while (mb->count == 0 && kernel_wait(wait, &deadline)) {
+    }
+    if (mb->count >= sizeof(uint32_t)) {
+        uint32_t hdr;
+        mb_peek(mb, &hdr, sizeof(hdr));
+        if (hdr <= cap) {       // 放不下就留着，和 FreeRTOS 一样返回 0
+            mb_get(mb, &hdr, sizeof(hdr));
+            mb_get(mb, data, hdr);
+            got = hdr;
+            pthread_cond_broadcast(&kernel_cond);
+        }
+    }
+    pthread_mutex_unlock(&kernel_lock);
+    return got;
+}
+
+size_t xMessageBufferSpacesAvailable(MessageBufferHandle_t mb)
+{
+    pthread_mutex_lock(&kernel_lock);
+    size_t space = mb->size - mb->count;
+    pthread_mutex_unlock(&kernel_lock);
+    return space;
+}
@@ -0,0 +1,363 @@
+/**
+ * @file rtos_stress.c
+ * @brief 主机端工具：RTOS 模式 (DMA_PRINT_RTOS) 的多任务压力测试
+ * @note  C99 + POSIX 线程，链接 MCU 端的 dma_fifo_print.c，FreeRTOS 换成 rtos_shim.c 的线程替身。用法:
+ *          gcc -O2 -pthread -Ihost -I.. -I../../fast_fmt -DDMA_PRINT_RTOS=1 -DDMA_PRINT_USE_FAST_FMT=1 \
+ *              -DDMA_PRINT_TELEMETRY=1 -DUSE_DRV_STATS -o rtos_stress \
+ *              rtos_stress.c rtos_shim.c telem_host.c ../dma_fifo_print.c ../../fast_fmt/fast_fmt.c
+ *          ./rtos_stress [高优先级任务的行数]
+ *        一个线程扮演串口 + DMA：按 115200 波特率 (86.8us/字节) 的节奏 "发送"，发完调用 DMA_Printf_TxCpltCallback。
+ *        同时运行：注册了独立缓冲区的高优先级任务 (每 6ms 一行) 和遥测任务 (每 10ms 一帧)、
+ *        两个不停打印把串口压满的低优先级任务 (走共用缓冲区)、一个每 5ms 打印一行的 "中断" 线程。
+ *        收到的字节流用 telem_host.c 分离文本和帧。校验：
+ *        1. 高优先级任务的每一行都按顺序到达，一行不丢；
+ *        2. 遥测帧全部到达、CRC 正确、顺序正确；
+ *        3. 中断和低优先级任务的行可以因背压超时被丢弃，但到达的行完整、同一来源内顺序递增；
+ *        4. 没有被插断或拼错的行；DMA 发送期间批次内容不被改写，不会在忙时重复启动；
+ *        5. 统计 (USE_DRV_STATS) 与实际收发一致：收取 = 发送 = 串口收到的字节，丢弃 = 各生产者丢弃之和。
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dma_fifo_print.h"
+#include "telem_host.h"
+
+#if !DMA_PRINT_RTOS || !DMA_PRINT_USE_FAST_FMT || !DMA_PRINT_TELEMETRY || !defined(USE_DRV_STATS)
+#error "需要 -DDMA_PRINT_RTOS=1 -DDMA_PRINT_USE_FAST_FMT=1 -DDMA_PRINT_TELEMETRY=1 -DUSE_DRV_STATS，见文件头的用法"
+#endif
+
+#define FRAME_TYPE      0x21
+#define FRAME_PAYLOAD   16
+
+/* ================= 时间 ================= */
+
+uint32_t host_primask;
+
+static uint64_t now_us(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000u + (uint64_t)t.tv_nsec / 1000u;
+}
+
+static void sleep_us(uint32_t us)
+{
+    struct timespec t = { (time_t)(us / 1000000u), (long)(us % 1000000u) * 1000L };
+    nanosleep(&t, NULL);
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(now_us() / 1000u);
+}
+
+/* ================= 模拟串口 + DMA ================= */
+
+#define OUT_MAX     (4u << 20)
+#define US_PER_BYTE_X10     868u    // 115200 8N1
+
+static UART_HandleTypeDef huart1;
+static pthread_mutex_t uart_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t uart_cond = PTHREAD_COND_INITIALIZER;
+static const uint8_t *uart_src;
+static uint16_t uart_len;
+static int uart_busy;
+
+static uint8_t out[OUT_MAX];
+static size_t out_n;
+static uint32_t dma_starts, dma_busy_starts, dma_overwrites;
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    (void)huart;
+    pthread_mutex_lock(&uart_lock);
+    if (uart_busy) {
+        dma_busy_starts++;
+        pthread_mutex_unlock(&uart_lock);
+        return HAL_BUSY;
+    }
+    uart_src = pData;
+    uart_len = Size;
+    uart_busy = 1;
+    dma_starts++;
+    pthread_cond_signal(&uart_cond);
+    pthread_mutex_unlock(&uart_lock);
+    return HAL_OK;
+}
+
+/**
+ * @brief 串口线程：开始时拍一份快照，按波特率等完后再比一次，发送期间批次被改写就计数
+ */
+static void *uart_thread(void *arg)
+{
+    static uint8_t snap[TX_RING_BUFFER_SIZE];
+    (void)arg;
+
+    rtos_shim_set_isr(1);
+    for (;;) {
+        pthread_mutex_lock(&uart_lock);
+        while (!uart_busy) {
+            pthread_cond_wait(&uart_cond, &uart_lock);
+        }
+        const uint8_t *src = uart_src;
+        uint16_t n = uart_len;
+        pthread_mutex_unlock(&uart_lock);
+
+        memcpy(snap, src, n);
+        sleep_us(n * US_PER_BYTE_X10 / 10u);
+        if (memcmp(snap, src, n) != 0) dma_overwrites++;
+        if (out_n + n <= OUT_MAX) {
+            memcpy(&out[out_n], snap, n);
+            out_n += n;
+        }
+
+        pthread_mutex_lock(&uart_lock);
+        uart_busy = 0;
+        pthread_mutex_unlock(&uart_lock);
+        DMA_Printf_TxCpltCallback(&g_dma_print_handle);
+    }
+    return NULL;
+}
+
+/* ================= 生产者 ================= */
+
+static volatile int stop;
+static uint32_t hp_lines = 400;
+static uint32_t hp_sent, fr_sent, fr_failed, isr_sent, lp_sent[2];
+static uint64_t hp_max_us;
+static TaskHandle_t hp_handle;
+
+#define FR_FRAMES   (hp_lines * 6u / 10u)    // 与高优先级任务同时结束
+
+static void park(void)
+{
+    for (;;) sleep_us(1000000u);
+}
+
+static void hp_task(void *arg)
+{
+    (void)arg;
+    DMA_Printf_RegisterTask(&g_dma_print_handle, 512, 50);
+    for (uint32_t i = 0; i < hp_lines; i++) {
+        uint64_t t0 = now_us();
+        DMA_Printf(&g_dma_print_handle, "H%05u abcdefghijklmnopqrstuvwxyz\n", (unsigned)i);
+        uint64_t dt = now_us() - t0;
+        if (dt > hp_max_us) hp_max_us = dt;
+        hp_sent++;
+        sleep_us(6000);
+    }
+    park();
+}
+
+/* 负载里有 0x00 和 '\n'，帧不能被当成文本拆开 */
+static void frame_payload(uint32_t seq, uint8_t *pl)
+{
+    memcpy(pl, &seq, 4);
+    for (int k = 4; k < FRAME_PAYLOAD; k++) {
+        pl[k] = (uint8_t)(seq * 7u + (uint32_t)k * 13u);
+    }
+    pl[5] = 0x00;
+    pl[6] = '\n';
+}
+
+static void fr_task(void *arg)
+{
+    uint8_t pl[FRAME_PAYLOAD];
+    (void)arg;
+
+    DMA_Printf_RegisterTask(&g_dma_print_handle, 256, 50);
+    for (uint32_t i = 0; i < FR_FRAMES; i++) {
+        frame_payload(i, pl);
+        if (DMA_Printf_Frame(&g_dma_print_handle, FRAME_TYPE, pl, FRAME_PAYLOAD) != 0) fr_failed++;
+        else fr_sent++;
+        sleep_us(10000);
+    }
+    park();
+}
+
+static void lp_task(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+
+    for (uint32_t i = 0; !stop; i++) {
+        DMA_Printf(&g_dma_print_handle, "L%d-%06u zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz\n", id, (unsigned)i);
+        lp_sent[id]++;
+    }
+    park();
+}
+
+static void *isr_thread(void *arg)
+{
+    (void)arg;
+    rtos_shim_set_isr(1);
+    for (uint32_t i = 0; !stop; i++) {
+        DMA_Printf(&g_dma_print_handle, "I%05u\n", (unsigned)i);
+        isr_sent++;
+        sleep_us(5000);
+    }
+    return NULL;
+}
+
+/* ================= 解析 ================= */
+
+typedef struct {
+    uint32_t boot, hp_next, hp_order;
+    uint32_t fr_next, fr_order, fr_bad;
+    uint32_t isr_got, isr_last, isr_order;
+    uint32_t lp_got[2], lp_last[2], lp_order;
+    uint32_t garbled;
+} result_t;
+
+static void on_frame(void *ctx, uint8_t type, const uint8_t *payload, uint16_t len)
+{
+    result_t *r = (result_t *)ctx;
+    uint8_t want[FRAME_PAYLOAD];
+    uint32_t seq;
+
+    if (type != FRAME_TYPE || len != FRAME_PAYLOAD) {
+        r->fr_bad++;
+        return;
+    }
+    memcpy(&seq, payload, 4);
+    frame_payload(seq, want);
+    if (memcmp(payload, want, FRAME_PAYLOAD) != 0) {
+        r->fr_bad++;
+        return;
+    }
+    if (seq != r->fr_next) r->fr_order++;
+    r->fr_next = seq + 1;
+}
+
+static void on_text(void *ctx, const char *text, size_t len)
+{
+    result_t *r = (result_t *)ctx;
+    char line[TELEM_TEXT_BUF + 1], tail[64];
+    unsigned n;
+    int id;
+
+    if (len == 0 || text[len - 1] != '\n') {
+        r->garbled++;
+        return;
+    }
+    memcpy(line, text, len - 1);
+    line[len - 1] = '\0';
+    len--;
+
+    if (len == 33 && sscanf(line, "H%5u %63s", &n, tail) == 2 && strcmp(tail, "abcdefghijklmnopqrstuvwxyz") == 0) {
+        if (n != r->hp_next) r->hp_order++;
+        r->hp_next = n + 1;
+    } else if (len == 6 && sscanf(line, "I%5u", &n) == 1) {
+        if (r->isr_got && n <= r->isr_last) r->isr_order++;
+        r->isr_last = n;
+        r->isr_got++;
+    } else if (len == 42 && sscanf(line, "L%d-%6u %63s", &id, &n, tail) == 3 && (id == 0 || id == 1) &&
+               strcmp(tail, "zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz") == 0) {
+        if (r->lp_got[id] && n <= r->lp_last[id]) r->lp_order++;
+        r->lp_last[id] = n;
+        r->lp_got[id]++;
+    } else if (strcmp(line, "boot 1") == 0) {
+        r->boot++;
+    } else {
+        r->garbled++;
+        if (r->garbled <= 5) printf("  garbled: \"%s\"\n", line);
+    }
+}
+
+/**
+ * @brief 等所有缓冲区收空、最后一批发完
+ */
+static void wait_drained(void)
+{
+    DMA_Print_Stats_t s;
+    uint64_t t_end = now_us() + 5000000u;
+    int quiet = 0;
+
+    while (quiet < 3 && now_us() < t_end) {
+        sleep_us(20000);
+        DMA_Printf_GetStats(&g_dma_print_handle, &s);
+        quiet = (s.level == 0 && !g_dma_print_handle.dma_is_busy) ? quiet + 1 : 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    DMA_Print_Handle_t *h = &g_dma_print_handle;
+    pthread_t uart, isr;
+    TaskHandle_t task;
+    telem_parser_t parser;
+    result_t r;
+    int bad = 0;
+
+    if (argc > 1) hp_lines = (uint32_t)atoi(argv[1]);
+
+    DMA_Printf_Init(h, &huart1);
+    DMA_Printf(h, "boot %d\n", 1);              // 调度器启动前
+    pthread_create(&uart, NULL, uart_thread, NULL);
+    xTaskCreate(hp_task, "hp", 256, NULL, 5, &hp_handle);
+    xTaskCreate(fr_task, "telem", 256, NULL, 4, &task);
+    xTaskCreate(lp_task, "lp0", 256, (void *)0, 2, &task);
+    xTaskCreate(lp_task, "lp1", 256, (void *)1, 2, &task);
+    rtos_shim_start();
+    pthread_create(&isr, NULL, isr_thread, NULL);
+
+    while (hp_sent < hp_lines || fr_sent + fr_failed < FR_FRAMES) {
+        sleep_us(10000);
+    }
+    stop = 1;
+    pthread_join(isr, NULL);
+    sleep_us(100000);                           // 低优先级任务可能还阻塞在一次发送里
+    wait_drained();
+
+    memset(&r, 0, sizeof(r));
+    telem_parser_init(&parser, on_frame, on_text, &r);
+    telem_parser_feed(&parser, out, out_n);
+    telem_parser_finish(&parser);
+
+    uint32_t dropped = h->rtos_dropped, hp_dropped = 0;
+    for (uint8_t i = 0; i < h->n_producers; i++) {
+        dropped += h->producers[i].dropped;
+        if (h->producers[i].task == hp_handle) hp_dropped = h->producers[i].dropped;
+    }
+
+    printf("DMA_PRINT_RTOS: %zu bytes in %u DMA batches (%.0f bytes each)\n", out_n, (unsigned)dma_starts,
+           dma_starts ? (double)out_n / dma_starts : 0.0);
+
+    int hp_ok = r.boot == 1 && r.hp_next == hp_lines && r.hp_order == 0 && hp_dropped == 0;
+    printf("%-30s %s (%u/%u lines, %u dropped, DMA_Printf max %llu us)\n", "high priority task",
+           hp_ok ? "ok" : "FAIL", (unsigned)r.hp_next, (unsigned)hp_sent, (unsigned)hp_dropped,
+           (unsigned long long)hp_max_us);
+    bad |= !hp_ok;
+
+    int fr_ok = r.fr_next == FR_FRAMES && r.fr_order == 0 && r.fr_bad == 0 && fr_failed == 0 &&
+                parser.crc_errors == 0 && parser.overflows == 0;
+    printf("%-30s %s (%u/%u frames, %u CRC errors, %u send failures)\n", "telemetry frames", fr_ok ? "ok" : "FAIL",
+           (unsigned)parser.frames_ok, (unsigned)FR_FRAMES, (unsigned)parser.crc_errors, (unsigned)fr_failed);
+    bad |= !fr_ok;
+
+    int lossy_ok = r.isr_order == 0 && r.lp_order == 0 && r.isr_got > 0 && r.lp_got[0] > 0 && r.lp_got[1] > 0;
+    printf("%-30s %s (ISR %u/%u, low %u+%u/%u+%u lines, %u bytes dropped)\n", "ISR / low priority",
+           lossy_ok ? "ok" : "FAIL", (unsigned)r.isr_got, (unsigned)isr_sent, (unsigned)r.lp_got[0],
+           (unsigned)r.lp_got[1], (unsigned)lp_sent[0], (unsigned)lp_sent[1], (unsigned)dropped);
+    bad |= !lossy_ok;
+
+    int wire_ok = r.garbled == 0 && dma_overwrites == 0 && dma_busy_starts == 0;
+    printf("%-30s %s (%u garbled lines, %u batches overwritten, %u starts while busy)\n", "no interleaving",
+           wire_ok ? "ok" : "FAIL", (unsigned)r.garbled, (unsigned)dma_overwrites, (unsigned)dma_busy_starts);
+    bad |= !wire_ok;
+
+    DMA_Print_Stats_t s;
+    DMA_Printf_GetStats(h, &s);
+    int stats_ok = s.bytes_in == s.bytes_tx && s.bytes_tx == out_n && s.dma_xfers == dma_starts &&
+                   s.dropped == dropped && s.level == 0 && s.level_max > 0 && (dropped == 0) == (s.overflows == 0);
+    printf("%-30s %s (in %u, tx %u, xfers %u, peak %u, dropped %u, overflows %u)\n", "stats", stats_ok ? "ok" : "FAIL",
+           (unsigned)s.bytes_in, (unsigned)s.bytes_tx, (unsigned)s.dma_xfers, (unsigned)s.level_max,
+           (unsigned)s.dropped, (unsigned)s.overflows);
+    bad |= !stats_ok;
+
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file telem_dump.c
+ * @brief 命令行工具：文本日志原样输出，二进制帧按十六进制打印
+ * @note  用法:
+ *          gcc -O2 -o telem_dump telem_dump.c telem_host.c
+ *          stty -F /dev/ttyUSB0 921600 raw && ./telem_dump < /dev/ttyUSB0
+ *        自己的上位机直接链接 telem_host.c，在 on_frame 里按 type 把负载转成结构体即可。
+ */
+
+#include <stdio.h>
+#include "telem_host.h"
+
+static void on_frame(void *ctx, uint8_t type, const uint8_t *payload, uint16_t len)
+{
+    (void)ctx;
+    printf("[frame type=0x%02X len=%u]", type, len);
+    for (uint16_t i = 0; i < len; i++) {
+        printf(" %02X", payload[i]);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+static void on_text(void *ctx, const char *text, size_t len)
+{
+    (void)ctx;
+    fwrite(text, 1, len, stdout);
+    fflush(stdout);
+}
+
+int main(void)
+{
+    telem_parser_t parser;
+    uint8_t buf[512];
+    size_t n;
+
+    telem_parser_init(&parser, on_frame, on_text, NULL);
+
+    while ((n = fread(buf, 1, sizeof(buf), stdin)) > 0) {
+        telem_parser_feed(&parser, buf, n);
+    }
+    telem_parser_finish(&parser);
+
+    fprintf(stderr, "frames: %lu, crc errors: %lu, overflows: %lu\n",
+            (unsigned long)parser.frames_ok,
+            (unsigned long)parser.crc_errors,
+            (unsigned long)parser.overflows);
+    return 0;
+}
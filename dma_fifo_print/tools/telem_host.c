@@ -0,0 +1,164 @@
+/**
+ * @file telem_host.c
+ * @brief 主机端遥测流解析实现
+ * @note  状态机：
+ *          TEXT  : 普通文本，遇到 0x00 认为是帧的起始分隔符
+ *          FRAME : 收集 COBS 数据直到 0x00
+ *          AFTER : 帧结束后的下一个字节若仍是 0x00 则是下一帧的起始，否则回到文本
+ *        文本里不会出现 0x00，所以文本和帧可以任意交错。
+ */
+
+#include "telem_host.h"
+#include <string.h>
+
+enum {
+    TELEM_STATE_TEXT = 0,
+    TELEM_STATE_FRAME,
+    TELEM_STATE_AFTER,
+};
+
+uint32_t telem_crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    size_t i = 0;
+
+    do {
+        uint32_t word = 0;
+        for (unsigned k = 0; k < 4 && i < len; k++) {
+            word |= (uint32_t)data[i++] << (8 * k);
+        }
+        crc ^= word;
+        for (unsigned bit = 0; bit < 32; bit++) {
+            crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04C11DB7u : (crc << 1);
+        }
+    } while (i < len);
+
+    return crc;
+}
+
+int telem_cobs_decode(const uint8_t *in, size_t len, uint8_t *out, size_t out_size)
+{
+    size_t r = 0, w = 0;
+
+    while (r < len) {
+        uint8_t code = in[r++];
+        if (code == 0 || r + code - 1 > len) {
+            return -1;
+        }
+        for (uint8_t k = 1; k < code; k++) {
+            if (w >= out_size) return -1;
+            out[w++] = in[r++];
+        }
+        if (code != 0xFF && r < len) {
+            if (w >= out_size) return -1;
+            out[w++] = 0;
+        }
+    }
+    return (int)w;
+}
+
+static void telem_flush_text(telem_parser_t *p)
+{
+    if (p->text_len && p->on_text) {
+        p->on_text(p->ctx, p->text, p->text_len);
+    }
+    p->text_len = 0;
+}
+
+static void telem_put_text(telem_parser_t *p, uint8_t c)
+{
+    p->text[p->text_len++] = (char)c;
+    if (c == '\n' || p->text_len == sizeof(p->text)) {
+        telem_flush_text(p);
+    }
+}
+
+static void telem_end_frame(telem_parser_t *p)
+{
+    uint8_t raw[TELEM_MAX_ENCODED];
+    int n = telem_cobs_decode(p->frame, p->frame_len, raw, sizeof(raw));
+
+    /* 至少要有 type + CRC */
+    if (n < 5) {
+        p->crc_errors++;
+        return;
+    }
+
+    uint16_t body = (uint16_t)(n - 4);
+    uint32_t rx_crc = (uint32_t)raw[body] |
+                      ((uint32_t)raw[body + 1] << 8) |
+                      ((uint32_t)raw[body + 2] << 16) |
+                      ((uint32_t)raw[body + 3] << 24);
+    if (telem_crc32(raw, body) != rx_crc) {
+        p->crc_errors++;
+        return;
+    }
+
+    p->frames_ok++;
+    if (p->on_frame) {
+        p->on_frame(p->ctx, raw[0], raw + 1, (uint16_t)(body - 1));
+    }
+}
+
+void telem_parser_init(telem_parser_t *p, telem_frame_cb on_frame, telem_text_cb on_text, void *ctx)
+{
+    memset(p, 0, sizeof(*p));
+    p->state = TELEM_STATE_TEXT;
+    p->on_frame = on_frame;
+    p->on_text = on_text;
+    p->ctx = ctx;
+}
+
+void telem_parser_feed(telem_parser_t *p, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = data[i];
+
+        switch (p->state) {
+        case TELEM_STATE_AFTER:
+            if (c != 0) {
+                p->state = TELEM_STATE_TEXT;
+                telem_put_text(p, c);
+                break;
+            }
+            /* 连续的 0x00：下一帧的起始分隔符 */
+            p->state = TELEM_STATE_FRAME;
+            p->frame_len = 0;
+            break;
+
+        case TELEM_STATE_TEXT:
+            if (c != 0) {
+                telem_put_text(p, c);
+                break;
+            }
+            telem_flush_text(p);
+            p->state = TELEM_STATE_FRAME;
+            p->frame_len = 0;
+            break;
+
+        case TELEM_STATE_FRAME:
+            if (c == 0) {
+                if (p->frame_len == 0) {
+                    break;   /* 多余的分隔符 */
+                }
+                telem_end_frame(p);
+                p->state = TELEM_STATE_AFTER;
+                break;
+            }
+            if (p->frame_len == sizeof(p->frame)) {
+                /* 丢了结束分隔符，多半是后面的文本，按文本处理 */
+                p->overflows++;
+                p->state = TELEM_STATE_TEXT;
+                telem_put_text(p, c);
+                break;
+            }
+            p->frame[p->frame_len++] = c;
+            break;
+        }
+    }
+}
+
+void telem_parser_finish(telem_parser_t *p)
+{
+    telem_flush_text(p);
+}
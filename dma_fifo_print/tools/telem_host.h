@@ -0,0 +1,82 @@
+/**
+ * @file telem_host.h
+ * @brief 主机端遥测流解析库：从串口字节流中分离文本日志和 DMA_Printf_Frame 二进制帧
+ * @note  纯 C99，无第三方依赖，可直接编进上位机程序。
+ *        帧格式见 dma_fifo_print.h 中 DMA_PRINT_TELEMETRY 的说明。
+ */
+
+#ifndef __TELEM_HOST_H__
+#define __TELEM_HOST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* 与固件端 DMA_TELEM_MAX_PAYLOAD 保持一致或更大 */
+#define TELEM_MAX_PAYLOAD   248
+/* 单帧 COBS 编码后的最大长度 (不含分隔符) */
+#define TELEM_MAX_ENCODED   (1 + 1 + TELEM_MAX_PAYLOAD + 4)
+/* 文本行缓冲，超过后直接输出 */
+#define TELEM_TEXT_BUF      256
+
+/**
+ * @brief 收到一帧 CRC 校验通过的数据
+ */
+typedef void (*telem_frame_cb)(void *ctx, uint8_t type, const uint8_t *payload, uint16_t len);
+
+/**
+ * @brief 收到一段文本 (按行或缓冲区满时回调，不含 '\0')
+ */
+typedef void (*telem_text_cb)(void *ctx, const char *text, size_t len);
+
+typedef struct {
+    uint8_t state;                      // 解析状态 (TEXT / FRAME / AFTER)
+    uint8_t frame[TELEM_MAX_ENCODED];
+    uint16_t frame_len;
+    char text[TELEM_TEXT_BUF];
+    size_t text_len;
+
+    telem_frame_cb on_frame;
+    telem_text_cb on_text;
+    void *ctx;
+
+    /* 统计 */
+    uint32_t frames_ok;
+    uint32_t crc_errors;                // CRC 错误或 COBS 格式错误
+    uint32_t overflows;                 // 帧超长 (丢失分隔符)
+} telem_parser_t;
+
+/**
+ * @brief 初始化解析器 (回调可以为 NULL)
+ */
+void telem_parser_init(telem_parser_t *p, telem_frame_cb on_frame, telem_text_cb on_text, void *ctx);
+
+/**
+ * @brief 输入任意长度的串口数据，内部自动拼接跨块的帧
+ */
+void telem_parser_feed(telem_parser_t *p, const uint8_t *data, size_t len);
+
+/**
+ * @brief 把残留的文本输出 (流结束时调用)
+ */
+void telem_parser_finish(telem_parser_t *p);
+
+/**
+ * @brief 与固件端一致的 CRC：CRC-32/MPEG-2，按小端 32 位字输入，末尾补 0
+ */
+uint32_t telem_crc32(const uint8_t *data, size_t len);
+
+/**
+ * @brief COBS 解码
+ * @return 解码后的长度，格式错误返回 -1
+ */
+int telem_cobs_decode(const uint8_t *in, size_t len, uint8_t *out, size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TELEM_HOST_H__ */
@@ -0,0 +1,578 @@
+/**
+ * @file fast_fmt.c
+ * @brief 轻量级格式化输出实现
+ * @note  整数转换两位一组查表，32 位以内不触发 64 位除法；
+ *        浮点按定点方式拆成 "整数部分 + 缩放后的小数部分"，不引入 libm
+ */
+
+#include "fast_fmt.h"
+
+/* 格式标志 */
+#define FL_LEFT   0x01  /* '-' 左对齐 */
+#define FL_PLUS   0x02  /* '+' 正数显示符号 */
+#define FL_SPACE  0x04  /* ' ' 正数前留空格 */
+#define FL_ZERO   0x08  /* '0' 用 0 填充宽度 */
+#define FL_ALT    0x10  /* '#' 十六进制/八进制加前缀 */
+#define FL_UPPER  0x20  /* 大写十六进制 */
+
+/* 数字暂存区：64 位八进制最长 22 位，加符号和前缀足够 */
+#define NUM_BUF_SIZE 24
+
+typedef struct {
+    fmt_write_t write;
+    void *ctx;
+    int count;
+} fmt_out_t;
+
+typedef struct {
+    uint8_t flags;
+    int width;
+    int prec;       /* -1 表示未指定 */
+} fmt_spec_t;
+
+/* "00" ~ "99" 两位一组的十进制查找表 */
+static const char digits2[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
+};
+
+static const char hex_lower[16] = "0123456789abcdef";
+static const char hex_upper[16] = "0123456789ABCDEF";
+
+/* ================= 输出辅助 ================= */
+
+static void out_str(fmt_out_t *o, const char *s, int len)
+{
+    while (len > 0) {
+        uint16_t chunk = (len > 0xFFFF) ? 0xFFFF : (uint16_t)len;
+        o->write(o->ctx, s, chunk);
+        o->count += chunk;
+        s += chunk;
+        len -= chunk;
+    }
+}
+
+static void out_pad(fmt_out_t *o, char c, int n)
+{
+    char pad[8];
+    for (uint8_t i = 0; i < sizeof(pad); i++) pad[i] = c;
+
+    while (n > 0) {
+        int chunk = (n > (int)sizeof(pad)) ? (int)sizeof(pad) : n;
+        out_str(o, pad, chunk);
+        n -= chunk;
+    }
+}
+
+/* ================= 整数转换 ================= */
+
+/**
+ * @brief  32 位无符号数转十进制，从 end 往前写，返回位数
+ * @note   除以常量 100 会被编译器优化为乘法 + 移位
+ */
+static int u32_to_dec(uint32_t v, char *end)
+{
+    char *p = end;
+
+    while (v >= 100) {
+        uint32_t q = v / 100;
+        uint32_t r = (v - q * 100) * 2;
+        *--p = digits2[r + 1];
+        *--p = digits2[r];
+        v = q;
+    }
+    if (v >= 10) {
+        *--p = digits2[v * 2 + 1];
+        *--p = digits2[v * 2];
+    } else {
+        *--p = (char)('0' + v);
+    }
+    return (int)(end - p);
+}
+
+#if FMT_ENABLE_LONGLONG
+/**
+ * @brief  64 位无符号数转十进制
+ * @note   每次除以 10^9 切下 9 位交给 32 位路径，64 位除法最多做两次
+ */
+static int u64_to_dec(uint64_t v, char *end)
+{
+    char *p = end;
+
+    while (v > 0xFFFFFFFFu) {
+        uint64_t q = v / 1000000000u;
+        uint32_t r = (uint32_t)(v - q * 1000000000u);
+        int n = u32_to_dec(r, p);
+        p -= n;
+        while (n++ < 9) *--p = '0';
+        v = q;
+    }
+    p -= u32_to_dec((uint32_t)v, p);
+    return (int)(end - p);
+}
+#endif
+
+/**
+ * @brief  转 2 的幂进制 (十六进制 shift=4，八进制 shift=3)
+ */
+static int u64_to_pow2(uint64_t v, char *end, uint8_t shift, const char *table)
+{
+    char *p = end;
+    uint32_t mask = (1u << shift) - 1u;
+
+    do {
+        *--p = table[v & mask];
+        v >>= shift;
+    } while (v);
+    return (int)(end - p);
+}
+
+/**
+ * @brief  按宽度/精度/标志输出一个已经转换好的数字串
+ * @param  sign 符号字符 ('-' '+' ' ')，没有则为 0
+ * @param  prefix 进制前缀 ("0x" 等)，没有则为 NULL
+ */
+static void emit_number(fmt_out_t *o, const fmt_spec_t *spec, char sign,
+                        const char *prefix, const char *digits, int ndigits)
+{
+    int prefix_len = 0;
+    if (prefix) {
+        while (prefix[prefix_len]) prefix_len++;
+    }
+
+    /* 精度 = 最少数字位数；"%.0d" 打印 0 时什么都不输出 */
+    int zeros = 0;
+    if (spec->prec >= 0) {
+        if (spec->prec == 0 && ndigits == 1 && digits[0] == '0') ndigits = 0;
+        if (spec->prec > ndigits) zeros = spec->prec - ndigits;
+    }
+
+    int total = (sign ? 1 : 0) + prefix_len + zeros + ndigits;
+    int pad = (spec->width > total) ? (spec->width - total) : 0;
+
+    /* '0' 标志只在未指定精度且右对齐时生效 */
+    if (pad && (spec->flags & FL_ZERO) && !(spec->flags & FL_LEFT) && spec->prec < 0) {
+        zeros += pad;
+        pad = 0;
+    }
+
+    if (pad && !(spec->flags & FL_LEFT)) out_pad(o, ' ', pad);
+    if (sign) out_str(o, &sign, 1);
+    if (prefix_len) out_str(o, prefix, prefix_len);
+    if (zeros) out_pad(o, '0', zeros);
+    out_str(o, digits, ndigits);
+    if (pad && (spec->flags & FL_LEFT)) out_pad(o, ' ', pad);
+}
+
+static char sign_char(const fmt_spec_t *spec, uint8_t negative)
+{
+    if (negative) return '-';
+    if (spec->flags & FL_PLUS) return '+';
+    if (spec->flags & FL_SPACE) return ' ';
+    return 0;
+}
+
+static void fmt_signed(fmt_out_t *o, const fmt_spec_t *spec, int64_t v)
+{
+    char buf[NUM_BUF_SIZE];
+    char *end = buf + sizeof(buf);
+    uint8_t negative = (v < 0);
+    uint64_t mag = negative ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+    int n;
+
+#if FMT_ENABLE_LONGLONG
+    n = (mag > 0xFFFFFFFFu) ? u64_to_dec(mag, end) : u32_to_dec((uint32_t)mag, end);
+#else
+    n = u32_to_dec((uint32_t)mag, end);
+#endif
+    emit_number(o, spec, sign_char(spec, negative), NULL, end - n, n);
+}
+
+static void fmt_unsigned(fmt_out_t *o, const fmt_spec_t *spec, uint64_t v, char conv)
+{
+    char buf[NUM_BUF_SIZE];
+    char *end = buf + sizeof(buf);
+    const char *prefix = NULL;
+    int n;
+
+    switch (conv) {
+    case 'x':
+    case 'X':
+        n = u64_to_pow2(v, end, 4, (spec->flags & FL_UPPER) ? hex_upper : hex_lower);
+        if ((spec->flags & FL_ALT) && v != 0) prefix = (conv == 'X') ? "0X" : "0x";
+        break;
+    case 'o':
+        n = u64_to_pow2(v, end, 3, hex_lower);
+        if ((spec->flags & FL_ALT) && end[-n] != '0') prefix = "0";
+        break;
+    default:
+#if FMT_ENABLE_LONGLONG
+        n = (v > 0xFFFFFFFFu) ? u64_to_dec(v, end) : u32_to_dec((uint32_t)v, end);
+#else
+        n = u32_to_dec((uint32_t)v, end);
+#endif
+        break;
+    }
+    emit_number(o, spec, 0, prefix, end - n, n);
+}
+
+/* ================= 浮点转换 ================= */
+
+#if FMT_ENABLE_FLOAT
+
+static const uint32_t pow10_u32[10] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+/**
+ * @brief  %f：直接拆 IEEE754 位域，整数部分和小数部分全部用整数运算
+ * @note   不做任何浮点乘除，没有 FPU 的 M0/M3 上也很快，并且结果是精确的：
+ *         小数部分展开为 Q128 定点数，乘以 10^prec 后按余数做舍入，
+ *         恰好落在 0.5 上时与 glibc 一样取偶数 (银行家舍入)。
+ *         整数部分超过 64 位范围时输出 "ovf" (与 glibc 不同，嵌入式日志里基本遇不到)
+ */
+static void fmt_float(fmt_out_t *o, const fmt_spec_t *spec_in, double value)
+{
+    fmt_spec_t spec = *spec_in;
+    char buf[NUM_BUF_SIZE + FMT_FLOAT_MAX_PREC + 2];
+    char *end = buf + sizeof(buf);
+    int n = 0;
+
+    int prec = (spec.prec < 0) ? 6 : spec.prec;
+    if (prec > FMT_FLOAT_MAX_PREC) prec = FMT_FLOAT_MAX_PREC;
+    spec.prec = -1;   /* 精度已经用掉了，emit_number 只处理宽度 */
+
+    union { double d; uint64_t u; } bits;
+    bits.d = value;
+
+    uint8_t negative = (uint8_t)(bits.u >> 63);
+    int32_t exp = (int32_t)((bits.u >> 52) & 0x7FF);
+    uint64_t mant = bits.u & 0x000FFFFFFFFFFFFFull;
+
+    if (exp == 0x7FF) {
+        spec.flags &= ~FL_ZERO;
+        if (mant) emit_number(o, &spec, 0, NULL, "nan", 3);
+        else      emit_number(o, &spec, sign_char(&spec, negative), NULL, "inf", 3);
+        return;
+    }
+
+    /* value = mant * 2^exp */
+    if (exp == 0) {
+        exp = -1074;                 /* 非规格化数 */
+    } else {
+        mant |= 1ull << 52;
+        exp -= 1075;
+    }
+
+    uint64_t ipart = 0;
+    uint64_t frac = 0;               /* 小数部分 Q64 (高 64 位) */
+    uint64_t frac_lo = 0;            /* 小数部分再往下 64 位，保证舍入判断精确 */
+    uint8_t sticky = 0;              /* Q128 之外还有被丢掉的非零位 */
+
+    if (exp >= 0) {
+        if (exp > 11) {              /* 超过 2^64 */
+            spec.flags &= ~FL_ZERO;
+            emit_number(o, &spec, sign_char(&spec, negative), NULL, "ovf", 3);
+            return;
+        }
+        ipart = mant << exp;
+    } else {
+        int32_t shift = -exp;
+        if (shift < 64) {
+            ipart = mant >> shift;
+            frac = mant << (64 - shift);
+        } else if (shift < 128) {
+            frac = mant >> (shift - 64);
+            frac_lo = (shift == 64) ? 0 : (mant << (128 - shift));
+        } else if (shift < 192) {
+            frac_lo = mant >> (shift - 128);
+            sticky = (shift == 128) ? 0 : ((mant << (192 - shift)) != 0);
+        } else {
+            sticky = (mant != 0);
+        }
+    }
+
+    /* 小数部分 × 10^prec：乘积的整数部分是需要的数字，剩下的 Q64 是舍入余数 */
+    uint32_t scale = pow10_u32[prec];
+    uint64_t lo2 = (frac_lo & 0xFFFFFFFFu) * scale;
+    uint64_t hi2 = (frac_lo >> 32) * scale + (lo2 >> 32);
+    if ((hi2 << 32) | (lo2 & 0xFFFFFFFFu)) sticky = 1;
+
+    uint64_t lo = (frac & 0xFFFFFFFFu) * scale + (hi2 >> 32);
+    uint64_t hi = (frac >> 32) * scale + (lo >> 32);
+    uint32_t digits = (uint32_t)(hi >> 32);
+    uint64_t rem = (hi << 32) | (lo & 0xFFFFFFFFu);
+
+    uint8_t round_up;
+    if (rem > 0x8000000000000000ull || (rem == 0x8000000000000000ull && sticky)) {
+        round_up = 1;
+    } else if (rem == 0x8000000000000000ull) {
+        /* 恰好一半：看最后一位是否为奇数 */
+        round_up = (prec > 0) ? (digits & 1u) : (uint8_t)(ipart & 1u);
+    } else {
+        round_up = 0;
+    }
+
+    if (round_up && ++digits >= scale) {
+        digits -= scale;
+        ipart++;
+    }
+
+    if (prec > 0) {
+        char *p = end;
+        int fn = u32_to_dec(digits, p);
+        p -= fn;
+        while (fn++ < prec) *--p = '0';
+        *--p = '.';
+        n = (int)(end - p);
+    } else if (spec.flags & FL_ALT) {
+        end[-1] = '.';
+        n = 1;
+    }
+
+#if FMT_ENABLE_LONGLONG
+    n += (ipart > 0xFFFFFFFFu) ? u64_to_dec(ipart, end - n) : u32_to_dec((uint32_t)ipart, end - n);
+#else
+    n += u32_to_dec((uint32_t)ipart, end - n);
+#endif
+
+    emit_number(o, &spec, sign_char(&spec, negative), NULL, end - n, n);
+}
+
+#endif /* FMT_ENABLE_FLOAT */
+
+/* ================= 格式解析 ================= */
+
+int fmt_vformat(fmt_write_t out, void *ctx, const char *format, va_list args)
+{
+    fmt_out_t o;
+    o.write = out;
+    o.ctx = ctx;
+    o.count = 0;
+
+    while (*format) {
+        /* 普通字符成段输出，减少回调次数 */
+        const char *run = format;
+        while (*format && *format != '%') format++;
+        if (format != run) out_str(&o, run, (int)(format - run));
+        if (!*format) break;
+        format++;
+
+        fmt_spec_t spec;
+        spec.flags = 0;
+        spec.width = 0;
+        spec.prec = -1;
+
+        /* 1. 标志 */
+        for (;;) {
+            char c = *format;
+            if (c == '-') spec.flags |= FL_LEFT;
+            else if (c == '+') spec.flags |= FL_PLUS;
+            else if (c == ' ') spec.flags |= FL_SPACE;
+            else if (c == '0') spec.flags |= FL_ZERO;
+            else if (c == '#') spec.flags |= FL_ALT;
+            else break;
+            format++;
+        }
+
+        /* 2. 宽度 */
+        if (*format == '*') {
+            spec.width = va_arg(args, int);
+            if (spec.width < 0) {
+                spec.flags |= FL_LEFT;
+                spec.width = -spec.width;
+            }
+            format++;
+        } else {
+            while (*format >= '0' && *format <= '9') {
+                spec.width = spec.width * 10 + (*format++ - '0');
+            }
+        }
+
+        /* 3. 精度 */
+        if (*format == '.') {
+            format++;
+            spec.prec = 0;
+            if (*format == '*') {
+                spec.prec = va_arg(args, int);
+                if (spec.prec < 0) spec.prec = -1;
+                format++;
+            } else {
+                while (*format >= '0' && *format <= '9') {
+                    spec.prec = spec.prec * 10 + (*format++ - '0');
+                }
+            }
+        }
+
+        /* 4. 长度修饰 */
+        uint8_t length = 0;   /* 0=int 1=long 2=long long 3=size_t 4=long double */
+        int8_t narrow = 0;    /* 1=short 2=char */
+        for (;;) {
+            char c = *format;
+            if (c == 'l') length = (length == 1) ? 2 : 1;
+            else if (c == 'h') narrow = (narrow == 1) ? 2 : 1;
+            else if (c == 'z' || c == 't') length = 3;
+            else if (c == 'j') length = 2;
+            else if (c == 'L') length = 4;
+            else break;
+            format++;
+        }
+
+        /* 5. 转换 */
+        char conv = *format;
+        if (!conv) break;
+        format++;
+
+        switch (conv) {
+        case 'd':
+        case 'i': {
+            int64_t v;
+            if (length == 2) v = va_arg(args, long long);
+            else if (length == 1) v = va_arg(args, long);
+            else if (length == 3) v = (int64_t)va_arg(args, ptrdiff_t);
+            else v = va_arg(args, int);
+            if (narrow == 1) v = (short)v;
+            else if (narrow == 2) v = (signed char)v;
+            fmt_signed(&o, &spec, v);
+            break;
+        }
+        case 'X':
+            spec.flags |= FL_UPPER;
+            /* fall through */
+        case 'u':
+        case 'x':
+        case 'o': {
+            uint64_t v;
+            if (length == 2) v = va_arg(args, unsigned long long);
+            else if (length == 1) v = va_arg(args, unsigned long);
+            else if (length == 3) v = va_arg(args, size_t);
+            else v = va_arg(args, unsigned int);
+            if (narrow == 1) v = (unsigned short)v;
+            else if (narrow == 2) v = (unsigned char)v;
+            fmt_unsigned(&o, &spec, v, conv);
+            break;
+        }
+        case 'p': {
+            uintptr_t v = (uintptr_t)va_arg(args, void *);
+            spec.flags |= FL_ALT;
+            fmt_unsigned(&o, &spec, v, 'x');
+            break;
+        }
+        case 'c': {
+            char c = (char)va_arg(args, int);
+            int pad = (spec.width > 1) ? spec.width - 1 : 0;
+            if (!(spec.flags & FL_LEFT)) out_pad(&o, ' ', pad);
+            out_str(&o, &c, 1);
+            if (spec.flags & FL_LEFT) out_pad(&o, ' ', pad);
+            break;
+        }
+        case 's': {
+            const char *s = va_arg(args, const char *);
+            int len = 0;
+            if (!s) s = "(null)";
+            /* 有精度时最多读 prec 个字符，不要求 '\0' 结尾 */
+            while ((spec.prec < 0 || len < spec.prec) && s[len]) len++;
+            int pad = (spec.width > len) ? spec.width - len : 0;
+            if (!(spec.flags & FL_LEFT)) out_pad(&o, ' ', pad);
+            out_str(&o, s, len);
+            if (spec.flags & FL_LEFT) out_pad(&o, ' ', pad);
+            break;
+        }
+#if FMT_ENABLE_FLOAT
+        case 'f':
+        case 'F':
+            /* %Lf 的参数是 long double，按 double 取会和后面的参数错位 */
+            fmt_float(&o, &spec, (length == 4) ? (double)va_arg(args, long double) : va_arg(args, double));
+            break;
+#endif
+        case '%':
+            out_str(&o, "%", 1);
+            break;
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+#if !FMT_ENABLE_FLOAT
+        case 'f':
+        case 'F':
+#endif
+            /* 不支持的浮点转换：参数照样取走，否则后面的参数全部错位 */
+            if (length == 4) (void)va_arg(args, long double);
+            else (void)va_arg(args, double);
+            out_str(&o, format - 1, 1);
+            break;
+        case 'n':
+            (void)va_arg(args, void *);     /* 不回写计数 */
+            break;
+        default:
+            /* 不认识的转换原样输出，便于发现格式串错误 */
+            out_str(&o, format - 1, 1);
+            break;
+        }
+    }
+
+    return o.count;
+}
+
+int fmt_format(fmt_write_t out, void *ctx, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int n = fmt_vformat(out, ctx, format, args);
+    va_end(args);
+    return n;
+}
+
+/* ================= 内存输出 ================= */
+
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t pos;
+} fmt_mem_t;
+
+static void fmt_mem_write(void *ctx, const char *s, uint16_t len)
+{
+    fmt_mem_t *m = (fmt_mem_t *)ctx;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (m->pos + 1 < m->size) {
+            m->buf[m->pos] = s[i];
+        }
+        m->pos++;
+    }
+}
+
+int fmt_vsnprintf(char *buf, size_t size, const char *format, va_list args)
+{
+    fmt_mem_t m;
+    m.buf = buf;
+    m.size = size;
+    m.pos = 0;
+
+    int n = fmt_vformat(fmt_mem_write, &m, format, args);
+
+    if (size > 0) {
+        buf[(m.pos < size) ? m.pos : size - 1] = '\0';
+    }
+    return n;
+}
+
+int fmt_snprintf(char *buf, size_t size, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int n = fmt_vsnprintf(buf, size, format, args);
+    va_end(args);
+    return n;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file fast_fmt.h
+ * @brief 零分配、无中间缓冲区的轻量级格式化输出
+ * @note  替代 newlib 的 vsnprintf：不依赖 libc 的 printf 家族，不 malloc，
+ *        格式化结果通过回调直接写进 OLED 字模管线或 DMA 环形缓冲区
+ */
+
+#ifndef __FAST_FMT_H__
+#define __FAST_FMT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+/* ================= 用户配置区 ================= */
+
+/* 支持 %f (纯整数实现，不链接软浮点库；置 0 可进一步减小 Flash) */
+#define FMT_ENABLE_FLOAT      1
+
+/* %f 的最大小数位数 (受 32 位小数部分限制，最大 9) */
+#define FMT_FLOAT_MAX_PREC    9
+
+/* 支持 %lld / %llu / %llx (64 位除法在 M3/M4 上是库函数调用，不需要可关掉) */
+#define FMT_ENABLE_LONGLONG   1
+
+/**
+ * @brief 输出回调：把一段连续字符交给下游 (屏幕/串口/内存)
+ * @param ctx 用户上下文
+ * @param s 字符指针 (不保证以 '\0' 结尾)
+ * @param len 字符个数
+ */
+typedef void (*fmt_write_t)(void *ctx, const char *s, uint16_t len);
+
+/**
+ * @brief 格式化核心
+ * @note  支持 %d %i %u %x %X %o %c %s %p %f %%，
+ *        标志 '-' '+' ' ' '0' '#'，宽度/精度 (含 '*')，长度修饰 hh h l ll z；
+ *        %e %g %a 只输出转换字符，但会取走对应的 double 参数，后面的参数不受影响
+ * @return 输出的字符总数
+ */
+int fmt_vformat(fmt_write_t out, void *ctx, const char *format, va_list args);
+
+/**
+ * @brief 格式化核心 (可变参数版)
+ */
+int fmt_format(fmt_write_t out, void *ctx, const char *format, ...);
+
+/**
+ * @brief 格式化到内存 (语义同 vsnprintf：总是以 '\0' 结尾，返回完整长度)
+ */
+int fmt_vsnprintf(char *buf, size_t size, const char *format, va_list args);
+
+/**
+ * @brief 格式化到内存 (语义同 snprintf)
+ */
+int fmt_snprintf(char *buf, size_t size, const char *format, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FAST_FMT_H__ */
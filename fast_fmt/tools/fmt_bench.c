@@ -0,0 +1,189 @@
+/**
+ * @file fmt_bench.c
+ * @brief 主机端工具：fast_fmt 与 glibc snprintf 逐字节对比，并测两者的耗时
+ * @note  纯 C99，直接链接 MCU 端的 fast_fmt.c。用法:
+ *          gcc -O2 -I.. -o fmt_bench fmt_bench.c ../fast_fmt.c -lm
+ *          ./fmt_bench [随机轮数]
+ *        1. 固定用例：标志/宽度/精度/长度修饰的组合、%f 的舍入边界 (含 0.5 取偶)、NaN/Inf、截断；
+ *        2. 随机用例：随机数值套用常见格式，输出和返回值都必须与 glibc 一致；
+ *        3. 不支持的转换 (%e %g %a %n) 必须取走参数，后面的参数不能错位；
+ *        4. 基准：同一组格式在两边各跑若干次，给出每次调用的平均纳秒数。
+ *        主机上的绝对耗时没有意义 (glibc 有 FPU 和大缓存)，只看两者的比例和趋势。
+ */
+
+#define _POSIX_C_SOURCE 199309L   /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "fast_fmt.h"
+
+static int fails;
+static long checks;
+
+#define CHECK(...) do {                                                         \
+    char want[256], got[256];                                                   \
+    int nw = snprintf(want, sizeof(want), __VA_ARGS__);                         \
+    int ng = fmt_snprintf(got, sizeof(got), __VA_ARGS__);                       \
+    checks++;                                                                   \
+    if (nw != ng || strcmp(want, got) != 0) {                                   \
+        if (fails < 20) {                                                       \
+            printf("  MISMATCH %s\n    glibc [%s] %d\n    fast  [%s] %d\n",     \
+                   #__VA_ARGS__, want, nw, got, ng);                            \
+        }                                                                       \
+        fails++;                                                                \
+    }                                                                           \
+} while (0)
+
+/* ================= 固定用例 ================= */
+
+static void test_fixed(void)
+{
+    CHECK("hello");
+    CHECK("%d|%d|%d", 0, -123, 2147483647);
+    CHECK("%5d|%-5d|%05d|%+d|% d", 42, 42, -42, 5, 5);
+    CHECK("%u %x %X %o %#x %#o %#X", 4000000000u, 0xdeadbeefu, 0xabcu, 8u, 255u, 8u, 255u);
+    CHECK("%lld %llu %llx", -9223372036854775807LL - 1, 18446744073709551615ULL, 0x123456789abcdefULL);
+    CHECK("%ld %lu", -2147483647L, 4294967295UL);
+    CHECK("%hd %hhu %hhd", 70000, 300, 200);
+    CHECK("%zu %%", (size_t)12345);
+    CHECK("%.3d|%.0d|%8.3d|%-8.3d|%5.0d|", 7, 0, -7, 7, 0);
+    CHECK("%x|%#x|%.0x|%#o", 0u, 0u, 0u, 0u);
+    CHECK("%c|%3c|%-3c|", 'a', 'b', 'c');
+    CHECK("%s|%10s|%-10s|%.2s|%*s|%-*s|", "abc", "abc", "abc", "abc", 6, "x", 6, "y");
+    CHECK("%p", (void *)0x1234);
+
+    CHECK("%f|%.2f|%.0f", 3.14159, 2.675, 0.5);
+    CHECK("%.0f %.0f %.0f %.0f", 0.5, 1.5, 2.5, -0.5);
+    CHECK("%10.3f|%-10.3f|%010.3f|%+.1f", -3.14159, 2.5, -1.25, 0.05);
+    CHECK("%f %f", -0.0, 1.0 / 3);
+    CHECK("%.9f|%.9f|%.9f|%.9f", 1e-10, 5e-10, 1.5e-9, 2.5e-9);
+    CHECK("%.2f %.2f %.2f", 0.125, 0.375, 1.005);
+    CHECK("%f|%f|%f", 1e18, 1.8e19, 123456789.987654);
+    CHECK("%.3f %.3f %.3f", 0.0005, 0.0015, 1e-4);
+    CHECK("%f %f", 1e-300, 4.9e-324);
+    CHECK("%f|%5.1f|%f|%f", NAN, NAN, INFINITY, -INFINITY);
+    CHECK("%#.0f|%.*f", 3.0, 3, 1.23456);
+    CHECK("%.1f %.1f %.1f %.4f", 0.95, 0.25, 99.95, 1.00005);
+    CHECK("%.3Lf|%d|%Lf|%s", 2.5L, 7, -1.25L, "end");    /* long double 取走后参数不能错位 */
+
+    /* 截断：返回完整长度，缓冲区总是以 '\0' 结尾 */
+    char small[5];
+    int n = fmt_snprintf(small, sizeof(small), "%d", 123456);
+    checks++;
+    if (n != 6 || strcmp(small, "1234") != 0) {
+        printf("  MISMATCH truncation: [%s] %d\n", small, n);
+        fails++;
+    }
+}
+
+/* ================= 随机用例 ================= */
+
+static void test_random(long rounds)
+{
+    srand(1);
+    for (long i = 0; i < rounds; i++) {
+        double d = ((double)rand() / RAND_MAX - 0.5) * pow(10, rand() % 12 - 4);
+        int p = rand() % 10;
+        CHECK("%.*f", p, d);
+        CHECK("%10.3f|%-+12.2f|%08.1f", d, d, d);
+
+        int v = rand() - RAND_MAX / 2;
+        CHECK("%d %5d %-5d| %05d %+d % d %.3d %x %#x %#o %X", v, v, v, v, v, v, v,
+              (unsigned)v, (unsigned)v, (unsigned)v, (unsigned)v);
+
+        long long ll = ((long long)rand() << 33) ^ rand();
+        CHECK("%lld %llu %llx", ll, (unsigned long long)ll, (unsigned long long)ll);
+
+        int w1 = rand() % 12, w2 = rand() % 12;     // CHECK 会把参数求值两次，随机数要先取出来
+        CHECK("%hhd %hu %*d|%-*u|", v, (unsigned)v, w1, v, w2, (unsigned)v);
+    }
+}
+
+/* ================= 不支持的转换 ================= */
+
+static void expect(const char *what, const char *got, const char *want)
+{
+    checks++;
+    if (strcmp(got, want) != 0) {
+        printf("  MISMATCH %s: got [%s] want [%s]\n", what, got, want);
+        fails++;
+    }
+}
+
+/**
+ * @brief 不支持的转换只输出转换字符，但必须按类型取走参数
+ * @note  后面跟一个 double 的用例在 x86-64 上也能暴露错位 (整数走整数寄存器，错位看不出来)
+ */
+static void test_unsupported(void)
+{
+    char buf[64];
+    int count = -1;
+
+    fmt_snprintf(buf, sizeof(buf), "%g %d", 1234.5, 7);
+    expect("%g %d", buf, "g 7");
+    fmt_snprintf(buf, sizeof(buf), "%e|%.2f", 1.5, 2.25);
+    expect("%e %f", buf, "e|2.25");
+    fmt_snprintf(buf, sizeof(buf), "%a|%G|%.1f|%s", 0.1, 2.0, 3.5, "ok");
+    expect("%a %G %f %s", buf, "a|G|3.5|ok");
+    fmt_snprintf(buf, sizeof(buf), "%Lg|%.1f", (long double)1.0, 4.5);
+    expect("%Lg %f", buf, "g|4.5");
+    fmt_snprintf(buf, sizeof(buf), "ab%ncd|%d", &count, 9);
+    expect("%n %d", buf, "abcd|9");
+    checks++;
+    if (count != -1) {
+        printf("  MISMATCH %%n wrote %d\n", count);
+        fails++;
+    }
+}
+
+/* ================= 基准 ================= */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile int sink;
+
+#define BENCH(name, iters, ...) do {                                            \
+    char b[128];                                                                \
+    double t0 = now_ns();                                                       \
+    for (int k = 0; k < (iters); k++) sink += snprintf(b, sizeof(b), __VA_ARGS__); \
+    double t1 = now_ns();                                                       \
+    for (int k = 0; k < (iters); k++) sink += fmt_snprintf(b, sizeof(b), __VA_ARGS__); \
+    double t2 = now_ns();                                                       \
+    printf("  %-22s glibc %7.1f ns  fast_fmt %7.1f ns  (x%.2f)\n", name,        \
+           (t1 - t0) / (iters), (t2 - t1) / (iters), (t1 - t0) / (t2 - t1));    \
+} while (0)
+
+static void bench(void)
+{
+    const int n = 300000;
+    volatile double v = 23.456;
+    volatile int adc = 3071;
+
+    printf("per call:\n");
+    BENCH("\"%d\"", n, "%d", adc);
+    BENCH("\"ADC: %4u %04x\"", n, "ADC: %4u %04x", (unsigned)adc, (unsigned)adc);
+    BENCH("\"T=%6.2f C\"", n, "T=%6.2f C", v);
+    BENCH("\"%.3f %.3f %.3f\"", n, "%.3f %.3f %.3f", v, -v, v * 100);
+    BENCH("\"%s: %lu ms\"", n, "%s: %lu ms", "loop", 123456UL);
+}
+
+int main(int argc, char **argv)
+{
+    long rounds = argc > 1 ? atol(argv[1]) : 200000;
+
+    test_fixed();
+    test_random(rounds);
+    test_unsupported();
+    printf("%ld checks against glibc snprintf: %s (%d mismatches)\n", checks, fails ? "FAIL" : "ok", fails);
+
+    bench();
+    return fails ? 1 : 0;
+}
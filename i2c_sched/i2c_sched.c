@@ -0,0 +1,329 @@
+/**
+ * @file i2c_sched.c
+ * @brief 共享 I2C 总线调度器实现
+ */
+
+#include "i2c_sched.h"
+#include <string.h>
+
+#define XFER_NONE   0xFFu
+
+enum {
+    I2C_OP_WRITE = 0,
+    I2C_OP_MEM_WRITE,
+    I2C_OP_MEM_READ,
+};
+
+static i2c_bus_t *sched_buses[I2C_SCHED_MAX_BUSES];
+
+/* ================= 队列 ================= */
+
+static i2c_bus_t *sched_find(I2C_HandleTypeDef *hi2c)
+{
+    for (uint8_t i = 0; i < I2C_SCHED_MAX_BUSES; i++) {
+        if (sched_buses[i] && sched_buses[i]->hi2c == hi2c) {
+            return sched_buses[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 挑选下一段要传的事务：最高优先级非空队列的队首
+ * @note  分段事务传完一段后仍在队首，所以高优先级新事务自然会插到它的两段之间
+ */
+static uint8_t sched_pick(i2c_bus_t *bus, uint8_t *prio)
+{
+    for (uint8_t p = 0; p < I2C_PRIO_COUNT; p++) {
+        if (bus->head[p] != XFER_NONE) {
+            *prio = p;
+            return bus->head[p];
+        }
+    }
+    return XFER_NONE;
+}
+
+/**
+ * @brief 总线空闲时启动下一段 (调用者已关中断或处于 I2C 中断中)
+ * @return 需要启动的槽位，XFER_NONE 表示没有
+ */
+static uint8_t sched_claim_next(i2c_bus_t *bus)
+{
+    uint8_t prio;
+
+    if (bus->active != XFER_NONE) return XFER_NONE;
+
+    uint8_t idx = sched_pick(bus, &prio);
+    if (idx == XFER_NONE) return XFER_NONE;
+
+    i2c_xfer_t *x = &bus->xfers[idx];
+    uint16_t n = x->len - x->done;
+    if (x->chunk && n > x->chunk) n = x->chunk;
+
+    // 上一段属于更低优先级的分段事务且还没传完，说明这次是插队
+    if (bus->active_prio > prio && bus->active_prio < I2C_PRIO_COUNT &&
+        bus->head[bus->active_prio] != XFER_NONE && bus->xfers[bus->head[bus->active_prio]].done) {
+        bus->preemptions++;
+    }
+
+    bus->active = idx;
+    bus->active_prio = prio;
+    bus->active_len = n;
+    return idx;
+}
+
+static void sched_finish(i2c_bus_t *bus, uint8_t idx, uint8_t prio, int status);
+
+/**
+ * @brief 把已认领的一段交给 HAL；启动失败就按错误结束并尝试下一个
+ */
+static void sched_start(i2c_bus_t *bus, uint8_t idx)
+{
+    while (idx != XFER_NONE) {
+        i2c_xfer_t *x = &bus->xfers[idx];
+        uint8_t *ptr = x->data + x->done;
+        uint16_t n = bus->active_len;
+        HAL_StatusTypeDef st;
+
+        switch (x->op) {
+        case I2C_OP_WRITE:
+            st = (n >= I2C_SCHED_DMA_MIN) ?
+                 HAL_I2C_Master_Transmit_DMA(bus->hi2c, x->dev_addr, ptr, n) :
+                 HAL_I2C_Master_Transmit_IT(bus->hi2c, x->dev_addr, ptr, n);
+            break;
+        case I2C_OP_MEM_WRITE:
+            st = (n >= I2C_SCHED_DMA_MIN) ?
+                 HAL_I2C_Mem_Write_DMA(bus->hi2c, x->dev_addr, x->mem, I2C_MEMADD_SIZE_8BIT, ptr, n) :
+                 HAL_I2C_Mem_Write_IT(bus->hi2c, x->dev_addr, x->mem, I2C_MEMADD_SIZE_8BIT, ptr, n);
+            break;
+        default:
+            st = (n >= I2C_SCHED_DMA_MIN) ?
+                 HAL_I2C_Mem_Read_DMA(bus->hi2c, x->dev_addr, x->mem, I2C_MEMADD_SIZE_8BIT, ptr, n) :
+                 HAL_I2C_Mem_Read_IT(bus->hi2c, x->dev_addr, x->mem, I2C_MEMADD_SIZE_8BIT, ptr, n);
+            break;
+        }
+
+        if (st == HAL_OK) return;
+
+        // 启动失败 (外设忙/参数错)：结束这个事务，换下一个
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        uint8_t prio = bus->active_prio;
+        bus->active = XFER_NONE;
+        __set_PRIMASK(primask);
+
+        sched_finish(bus, idx, prio, I2C_SCHED_ERROR);
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+        idx = sched_claim_next(bus);
+        __set_PRIMASK(primask);
+    }
+}
+
+/**
+ * @brief 事务出队、归还槽位并回调
+ */
+static void sched_finish(i2c_bus_t *bus, uint8_t idx, uint8_t prio, int status)
+{
+    i2c_xfer_t *x = &bus->xfers[idx];
+    i2c_sched_cb_t cb = x->cb;
+    void *arg = x->arg;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bus->head[prio] = x->next;
+    if (bus->head[prio] == XFER_NONE) {
+        bus->tail[prio] = XFER_NONE;
+    }
+    bus->free_mask |= (1u << idx);
+    __set_PRIMASK(primask);
+
+    if (cb) {
+        cb(status, arg);
+    }
+}
+
+static int sched_submit(i2c_bus_t *bus, i2c_prio_t prio, uint8_t op, uint16_t dev_addr, uint8_t mem,
+                        uint8_t *data, uint16_t len, uint16_t chunk, i2c_sched_cb_t cb, void *arg)
+{
+    if (len == 0 || prio >= I2C_PRIO_COUNT) return -1;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (bus->free_mask == 0) {
+        __set_PRIMASK(primask);
+        return -1;
+    }
+    uint8_t idx = 0;
+    while (!(bus->free_mask & (1u << idx))) idx++;
+    bus->free_mask &= ~(1u << idx);
+
+    i2c_xfer_t *x = &bus->xfers[idx];
+    x->next = XFER_NONE;
+    x->op = op;
+    x->dev_addr = dev_addr;
+    x->mem = mem;
+    x->len = len;
+    x->done = 0;
+    x->chunk = chunk;
+    x->cb = cb;
+    x->arg = arg;
+    if (op != I2C_OP_MEM_READ && len <= I2C_SCHED_INLINE) {
+        memcpy(x->buf, data, len);      // 短命令拷贝一份，调用者的栈变量可以立即释放
+        x->data = x->buf;
+    } else {
+        x->data = data;
+    }
+
+    if (bus->tail[prio] == XFER_NONE) {
+        bus->head[prio] = idx;
+    } else {
+        bus->xfers[bus->tail[prio]].next = idx;
+    }
+    bus->tail[prio] = idx;
+
+    uint8_t start = sched_claim_next(bus);
+    __set_PRIMASK(primask);
+
+    sched_start(bus, start);
+    return 0;
+}
+
+/* ================= 对外接口 ================= */
+
+void i2c_sched_init(i2c_bus_t *bus, I2C_HandleTypeDef *hi2c)
+{
+    memset(bus, 0, sizeof(i2c_bus_t));
+    bus->hi2c = hi2c;
+    bus->free_mask = (I2C_SCHED_QUEUE >= 32) ? 0xFFFFFFFFu : ((1u << I2C_SCHED_QUEUE) - 1u);
+    bus->active = XFER_NONE;
+    bus->active_prio = I2C_PRIO_COUNT;
+    for (uint8_t p = 0; p < I2C_PRIO_COUNT; p++) {
+        bus->head[p] = XFER_NONE;
+        bus->tail[p] = XFER_NONE;
+    }
+
+    for (uint8_t i = 0; i < I2C_SCHED_MAX_BUSES; i++) {
+        if (sched_buses[i] == NULL || sched_buses[i] == bus) {
+            sched_buses[i] = bus;
+            break;
+        }
+    }
+}
+
+int i2c_sched_write(i2c_bus_t *bus, i2c_prio_t prio, uint16_t dev_addr,
+                    const uint8_t *data, uint16_t len, i2c_sched_cb_t cb, void *arg)
+{
+    return sched_submit(bus, prio, I2C_OP_WRITE, dev_addr, 0, (uint8_t *)data, len, 0, cb, arg);
+}
+
+int i2c_sched_mem_write(i2c_bus_t *bus, i2c_prio_t prio, uint16_t dev_addr, uint8_t mem,
+                        const uint8_t *data, uint16_t len, uint16_t chunk,
+                        i2c_sched_cb_t cb, void *arg)
+{
+    return sched_submit(bus, prio, I2C_OP_MEM_WRITE, dev_addr, mem, (uint8_t *)data, len, chunk, cb, arg);
+}
+
+int i2c_sched_mem_read(i2c_bus_t *bus, i2c_prio_t prio, uint16_t dev_addr, uint8_t mem,
+                       uint8_t *data, uint16_t len, i2c_sched_cb_t cb, void *arg)
+{
+    return sched_submit(bus, prio, I2C_OP_MEM_READ, dev_addr, mem, data, len, 0, cb, arg);
+}
+
+void i2c_sched_sync_cb(int status, void *arg)
+{
+    *(volatile int *)arg = status;
+}
+
+int i2c_sched_sync_wait(volatile int *status, uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (*status == I2C_SCHED_PENDING) {
+        if (HAL_GetTick() - start > timeout_ms) {
+            return I2C_SCHED_TIMEOUT;
+        }
+    }
+    return *status;
+}
+
+int i2c_sched_cancel(i2c_bus_t *bus, i2c_sched_cb_t cb, void *arg)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t p = 0; p < I2C_PRIO_COUNT; p++) {
+        uint8_t prev = XFER_NONE;
+        for (uint8_t idx = bus->head[p]; idx != XFER_NONE; prev = idx, idx = bus->xfers[idx].next) {
+            i2c_xfer_t *x = &bus->xfers[idx];
+            if (x->cb != cb || x->arg != arg) continue;
+
+            if (idx == bus->active) {
+                // 这一段已经交给 HAL：截断，完成中断里按正常结束处理
+                x->len = (uint16_t)(x->done + bus->active_len);
+                __set_PRIMASK(primask);
+                return 1;
+            }
+
+            if (prev == XFER_NONE) {
+                bus->head[p] = x->next;
+            } else {
+                bus->xfers[prev].next = x->next;
+            }
+            if (bus->tail[p] == idx) {
+                bus->tail[p] = prev;
+            }
+            bus->free_mask |= (1u << idx);
+            __set_PRIMASK(primask);
+            return 0;
+        }
+    }
+    __set_PRIMASK(primask);
+    return 0;
+}
+
+static void sched_complete(I2C_HandleTypeDef *hi2c, int status)
+{
+    i2c_bus_t *bus = sched_find(hi2c);
+    if (!bus || bus->active == XFER_NONE) return;
+
+    uint8_t idx = bus->active;
+    uint8_t prio = bus->active_prio;
+    i2c_xfer_t *x = &bus->xfers[idx];
+
+    x->done += bus->active_len;
+    bus->active = XFER_NONE;
+
+    if (status != I2C_SCHED_OK || x->done >= x->len) {
+        sched_finish(bus, idx, prio, status);
+    }
+    // 没传完的分段事务留在队首，下面重新按优先级挑选
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8_t next = sched_claim_next(bus);
+    __set_PRIMASK(primask);
+
+    sched_start(bus, next);
+}
+
+void i2c_sched_cplt_handler(I2C_HandleTypeDef *hi2c)
+{
+    sched_complete(hi2c, I2C_SCHED_OK);
+}
+
+void i2c_sched_error_handler(I2C_HandleTypeDef *hi2c)
+{
+    sched_complete(hi2c, I2C_SCHED_ERROR);
+}
+
+uint8_t i2c_sched_idle(const i2c_bus_t *bus)
+{
+    if (bus->active != XFER_NONE) return 0;
+    for (uint8_t p = 0; p < I2C_PRIO_COUNT; p++) {
+        if (bus->head[p] != XFER_NONE) return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file i2c_sched.h
+ * @brief 共享 I2C 总线调度器：非阻塞提交、优先级队列、中断/DMA 完成回调串联事务
+ * @note  OLED 刷屏和传感器挂在同一条 I2C 上时，阻塞式 HAL_I2C_Mem_Write 会把总线占住几十毫秒，
+ *        IMU 的采样时刻跟着被推迟。调度器把每次访问变成队列里的一个事务：
+ *        - 三个优先级，各自先进先出；
+ *        - 事务在完成中断里一个接一个启动，CPU 不等待；
+ *        - 大块写 (OLED 显存) 按 chunk 切段，每段之间重新挑选最高优先级，
+ *          传感器读取最多只需等一个分段 (32 字节 @400kHz ≈ 0.8ms) 就能插进去。
+ */
+
+#ifndef __I2C_SCHED_H__
+#define __I2C_SCHED_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* ================= 用户配置区 ================= */
+
+/* 每条总线同时排队的事务上限 */
+#define I2C_SCHED_QUEUE         12
+
+/* 写入长度不超过此值时拷贝进事务 (调用者可以传栈上的命令字节) */
+#define I2C_SCHED_INLINE        4
+
+/* 长度达到此值才用 DMA，短传输用中断模式 (DMA 启动开销比几个字节的中断还大)；
+ * 没有给 I2C 配 DMA 时设为 0xFFFF */
+#define I2C_SCHED_DMA_MIN       8
+
+/* 同时管理的总线数 (完成回调按 hi2c 找到对应的调度器) */
+#define I2C_SCHED_MAX_BUSES     2
+
+/**
+ * @brief 优先级 (数值越小越优先)
+ */
+typedef enum {
+    I2C_PRIO_HIGH = 0,      // 有采样时刻要求的传感器
+    I2C_PRIO_NORMAL,        // 一般外设
+    I2C_PRIO_LOW,           // 显示等大块、可被打断的传输
+    I2C_PRIO_COUNT
+} i2c_prio_t;
+
+/* 事务结果 */
+#define I2C_SCHED_OK        0
+#define I2C_SCHED_PENDING   1
+#define I2C_SCHED_ERROR     (-1)
+#define I2C_SCHED_TIMEOUT   (-2)
+
+/**
+ * @brief 事务完成回调 (在 I2C 中断上下文中执行)
+ * @param status I2C_SCHED_OK / I2C_SCHED_ERROR
+ */
+typedef void (*i2c_sched_cb_t)(int status, void *arg);
+
+/**
+ * @brief 一个排队的事务 (内部使用)
+ */
+typedef struct {
+    uint8_t  next;          // 同优先级链表中的下一个 (0xFF 结束)
+    uint8_t  op;
+    uint16_t dev_addr;      // 已左移的 8 位地址
+    uint8_t  mem;           // 寄存器地址 / SSD1306 控制字节
+    uint16_t len;
+    uint16_t done;          // 已完成的字节数 (分段传输)
+    uint16_t chunk;         // 每段最大字节数，0 = 不分段
+    uint8_t  *data;
+    uint8_t  buf[I2C_SCHED_INLINE];
+    i2c_sched_cb_t cb;
+    void     *arg;
+} i2c_xfer_t;
+
+/**
+ * @brief 总线调度器 (每条 I2C 一个，静态分配)
+ */
+typedef struct {
+    I2C_HandleTypeDef *hi2c;
+    i2c_xfer_t xfers[I2C_SCHED_QUEUE];
+    uint32_t free_mask;                 // 空闲槽位
+    uint8_t  head[I2C_PRIO_COUNT];      // 各优先级队首
+    uint8_t  tail[I2C_PRIO_COUNT];
+    volatile uint8_t active;            // 正在传输的槽位 (0xFF = 总线空闲)
+    uint8_t  active_prio;
+    uint16_t active_len;                // 本段长度
+    uint32_t preemptions;               // 统计：分段之间被更高优先级插队的次数
+} i2c_bus_t;
+
+/**
+ * @brief 初始化并登记一条总线
+ * @note  在 MX_I2Cx_Init 之后调用
+ */
+void i2c_sched_init(i2c_bus_t *bus, I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief 提交写事务 (START + 地址 + data + STOP)
+ * @return 0 已排队，-1 队列已满
+ */
+int i2c_sched_write(i2c_bus_t *bus, i2c_prio_t prio, uint16_t dev_addr,
+                    const uint8_t *data, uint16_t len, i2c_sched_cb_t cb, void *arg);
+
+/**
+ * @brief 提交寄存器写事务 (地址 + mem + data)
+ * @param chunk 非 0 时每段最多 chunk 字节，每段都重发 mem；
+ *              只适用于分开写和连续写效果相同的设备 (如 SSD1306 的 0x40 数据流)
+ * @note  len > I2C_SCHED_INLINE 时只记录指针，完成回调之前 data 必须有效
+ */
+int i2c_sched_mem_write(i2c_bus_t *bus, i2c_prio_t prio, uint16_t dev_addr, uint8_t mem,
+                        const uint8_t *data, uint16_t len, uint16_t chunk,
+                        i2c_sched_cb_t cb, void *arg);
+
+/**
+ * @brief 提交寄存器读事务
+ */
+int i2c_sched_mem_read(i2c_bus_t *bus, i2c_prio_t prio, uint16_t dev_addr, uint8_t mem,
+                       uint8_t *data, uint16_t len, i2c_sched_cb_t cb, void *arg);
+
+/**
+ * @brief 同步等待辅助：把 i2c_sched_sync_cb 和 &status 作为回调提交，再调用 i2c_sched_sync_wait
+ * @code
+ *   volatile int st = I2C_SCHED_PENDING;
+ *   i2c_sched_mem_read(&bus, I2C_PRIO_HIGH, 0xD0, 0x3B, buf, 14, i2c_sched_sync_cb, (void *)&st);
+ *   if (i2c_sched_sync_wait(&st, 10) != I2C_SCHED_OK) { ... }
+ * @endcode
+ * @note  不能在比 I2C 中断优先级更高的上下文中等待
+ */
+void i2c_sched_sync_cb(int status, void *arg);
+int i2c_sched_sync_wait(volatile int *status, uint32_t timeout_ms);
+
+/**
+ * @brief 撤销一个还没结束的事务 (按提交时的 cb + arg 查找)
+ * @note  用于等待超时后收回调用者的缓冲区。排队中 (包括分段事务的两段之间) 的事务直接出队，
+ *        不再回调；正在线上的一段无法打断 (DMA 还在读写缓冲区)，只把事务截断到这一段为止，
+ *        这一段结束时照常回调，之后调度器不再引用缓冲区。
+ * @return 0 事务已不在队列中 (已撤销或早已结束)，1 有一段正在传输，需等它的回调
+ */
+int i2c_sched_cancel(i2c_bus_t *bus, i2c_sched_cb_t cb, void *arg);
+
+/**
+ * @brief 传输完成处理
+ * @note  在 HAL_I2C_MasterTxCpltCallback / HAL_I2C_MemTxCpltCallback / HAL_I2C_MemRxCpltCallback
+ *        中调用: i2c_sched_cplt_handler(hi2c);
+ */
+void i2c_sched_cplt_handler(I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief 传输错误处理
+ * @note  在 HAL_I2C_ErrorCallback 中调用，当前事务以 I2C_SCHED_ERROR 结束，继续下一个
+ */
+void i2c_sched_error_handler(I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief 总线是否空闲 (无进行中与排队的事务)
+ */
+uint8_t i2c_sched_idle(const i2c_bus_t *bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __I2C_SCHED_H__ */
@@ -0,0 +1,344 @@
+/**
+ * @file bus_timeline.c
+ * @brief 主机端工具：在模拟 I2C 总线上回放 OLED 刷屏 + IMU 采样，统计插队延迟并校验调度器
+ * @note  纯 C99，直接链接 MCU 端的 i2c_sched.c，HAL 换成 host/ 下的替身。用法:
+ *          gcc -O2 -Ihost -I.. -o bus_timeline bus_timeline.c ../i2c_sched.c
+ *          ./bus_timeline [帧数]
+ *        模拟总线一次只能有一段传输 (400kHz，含 ACK 每字节 22.5us)，传完在模拟时钟里调用完成中断。
+ *        OLED 按 OLED_WriteArea 的方式每页提交 光标命令 + 128 字节显存 (LOW，可分段)，IMU 每 4ms 读 14 字节 (HIGH)。
+ *        校验：
+ *        1. 不分段 / 32 / 16 字节分段下线上的显存数据拼回来与帧缓冲一致，IMU 数据正确，
+ *           HAL 从未在总线忙时被调用；分段越小 IMU 最长等待越短 (README 中的表格即由此生成)；
+ *        2. 启动失败和传输错误都以 I2C_SCHED_ERROR 结束事务，槽位全部归还；
+ *        3. i2c_sched_cancel：排队中的事务撤销后不回调、不上线；分段事务在两段之间撤销后不再继续；
+ *           正在线上的一段撤销后只传完这一段，照常回调，之后缓冲区不再被引用。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "i2c_sched.h"
+
+#define BYTE_US     22.5
+
+/* ================= 模拟总线 ================= */
+
+uint32_t host_primask;
+
+static I2C_HandleTypeDef hi2c;
+static i2c_bus_t bus;
+
+static double now_us;
+static int busy, stalled;       // stalled：完成中断迟迟不来 (总线被从机拉死)
+static double end_us;
+static int fail_next, overlap;
+
+enum { OP_WRITE = 0, OP_MEM_WRITE, OP_MEM_READ };
+
+typedef struct {
+    int op;
+    uint16_t addr;
+    uint8_t mem;
+    const uint8_t *data;
+    uint16_t len;
+    uint8_t first[4];   // 上线时的前几个字节 (data 之后可能被改写)
+} rec_t;
+
+#define MAX_RECS    100000
+static rec_t recs[MAX_RECS];
+static int n_recs;
+
+/* 每次读 HAL_GetTick 模拟时间前进 10us，同步等待才会超时；总线没被拉死时顺带派发完成中断 */
+static void sim_to(double t);
+
+uint32_t HAL_GetTick(void)
+{
+    sim_to(now_us + 10.0);
+    return (uint32_t)(now_us / 1000.0);
+}
+
+static HAL_StatusTypeDef sim_start(int op, uint16_t addr, uint8_t mem, uint8_t *data, uint16_t len, int overhead)
+{
+    if (busy) {
+        overlap++;
+        return HAL_BUSY;
+    }
+    if (fail_next) {
+        fail_next = 0;
+        return HAL_ERROR;
+    }
+    busy = 1;
+    end_us = now_us + (len + overhead) * BYTE_US;
+    if (n_recs < MAX_RECS) {
+        rec_t *r = &recs[n_recs++];
+        r->op = op;
+        r->addr = addr;
+        r->mem = mem;
+        r->data = data;
+        r->len = len;
+        memcpy(r->first, data, len < 4 ? len : 4);
+    }
+    if (op == OP_MEM_READ) {
+        for (uint16_t i = 0; i < len; i++) data[i] = (uint8_t)(mem + i);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *h, uint16_t a, uint8_t *p, uint16_t n)
+{
+    (void)h;
+    return sim_start(OP_WRITE, a, 0, p, n, 1);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *h, uint16_t a, uint8_t *p, uint16_t n)
+{
+    (void)h;
+    return sim_start(OP_WRITE, a, 0, p, n, 1);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *h, uint16_t a, uint16_t m, uint16_t s, uint8_t *p, uint16_t n)
+{
+    (void)h; (void)s;
+    return sim_start(OP_MEM_WRITE, a, (uint8_t)m, p, n, 2);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *h, uint16_t a, uint16_t m, uint16_t s, uint8_t *p, uint16_t n)
+{
+    (void)h; (void)s;
+    return sim_start(OP_MEM_WRITE, a, (uint8_t)m, p, n, 2);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *h, uint16_t a, uint16_t m, uint16_t s, uint8_t *p, uint16_t n)
+{
+    (void)h; (void)s;
+    return sim_start(OP_MEM_READ, a, (uint8_t)m, p, n, 4);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *h, uint16_t a, uint16_t m, uint16_t s, uint8_t *p, uint16_t n)
+{
+    (void)h; (void)s;
+    return sim_start(OP_MEM_READ, a, (uint8_t)m, p, n, 4);
+}
+
+/**
+ * @brief 推进到时刻 t，途中到期的传输依次完成
+ */
+static void sim_to(double t)
+{
+    while (busy && !stalled && end_us <= t) {
+        now_us = end_us;
+        busy = 0;
+        i2c_sched_cplt_handler(&hi2c);
+    }
+    if (t > now_us) now_us = t;
+}
+
+static void sim_reset(void)
+{
+    i2c_sched_init(&bus, &hi2c);
+    n_recs = 0;
+    now_us = 0;
+    busy = stalled = fail_next = 0;
+}
+
+static int all_free(void)
+{
+    return i2c_sched_idle(&bus) && bus.free_mask == ((1u << I2C_SCHED_QUEUE) - 1u);
+}
+
+/* ================= 时间线：OLED 刷屏 + IMU 采样 ================= */
+
+static uint8_t imu_buf[14];
+static int imu_done, imu_bad, pages_done;
+
+static void imu_cb(int status, void *arg)
+{
+    (void)arg;
+    if (status != I2C_SCHED_OK) imu_bad++;
+    for (int i = 0; i < 14; i++) {
+        if (imu_buf[i] != (uint8_t)(0x3B + i)) imu_bad++;
+    }
+    imu_done++;
+}
+
+static void page_cb(int status, void *arg)
+{
+    (void)arg;
+    if (status != I2C_SCHED_OK) imu_bad++;
+    pages_done++;
+}
+
+static double timeline(uint16_t chunk, int frames, int *bad)
+{
+    static uint8_t fb[8 * 128];
+    int pages_sent = 0, imu_pending = 0;
+    double next_imu = 0, imu_submit = 0, imu_worst = 0;
+
+    sim_reset();
+    imu_done = imu_bad = pages_done = 0;
+    for (int i = 0; i < (int)sizeof(fb); i++) fb[i] = (uint8_t)rand();
+
+    while (pages_done < frames * 8) {
+        // 与 OLED_WriteArea 相同：光标命令 + 整页数据，上一页传完才提交下一页
+        if (pages_sent == pages_done && pages_sent < frames * 8) {
+            int p = pages_sent % 8;
+            uint8_t cmds[4] = { 0x00, (uint8_t)(0xB0 | p), 0x00, 0x10 };
+            if (i2c_sched_write(&bus, I2C_PRIO_LOW, 0x78, cmds, 4, NULL, NULL) != 0 ||
+                i2c_sched_mem_write(&bus, I2C_PRIO_LOW, 0x78, 0x40, fb + p * 128, 128, chunk, page_cb, NULL) != 0) {
+                (*bad)++;
+                break;
+            }
+            pages_sent++;
+        }
+        if (now_us >= next_imu) {
+            if (imu_pending) (*bad)++;      // 上一次读取 4ms 都没完成
+            imu_submit = now_us;
+            imu_pending = 1;
+            if (i2c_sched_mem_read(&bus, I2C_PRIO_HIGH, 0xD0, 0x3B, imu_buf, 14, imu_cb, NULL) != 0) (*bad)++;
+            next_imu += 4000.0;
+        }
+
+        int before = imu_done;
+        sim_to(now_us + 1.0);
+        if (imu_done != before) {
+            double wait = now_us - imu_submit - (14 + 4) * BYTE_US;
+            if (wait > imu_worst) imu_worst = wait;
+            imu_pending = 0;
+        }
+    }
+
+    sim_to(now_us + 10000.0);           // 收尾：最后一次 IMU 读取
+
+    // 线上的显存数据按页拼回来
+    int page = -1, pos = 0, wrong = 0;
+    for (int i = 0; i < n_recs; i++) {
+        const rec_t *r = &recs[i];
+        if (r->op == OP_WRITE) {
+            page = r->first[1] & 7;
+            pos = 0;
+        } else if (r->op == OP_MEM_WRITE) {
+            if (page < 0 || pos + r->len > 128 || memcmp(r->data, fb + page * 128 + pos, r->len) != 0) wrong++;
+            if (chunk && r->len > chunk) wrong++;
+            pos += r->len;
+        }
+    }
+
+    int ok = !wrong && !imu_bad && !overlap && all_free();
+    if (!ok) (*bad)++;
+    printf("chunk %3u: %5d transfers, %4d IMU reads, worst IMU wait %5.0f us, %4u preemptions  %s\n",
+           (unsigned)chunk, n_recs, imu_done, imu_worst, (unsigned)bus.preemptions, ok ? "ok" : "FAIL");
+    return imu_worst;
+}
+
+/* ================= 错误与撤销 ================= */
+
+static int n_cb;
+static void count_cb(int status, void *arg)
+{
+    (void)status;
+    (void)arg;
+    n_cb++;
+}
+
+static int test_errors(void)
+{
+    uint8_t d[20] = {0};
+    volatile int st = I2C_SCHED_PENDING;
+    int ok1, ok2;
+
+    sim_reset();
+    fail_next = 1;
+    i2c_sched_mem_write(&bus, I2C_PRIO_LOW, 0x78, 0x40, d, 20, 0, i2c_sched_sync_cb, (void *)&st);
+    ok1 = st == I2C_SCHED_ERROR && all_free();
+
+    st = I2C_SCHED_PENDING;
+    i2c_sched_mem_write(&bus, I2C_PRIO_LOW, 0x78, 0x40, d, 20, 8, i2c_sched_sync_cb, (void *)&st);
+    now_us = end_us;
+    busy = 0;
+    i2c_sched_error_handler(&hi2c);     // 第一段出错，后面两段不再发
+    ok2 = st == I2C_SCHED_ERROR && all_free() && n_recs == 1;
+
+    printf("%-34s %s\n", "start failure -> ERROR", ok1 ? "ok" : "FAIL");
+    printf("%-34s %s\n", "error mid-chunk -> ERROR", ok2 ? "ok" : "FAIL");
+    return !(ok1 && ok2);
+}
+
+static int test_cancel(void)
+{
+    uint8_t blocker[20] = {0};
+    uint8_t data[40];
+    volatile int st;
+    int bad = 0, ok;
+
+    /* 1. 排在一个卡死的传输后面：等待超时、撤销，缓冲区立即可以改写 */
+    sim_reset();
+    memset(data, 0xA5, sizeof(data));
+    i2c_sched_mem_write(&bus, I2C_PRIO_HIGH, 0xD0, 0x10, blocker, 20, 0, NULL, NULL);
+    stalled = 1;
+    st = I2C_SCHED_PENDING;
+    i2c_sched_mem_write(&bus, I2C_PRIO_LOW, 0x78, 0x40, data, 40, 8, i2c_sched_sync_cb, (void *)&st);
+    int wait = i2c_sched_sync_wait(&st, 5);
+    int rc = i2c_sched_cancel(&bus, i2c_sched_sync_cb, (void *)&st);
+    memset(data, 0xEE, sizeof(data));
+    stalled = 0;
+    sim_to(now_us + 10000.0);
+    ok = wait == I2C_SCHED_TIMEOUT && rc == 0 && st == I2C_SCHED_PENDING && n_recs == 1 && all_free();
+    printf("%-34s %s (%d transfers on the wire)\n", "cancel queued", ok ? "ok" : "FAIL", n_recs);
+    bad |= !ok;
+
+    /* 2. 分段事务在两段之间被 HIGH 插队，此时撤销：已发的一段之后不再继续 */
+    sim_reset();
+    n_cb = 0;
+    i2c_sched_mem_write(&bus, I2C_PRIO_LOW, 0x78, 0x40, data, 40, 8, count_cb, NULL);
+    i2c_sched_mem_read(&bus, I2C_PRIO_HIGH, 0xD0, 0x3B, imu_buf, 14, NULL, NULL);
+    sim_to(end_us);                     // 第一段结束，IMU 读取开始
+    rc = i2c_sched_cancel(&bus, count_cb, NULL);
+    sim_to(now_us + 10000.0);
+    ok = rc == 0 && n_cb == 0 && n_recs == 2 && recs[0].len == 8 && recs[1].op == OP_MEM_READ && all_free();
+    printf("%-34s %s (%d transfers on the wire)\n", "cancel between chunks", ok ? "ok" : "FAIL", n_recs);
+    bad |= !ok;
+
+    /* 3. 正在线上的一段：截断到这一段，照常回调，之后不再引用缓冲区 */
+    sim_reset();
+    memset(data, 0x5A, sizeof(data));
+    stalled = 1;
+    st = I2C_SCHED_PENDING;
+    i2c_sched_mem_write(&bus, I2C_PRIO_LOW, 0x78, 0x40, data, 40, 8, i2c_sched_sync_cb, (void *)&st);
+    wait = i2c_sched_sync_wait(&st, 5);
+    rc = i2c_sched_cancel(&bus, i2c_sched_sync_cb, (void *)&st);
+    stalled = 0;
+    while (st == I2C_SCHED_PENDING) sim_to(now_us + 1.0);   // 与 OLED_WriteData 一样等这一段结束
+    int refs = n_recs;
+    memset(data, 0xEE, sizeof(data));
+    sim_to(now_us + 10000.0);
+    ok = wait == I2C_SCHED_TIMEOUT && rc == 1 && st == I2C_SCHED_OK && refs == 1 && n_recs == 1 && all_free();
+    printf("%-34s %s (%d transfers on the wire)\n", "cancel in flight", ok ? "ok" : "FAIL", n_recs);
+    bad |= !ok;
+
+    /* 4. 早已结束的事务：撤销是空操作 */
+    rc = i2c_sched_cancel(&bus, i2c_sched_sync_cb, (void *)&st);
+    ok = rc == 0 && all_free();
+    printf("%-34s %s\n", "cancel after completion", ok ? "ok" : "FAIL");
+    bad |= !ok;
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 20;
+    int bad = 0;
+
+    srand(1);
+    printf("OLED %d frames + IMU every 4 ms, 400 kHz (%.1f us/byte)\n", frames, BYTE_US);
+    double w0 = timeline(0, frames, &bad);
+    double w32 = timeline(32, frames, &bad);
+    double w16 = timeline(16, frames, &bad);
+    if (!(w16 < w32 && w32 < w0)) {
+        printf("smaller chunks should shorten the IMU wait: FAIL\n");
+        bad++;
+    }
+
+    bad += test_errors();
+    bad += test_cancel();
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file main.h
+ * @brief 主机端替身：只提供 i2c_sched.c 用到的 HAL 与 CMSIS 接口
+ * @note  I2C 的启动函数由测试程序实现 (模拟总线记录每一段传输并按字节数推进时间)，
+ *        完成中断由测试程序在模拟时钟里同步调用 i2c_sched_cplt_handler / i2c_sched_error_handler。
+ */
+
+#ifndef __HOST_MAIN_H__
+#define __HOST_MAIN_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+/* ================= 内核 ================= */
+
+extern uint32_t host_primask;
+
+static inline uint32_t __get_PRIMASK(void) { return host_primask; }
+static inline void __set_PRIMASK(uint32_t v) { host_primask = v; }
+static inline void __disable_irq(void) { host_primask = 1; }
+static inline void __enable_irq(void) { host_primask = 0; }
+
+uint32_t HAL_GetTick(void);
+
+/* ================= I2C ================= */
+
+typedef struct {
+    void *Instance;
+} I2C_HandleTypeDef;
+
+#define I2C_MEMADD_SIZE_8BIT    1u
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t mem, uint16_t mem_size,
+                                       uint8_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t mem, uint16_t mem_size,
+                                        uint8_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t mem, uint16_t mem_size,
+                                      uint8_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t mem, uint16_t mem_size,
+                                       uint8_t *data, uint16_t len);
+
+#endif /* __HOST_MAIN_H__ */